@@ -27,10 +27,12 @@
 
 #include "asio/io_service.hpp"
 #include "asio/post.hpp"
+#include "boost/asio/steady_timer.hpp"
 #include "boost/filesystem/path.hpp"
 #include "boost/optional/optional.hpp"
 
 #include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/node_id.h"
 #include "maidsafe/common/rsa.h"
@@ -39,8 +41,11 @@
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/routing/bootstrap_handler.h"
+#include "maidsafe/routing/client_connection_pool.h"
+#include "maidsafe/routing/message_header.h"
 #include "maidsafe/routing/peer_node.h"
 #include "maidsafe/routing/sentinel.h"
+#include "maidsafe/routing/timing_wheel.h"
 #include "maidsafe/routing/types.h"
 #include "maidsafe/routing/messages/messages_fwd.h"
 #include "maidsafe/routing/messages/get_data.h"
@@ -61,7 +66,9 @@ class Client : public std::enable_shared_from_this<Client> {
   Client& operator=(Client&&) = delete;
   ~Client();
 
-  // normal bootstrap mechanism
+  // normal bootstrap mechanism.  Not implemented yet: nodes only accept connections from peers
+  // presenting a PublicPmid, so this completes at once with asio::error::operation_not_supported
+  // and the client has no connections to send requests on.
   template <typename CompletionToken>
   BootstrapReturn<CompletionToken> Bootstrap(CompletionToken&& token);
   // used where we wish to pass a specific node to bootstrap from
@@ -83,16 +90,31 @@ class Client : public std::enable_shared_from_this<Client> {
   Address OurId() const { return our_id_; }
 
  private:
+  // Adds a connection to a member of our close group, the first being our bootstrap node.
+  // Returns false if we already have as many connections as we keep.  Nothing calls this until
+  // Bootstrap and the ConnectResponse handler can connect to nodes.
+  bool AddConnection(PeerNode peer);
+  void StartReceiving(std::shared_ptr<PeerNode> peer);
   void MessageReceived(const Address& peer_id, SerialisedMessage message);
   void ConnectionLost(const Address& peer_id);
 
   SourceAddress OurSourceAddress() const;
+  // Our source address for a message relayed to the network by |relay|.
+  SourceAddress OurSourceAddress(const Address& relay) const;
 
   void OnCloseGroupChanged(CloseGroupDifference close_group_difference);
-  void HandleMessage(ConnectResponse&& connect_response);
-  void HandleMessage(GetDataResponse&& get_data_response);
-  void HandleMessage(routing::Post&& post);
-  void HandleMessage(PostResponse&& post_response);
+
+  friend class MessageDispatcher<Client>;
+  void HandleMessage(ConnectResponse&& connect_response, MessageHeader&& header);
+  void HandleMessage(GetDataResponse&& get_data_response, MessageHeader&& header);
+  void HandleMessage(PutDataResponse&& put_data_response, MessageHeader&& header);
+  void HandleMessage(routing::Post&& post, MessageHeader&& header);
+  void HandleMessage(PostResponse&& post_response, MessageHeader&& header);
+  // Any other message type isn't meant for a client and is dropped.
+  template <typename Message>
+  void HandleMessage(Message&& /*message*/, MessageHeader&& /*header*/) {
+    LOG(kWarning) << "Received message of unexpected type.";
+  }
 
   BoostAsioService crux_asio_service_;
   asio::io_service& io_service_;
@@ -101,20 +123,24 @@ class Client : public std::enable_shared_from_this<Client> {
   std::atomic<MessageId> message_id_;
   boost::optional<Address> bootstrap_node_;
   BootstrapHandler bootstrap_handler_;
-  std::vector<PeerNode> connected_peers_;
+  // Times out requests outstanding on |connections_|.  Driven on the crux thread.
+  TimingWheel expiry_wheel_;
+  // Our Get, Put and Post requests are multiplexed over these, matched to their responses by
+  // message id.  Empty until bootstrapping is implemented, so for now every request fails with
+  // network_unreachable.
+  ClientConnectionPool connections_;
   LruCache<std::pair<Address, MessageId>, void> filter_;
   Sentinel sentinel_;
+  TimingWheelDriver<boost::asio::steady_timer> expiry_driver_;
 };
 
 template <typename CompletionToken>
 BootstrapReturn<CompletionToken> Client::Bootstrap(CompletionToken&& token) {
   BootstrapHandlerHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  auto this_ptr(shared_from_this());
-  asio::post(io_service_, [=] {
-    // TODO(PeterJ)
-    //    rudp_.Bootstrap(bootstrap_handler_.ReadBootstrapContacts(), this_ptr, our_id_, our_keys_,
-    //                    handler);
+  asio::post(io_service_, [=]() mutable {
+    // TODO(PeterJ): connect to bootstrap_handler_.ReadBootstrapContacts(), AddConnection each
+    handler(asio::error::operation_not_supported, Contact());
   });
   return result.get();
 }
@@ -124,11 +150,9 @@ BootstrapReturn<CompletionToken> Client::Bootstrap(Endpoint /*local_endpoint*/,
                                                    CompletionToken&& token) {
   BootstrapHandlerHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  auto this_ptr(shared_from_this());
-  asio::post(io_service_, [=] {
-    // TODO(PeterJ)
-    //    rudp_.Bootstrap(bootstrap_handler_.ReadBootstrapContacts(), this_ptr, our_id_, our_keys_,
-    //                    handler, local_endpoint);
+  asio::post(io_service_, [=]() mutable {
+    // TODO(PeterJ): connect to |endpoint| and AddConnection it
+    handler(asio::error::operation_not_supported, Contact());
   });
   return result.get();
 }
@@ -139,44 +163,72 @@ GetReturn<CompletionToken> Client::Get(Name name, CompletionToken&& token) {
   asio::async_result<decltype(handler)> result(handler);
   auto this_ptr(shared_from_this());
   asio::post(io_service_, [=] {
-    MessageHeader our_header(std::make_pair(Destination(name.value), boost::none),
-                             OurSourceAddress(), ++message_id_, Authority::client);
-    GetData request(Name::data_type::Tag::kValue, name.value, OurSourceAddress());
-    auto message(Serialise(our_header, MessageToTag<GetData>::value(), request));
-//    auto targets(connection_manager_.GetTarget(name.value));
-//    for (const auto& target : targets)
-//      connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
+    const MessageId message_id(++this_ptr->message_id_);
+    // Rebuilt if the request has to be sent again via another of our connections.
+    this_ptr->connections_.Send(message_id, [=](const Address& relay) {
+      MessageHeader our_header(std::make_pair(Destination(name.value), boost::none),
+                               this_ptr->OurSourceAddress(relay), message_id, Authority::client);
+      GetData request(Name::data_type::Tag::kValue, name.value, this_ptr->OurSourceAddress(relay));
+      return std::make_shared<const SerialisedMessage>(
+          Serialise(our_header, MessageToTag<GetData>::value, request));
+    }, [handler](asio::error_code error, SerialisedMessage data) mutable {
+      handler(error, std::move(data));
+    });
   });
   return result.get();
 }
 
 template <typename CompletionToken, typename Name>
-PutReturn<CompletionToken> Client::Put(Name /*name*/, SerialisedMessage /*message*/,
+PutReturn<CompletionToken> Client::Put(Name name, SerialisedMessage message,
                                        CompletionToken&& token) {
   PutHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
   auto this_ptr(shared_from_this());
-  //  io_service_.post([=] { this_ptr->DoPut(name, message, handler); });
+  auto shared_message(std::make_shared<const SerialisedMessage>(std::move(message)));
+  asio::post(io_service_, [=] {
+    const MessageId message_id(++this_ptr->message_id_);
+    this_ptr->connections_.Send(message_id, [=](const Address& relay) {
+      MessageHeader our_header(std::make_pair(Destination(name.value), boost::none),
+                               this_ptr->OurSourceAddress(relay), message_id, Authority::client);
+      PutData request(Name::data_type::Tag::kValue, *shared_message);
+      return std::make_shared<const SerialisedMessage>(
+          Serialise(our_header, MessageToTag<PutData>::value, request));
+    }, [handler](asio::error_code error, SerialisedMessage) mutable { handler(error); });
+  });
   return result.get();
 }
 
 template <typename CompletionToken, typename Name>
-PostReturn<CompletionToken> Client::Post(Name /*name*/, SerialisedMessage /*message*/,
+PostReturn<CompletionToken> Client::Post(Name name, SerialisedMessage message,
                                          CompletionToken&& token) {
   PostHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
   auto this_ptr(shared_from_this());
-  //  io_service_.post([=] { this_ptr->DoPost(name, message, handler); });
+  auto shared_message(std::make_shared<const SerialisedMessage>(std::move(message)));
+  asio::post(io_service_, [=] {
+    const MessageId message_id(++this_ptr->message_id_);
+    this_ptr->connections_.Send(message_id, [=](const Address& relay) {
+      MessageHeader our_header(std::make_pair(Destination(name.value), boost::none),
+                               this_ptr->OurSourceAddress(relay), message_id, Authority::client);
+      routing::Post request(Name::data_type::Tag::kValue, Identity(name.value.string()),
+                            *shared_message);
+      return std::make_shared<const SerialisedMessage>(
+          Serialise(our_header, MessageToTag<routing::Post>::value, request));
+    }, [handler](asio::error_code error, SerialisedMessage) mutable { handler(error); });
+  });
   return result.get();
 }
 
+// There's no request/response message in the protocol yet, so this completes at once with
+// asio::error::operation_not_supported.
 template <typename CompletionToken, typename Name>
 RequestReturn<CompletionToken> Client::Request(Name /*name*/, SerialisedMessage /*message*/,
                                                CompletionToken&& token) {
   RequestHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  auto this_ptr(shared_from_this());
-  //  io_service_.post([=] { this_ptr->DoRequest(name, message, handler); });
+  asio::post(io_service_, [=]() mutable {
+    handler(asio::error::operation_not_supported, SerialisedMessage());
+  });
   return result.get();
 }
 
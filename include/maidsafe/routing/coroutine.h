@@ -0,0 +1,166 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_COROUTINE_H_
+#define MAIDSAFE_ROUTING_COROUTINE_H_
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "asio/coroutine.hpp"
+#include "asio/error_code.hpp"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Stackless coroutines (see asio/coroutine.hpp) over routing operations.  Every operation taking a
+// CompletionToken accepts the tokens returned by Await, which store the operation's results and
+// resume the coroutine once all the operations awaited by its latest yield have completed, so
+// several may be in flight at once:
+//
+//   #include "asio/yield.hpp"
+//
+//   struct Replicate {
+//     template <typename Coroutine>
+//     void operator()(Coroutine& coroutine) {
+//       reenter(coroutine) {
+//         yield node->Get<ImmutableData>(name, coroutine.Await(get_error, data));
+//         if (get_error)
+//           yield break;
+//         yield {
+//           node->Put(first, ImmutableData(data), coroutine.Await(put_errors[0]));
+//           node->Put(second, ImmutableData(data), coroutine.Await(put_errors[1]));
+//         }
+//       }
+//     }
+//
+//     RoutingNode<Vault>* node;
+//     Identity name;
+//     Address first, second;
+//     asio::error_code get_error, put_errors[2];
+//     SerialisedMessage data;
+//   };
+//
+//   SpawnCoroutine(Replicate{...});
+//
+// The body's members carry its state across yields.  The body and the coroutine's position are
+// held in one allocation for the coroutine's lifetime, and a token is only a reference to that
+// and to its result slots, so no callback is allocated per awaited operation.  The body is resumed
+// on whichever thread completes its last awaited operation, but is never run concurrently with
+// itself.
+template <typename Body>
+class Coroutine : public asio::coroutine, public std::enable_shared_from_this<Coroutine<Body>> {
+ public:
+  // Token for an operation completing with void(asio::error_code).
+  class Resume {
+   public:
+    Resume(std::shared_ptr<Coroutine> coroutine, asio::error_code& error)
+        : coroutine_(std::move(coroutine)), error_(&error) {}
+
+    void operator()(asio::error_code error) {
+      *error_ = error;
+      coroutine_->Completed();
+    }
+
+   private:
+    std::shared_ptr<Coroutine> coroutine_;
+    asio::error_code* error_;
+  };
+
+  // Token for an operation completing with void(asio::error_code, Value).
+  template <typename Value>
+  class ResumeWith {
+   public:
+    ResumeWith(std::shared_ptr<Coroutine> coroutine, asio::error_code& error, Value& value)
+        : coroutine_(std::move(coroutine)), error_(&error), value_(&value) {}
+
+    void operator()(asio::error_code error, Value value) {
+      *error_ = error;
+      *value_ = std::move(value);
+      coroutine_->Completed();
+    }
+
+   private:
+    std::shared_ptr<Coroutine> coroutine_;
+    asio::error_code* error_;
+    Value* value_;
+  };
+
+  Coroutine(const Coroutine&) = delete;
+  Coroutine(Coroutine&&) = delete;
+  ~Coroutine() = default;
+  Coroutine& operator=(const Coroutine&) = delete;
+  Coroutine& operator=(Coroutine&&) = delete;
+
+  // The slots must stay valid until the operation completes, so are usually members of the body.
+  Resume Await(asio::error_code& error) {
+    ++outstanding_;
+    return Resume(this->shared_from_this(), error);
+  }
+
+  template <typename Value>
+  ResumeWith<Value> Await(asio::error_code& error, Value& value) {
+    ++outstanding_;
+    return ResumeWith<Value>(this->shared_from_this(), error, value);
+  }
+
+  // Only safe to use while the coroutine isn't running, e.g. once is_complete().
+  Body& body() { return body_; }
+
+ private:
+  template <typename Spawned>
+  friend std::shared_ptr<Coroutine<Spawned>> SpawnCoroutine(Spawned body);
+
+  explicit Coroutine(Body body) : body_(std::move(body)), outstanding_(0) {}
+
+  void Run() {
+    // |outstanding_| holds an extra count while the body runs, so operations completing before it
+    // yields don't resume it from within itself.  A yield which awaited nothing, or only
+    // operations which have already completed, continues straight away.
+    do {
+      if (is_complete())
+        return;
+      outstanding_ = 1;
+      body_(*this);
+    } while (--outstanding_ == 0);
+  }
+
+  void Completed() {
+    if (--outstanding_ == 0)
+      Run();
+  }
+
+  Body body_;
+  std::atomic<size_t> outstanding_;
+};
+
+// Runs |body| on the calling thread until its first yield.
+template <typename Body>
+std::shared_ptr<Coroutine<Body>> SpawnCoroutine(Body body) {
+  std::shared_ptr<Coroutine<Body>> coroutine(new Coroutine<Body>(std::move(body)));
+  coroutine->Run();
+  return coroutine;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_COROUTINE_H_
@@ -20,33 +20,51 @@
 #define MAIDSAFE_ROUTING_ROUTING_NODE_H_
 
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "asio/io_service.hpp"
 #include "asio/post.hpp"
 #include "asio/use_future.hpp"
 #include "asio/ip/udp.hpp"
+#include "boost/asio/steady_timer.hpp"
+#include "boost/exception/diagnostic_information.hpp"
 #include "boost/filesystem/path.hpp"
 #include "boost/expected/expected.hpp"
 
 #include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/common/utils.h"
-#include "maidsafe/common/containers/lru_cache.h"
 #include "maidsafe/crux/socket.hpp"
 #include "maidsafe/passport/types.h"
 
+#include "maidsafe/routing/admission_control.h"
+#include "maidsafe/routing/batch.h"
 #include "maidsafe/routing/bootstrap_handler.h"
 #include "maidsafe/routing/connection_manager.h"
+#include "maidsafe/routing/message_dispatch.h"
 #include "maidsafe/routing/message_header.h"
 #include "maidsafe/routing/messages/messages.h"
 #include "maidsafe/routing/endpoint_pair.h"
+#include "maidsafe/routing/expiring_cache.h"
+#include "maidsafe/routing/hedged_request.h"
+#include "maidsafe/routing/inbound_scheduler.h"
+#include "maidsafe/routing/latency_tracker.h"
+#include "maidsafe/routing/outbound_message.h"
+#include "maidsafe/routing/peer_node.h"
+#include "maidsafe/routing/reassembly_buffer.h"
+#include "maidsafe/routing/response_table.h"
 #include "maidsafe/routing/sentinel.h"
+#include "maidsafe/routing/signed_response_cache.h"
+#include "maidsafe/routing/swarm_fanout.h"
+#include "maidsafe/routing/timing_wheel.h"
 #include "maidsafe/routing/types.h"
+#include "maidsafe/routing/windowed_stream.h"
 
 namespace maidsafe {
 
@@ -65,6 +83,8 @@ class RoutingNode {
   RoutingNode& operator=(RoutingNode&&) = delete;
   ~RoutingNode();
 
+  // Each operation takes a CompletionToken: a callback, asio::use_future or a coroutine's Await
+  // token (see coroutine.h).
   // // will return with the data
   template <typename T, typename CompletionToken>
   GetReturn<CompletionToken> Get(Identity name, CompletionToken token);
@@ -74,6 +94,36 @@ class RoutingNode {
   // will return with allowed or not (error_code only)
   template <typename FunctorType, typename CompletionToken>
   PostReturn<CompletionToken> Post(Address to, FunctorType functor, CompletionToken token);
+  // Store or retrieve many chunks at once.  Entries are batched per next hop (and split again
+  // wherever a batch reaches an entry's destination close group), so the header and per-datagram
+  // costs are paid per batch rather than per chunk.  The handler is given one result per entry.
+  template <typename CompletionToken>
+  BatchReturn<CompletionToken> PutBatch(std::vector<PutDataBatch::Entry> entries,
+                                        CompletionToken token);
+  template <typename CompletionToken>
+  BatchReturn<CompletionToken> GetBatch(std::vector<GetDataBatch::Entry> entries,
+                                        CompletionToken token);
+  // Store or retrieve a payload too large for a single message (see PeerNode::MaxMessageSize).
+  // It is split into fragments, sent with up to |window| (at least one) awaiting a response at
+  // once, and reassembled by the destination group, or for a Get by us.
+  template <typename CompletionToken>
+  PutReturn<CompletionToken> PutStream(Address to, DataTagValue tag, Identity name,
+                                       SerialisedData data, CompletionToken token,
+                                       uint32_t window = WindowedStream::kDefaultWindow);
+  template <typename CompletionToken>
+  GetReturn<CompletionToken> GetStream(DataTagValue tag, Identity name, CompletionToken token,
+                                       uint32_t window = WindowedStream::kDefaultWindow);
+  // Rather than sending each Get to every target at once, sends it to the best target and only
+  // to the next best ones if no response arrives within a percentile of recent Get latencies.
+  // Call before the first Get.
+  void EnableHedgedGet(HedgeOptions options) { hedge_options_ = options; }
+  // Counts of received messages admitted and shed, by priority.
+  AdmissionCounters AdmissionStatistics() const { return admission_.Counters(); }
+  // Rather than swarming every message on to all targets, forwards to as few as the duplicates
+  // arriving for each destination range show are needed (see SwarmFanout).  Call before starting.
+  void EnableAdaptiveSwarm(SwarmOptions options) {
+    swarm_fanout_.reset(new SwarmFanout(OurId(), std::move(options)));
+  }
 
   void AddBootstrapContact(crux::endpoint /*endpoint*/) {
     // bootstrap_handler_.AddBootstrapContact(endpoint);
@@ -92,10 +142,30 @@ class RoutingNode {
     crux_asio_service_.service().post([=]() { connection_manager_.Shutdown(); });
   }
 
+  // For a restart without losing data: stops taking on connections, new requests (which complete
+  // with asio::error::shut_down) and received messages other than responses to us, then waits up
+  // to |timeout| for sends already started to complete before closing every connection.  Any of
+  // our requests still outstanding then complete with asio::error::shut_down.  |handler| is
+  // called with the number of sends which hadn't completed by the deadline.
+  void Drain(std::chrono::steady_clock::duration timeout, std::function<void(size_t)> handler) {
+    draining_ = true;
+    responses_.StopAccepting(asio::error::shut_down);
+    crux_asio_service_.service().post([=]() {
+      connection_manager_.Drain(timeout, [=](size_t unsent) {
+        inbound_.Stop();
+        responses_.CancelAll(asio::error::shut_down);
+        if (handler)
+          handler(unsent);
+      });
+    });
+  }
+
  private:
+  friend class MessageDispatcher<RoutingNode>;
+
   void HandleMessage(Connect connect, MessageHeader original_header);
   // like connect but add targets endpoint
-  void HandleMessage(ConnectResponse connect_response);
+  void HandleMessage(ConnectResponse connect_response, MessageHeader original_header);
   // sent by routing nodes to a network Address
   void HandleMessage(FindGroup find_group, MessageHeader original_header);
   // each member of the group close to network Address fills in their node_info and replies
@@ -103,9 +173,14 @@ class RoutingNode {
   // may be directly sent to a network Address
   void HandleMessage(GetData get_data, MessageHeader original_header);
   // Each node wiht the data sends it back to the originator
-  void HandleMessage(GetDataResponse get_data_response) {
-    static_cast<Child*>(this)->HandleGetDataResponse(get_data_response);
-  }
+  void HandleMessage(GetDataResponse get_data_response, MessageHeader original_header);
+  // sent by the sentinel to the group close to a node to retrieve that node's key
+  void HandleMessage(GetKey get_key, MessageHeader original_header);
+  void HandleMessage(GetKeyResponse get_key_response, MessageHeader original_header);
+  // sent by the sentinel to a group to retrieve all the group members' keys
+  void HandleMessage(GetGroupKey get_group_key, MessageHeader original_header);
+  void HandleMessage(GetGroupKeyResponse get_group_key_response, MessageHeader original_header);
+  void HandleMessage(PutKey put_key, MessageHeader original_header);
   // sent by a client to store data, client does information dispersal and sends a part to each of
   // its close group
   void HandleMessage(PutData put_data, MessageHeader original_header);
@@ -113,11 +188,46 @@ class RoutingNode {
   // each member of a group needs to send this to the network address (recieveing needs a Quorum)
   // filling in public key again.
   // each member of a group needs to send this to the network Address (recieveing needs a Quorum)
-  // filling in public key again.
+  // filling in public key again.  The Child's HandlePost decides whether it's allowed, and the
+  // requester is answered with a PostResponse either way.
   void HandleMessage(routing::Post post, MessageHeader original_header);
+  void HandleMessage(PostResponse post_response, MessageHeader original_header);
+  // Batches are sent hop by hop; each node handles the entries it is in the destination close
+  // group for and sends the rest on, then replies with the results for all of them.
+  void HandleMessage(PutDataBatch put_data_batch, MessageHeader original_header);
+  void HandleMessage(PutDataBatchResponse put_data_batch_response, MessageHeader original_header);
+  void HandleMessage(GetDataBatch get_data_batch, MessageHeader original_header);
+  void HandleMessage(GetDataBatchResponse get_data_batch_response, MessageHeader original_header);
+  // A fragment of a streamed Put is acknowledged once it is reassembled, the whole payload then
+  // being handled as a PutData.
+  void HandleMessage(PutDataFragment put_data_fragment, MessageHeader original_header);
+  void HandleMessage(GetDataFragment get_data_fragment, MessageHeader original_header);
+  void HandleMessage(GetDataFragmentResponse get_data_fragment_response,
+                     MessageHeader original_header);
+  // A message admitted by Enqueue, with its header parsed and |body| left at the message body.
+  struct ReceivedMessage {
+    ReceivedMessage(NodeId peer_id_in, SerialisedMessage serialised_in)
+        : peer_id(std::move(peer_id_in)),
+          serialised(std::move(serialised_in)),
+          body(serialised),
+          header(),
+          tag() {}
+    NodeId peer_id;
+    SerialisedMessage serialised;
+    InputVectorStream body;
+    MessageHeader header;
+    MessageTypeTag tag;
+  };
+
   bool TryCache(MessageTypeTag tag, MessageHeader header, Address name);
   Authority OurAuthority(const Address& element, const MessageHeader& header) const;
-  virtual void MessageReceived(NodeId peer_id, SerialisedMessage serialised_message);
+  // Admits and queues a message just received from |peer_id|.
+  void Enqueue(NodeId peer_id, const SerialisedMessage& serialised_message);
+  virtual void MessageReceived(ReceivedMessage& message);
+  // Hands a signed message to the sentinel and dispatches it on the crux thread once its
+  // signatures (a quorum of them, if it's from a group) have been checked.
+  void CheckSignatures(MessageHeader header, MessageTypeTag tag,
+                       const SerialisedMessage& serialised_message);
   // virtual void ConnectionLost(NodeId peer) override final;
   void OnCloseGroupChanged(CloseGroupDifference close_group_difference);
   SourceAddress OurSourceAddress() const;
@@ -134,45 +244,139 @@ class RoutingNode {
   // this innocuous looking call will bootstrap the node and also be used if we spot close group
   // nodes appering or vanishing so its pretty important.
   void ConnectToCloseGroup();
+  // Asks the group close to |target| for the key(s) the sentinel is missing.
+  template <typename Message>
+  void SendKeyRequest(const Address& target, const Message& message);
+  // Sends a Get/Put/Post to |destination|, with |handler| completed by the response.
+  void SendRequest(const OutboundMessage& message, const Address& destination,
+                   MessageId message_id, ResponseTable::Handler handler);
+  // As SendRequest, but sends to one target at a time as described in HedgedRequest.
+  void SendHedgedRequest(const OutboundMessage& message, const Address& destination,
+                         MessageId message_id, ResponseTable::Handler handler);
+  // Handles or sends on each entry of a batch for |requester|, calling |done| with all the
+  // entries' results.
+  template <typename Batch, typename Response>
+  void SendBatch(std::vector<typename Batch::Entry> entries, const MessageHeader& requester,
+                 BatchCollector::Done done);
+  PutDataBatch MakeBatch(std::vector<PutDataBatch::Entry> entries, const MessageHeader& requester);
+  GetDataBatch MakeBatch(std::vector<GetDataBatch::Entry> entries, const MessageHeader& requester);
+  // Handles an entry this node is in the destination close group for, as the equivalent single
+  // PutData or GetData would be.
+  void HandleBatchEntry(const PutDataBatch::Entry& entry, MessageHeader header, size_t index,
+                        BatchCollector& collector);
+  void HandleBatchEntry(const GetDataBatch::Entry& entry, MessageHeader header, size_t index,
+                        BatchCollector& collector);
+  static void RecordBatchResponse(PutDataBatchResponse response, const std::vector<size_t>& indices,
+                                  BatchCollector& collector);
+  static void RecordBatchResponse(GetDataBatchResponse response, const std::vector<size_t>& indices,
+                                  BatchCollector& collector);
+  // The largest fragment of a streamed payload, leaving room within PeerNode::MaxMessageSize for
+  // the header and the fragment's other fields.
+  static uint64_t MaxFragmentSize() { return PeerNode::MaxMessageSize() - 64 * 1024; }
+  // Asks for fragment |index| of a streamed Get.  The response is checked against the layout
+  // |count| and |total_size| given by fragment 0 (for which these are zero).
+  void SendGetFragment(DataTagValue tag, const Identity& name, uint32_t index, uint32_t count,
+                       uint64_t total_size,
+                       std::function<void(asio::error_code, GetDataFragmentResponse)> handler);
+  GetDataFragmentResponse ServeFragment(const GetDataFragment& request,
+                                        const MessageHeader& header);
+  // Hands the data of a PutData to the Child to store, returning CommonErrors::success if it was.
+  maidsafe_error StoreData(const PutData& put_data, const MessageHeader& header);
+  // Completes the outstanding request which a response answers.
+  void CompleteRequest(const MessageHeader& header, asio::error_code error,
+                       SerialisedMessage response);
   Address OurId() const { return Address(our_fob_.name()); }
 
  private:
   using unique_identifier = std::pair<Address, uint32_t>;
+  // Runs everything touching |connection_manager_| or its sockets: received messages, our requests
+  // and the timers expiring them.
   BoostAsioService crux_asio_service_;
   AsioService asio_service_;
+  // Received messages wait here by class until the crux thread is free.
+  InboundScheduler inbound_;
+  // Limits the rate each peer may send at and the bytes received but not yet handled.
+  AdmissionControl admission_;
   passport::Pmid our_fob_;
+  std::atomic<bool> draining_;
   std::atomic<MessageId> message_id_;
   boost::optional<Address> bootstrap_node_;
   // This crashes for me (PeterJ) on linux.
   // BootstrapHandler bootstrap_handler_;
   ConnectionManager connection_manager_;
-  LruCache<unique_identifier, void> filter_;
+  // Expires the entries of the filter, cache and sentinel's accumulators.  Driven on the crux
+  // thread; the sentinel's entries are locked as its verifier threads use them too.
+  TimingWheel expiry_wheel_;
+  ExpiringCache<unique_identifier> filter_;
   Sentinel sentinel_;
-  LruCache<Identity, SerialisedMessage> cache_;
-  std::vector<Address> connected_nodes_;
+  ExpiringCache<Identity, SerialisedMessage> cache_;
+  SignedResponseCache find_group_responses_;
+  // Outstanding Get/Put/Post requests, timed out on |expiry_wheel_|.
+  ResponseTable responses_;
+  LatencyTracker get_latencies_;
+  boost::optional<HedgeOptions> hedge_options_;
+  std::unique_ptr<SwarmFanout> swarm_fanout_;
+  // Streamed Puts being reassembled, and the payloads recently fetched to serve streamed Gets.
+  // Both are bounded by the bytes they hold rather than by how many payloads.
+  ReassemblyBuffer stream_reassembly_;
+  ExpiringCache<Identity, std::shared_ptr<const SerialisedData>> stream_sources_;
+  // Clients reaching the network through us, by their ReplyToAddress, and the peer each was last
+  // heard from.  Refreshed by every message we relay for a client, so only idle clients expire.
+  ExpiringCache<Address, Address> relays_;
+  TimingWheelDriver<boost::asio::steady_timer> expiry_driver_;
 };
 
 template <typename Child>
 RoutingNode<Child>::RoutingNode()
     : crux_asio_service_(1),
       asio_service_(4),
+      inbound_(crux_asio_service_.service(), 1),
+      admission_(),
       our_fob_(passport::Pmid(passport::Anpmid())),
+      draining_(false),
       message_id_(RandomUint32()),
       bootstrap_node_(boost::none),
       // bootstrap_handler_(),
       connection_manager_(crux_asio_service_.service(), passport::PublicPmid(our_fob_)),
-      filter_(std::chrono::minutes(20)),
-      sentinel_(asio_service_.service()),
-      cache_(std::chrono::minutes(60)),
-      connected_nodes_() {
+      expiry_wheel_(),
+      filter_(expiry_wheel_, std::chrono::minutes(20), 100000),
+      sentinel_(asio_service_.service(), expiry_wheel_),
+      cache_(expiry_wheel_, std::chrono::minutes(60), 1000),
+      find_group_responses_(1000),
+      responses_(expiry_wheel_),
+      get_latencies_(),
+      hedge_options_(),
+      swarm_fanout_(),
+      stream_reassembly_(expiry_wheel_, 512 * 1024 * 1024),
+      stream_sources_(expiry_wheel_, std::chrono::minutes(2), 1024, 256 * 1024 * 1024,
+                      [](const std::shared_ptr<const SerialisedData>& payload) {
+                        return static_cast<uint64_t>(payload->size());
+                      }),
+      relays_(expiry_wheel_, std::chrono::minutes(10), 10000),
+      expiry_driver_(crux_asio_service_.service(), expiry_wheel_) {
   // store this to allow other nodes to get our ID on startup. IF they have full routing tables they
   // need Quorum number of these signed anyway.
   cache_.Add(our_fob_.name(), Serialise(passport::PublicPmid(our_fob_)));
   // try an connect to any local nodes (5483) Expect to be told Node_Id
   auto temp_id(Address(RandomString(Address::kSize)));
 
-  connection_manager_.SetOnConnectionAdded(
-      [=](Address addr) { static_cast<Child*>(this)->HandleConnectionAdded(addr); });
+  // Admitted and classified here, before any other work is done, so that a flood of one class of
+  // message can't delay the others by more than its share of the crux thread's time.
+  connection_manager_.SetOnReceive([=](NodeId peer_id, const SerialisedMessage& message) {
+    Enqueue(std::move(peer_id), message);
+  });
+  connection_manager_.SetOnConnectionAdded([=](Address addr) {
+    sentinel_.HandleChurn(addr);
+    static_cast<Child*>(this)->HandleConnectionAdded(addr);
+  });
+  // A node leaving changes the groups it was in as much as one joining.
+  connection_manager_.SetOnConnectionLost([=](Address addr) { sentinel_.HandleChurn(addr); });
+  sentinel_.SetSendGetKey([=](NodeAddress node) { SendKeyRequest(node.data, GetKey(node)); });
+  sentinel_.SetSendGetGroupKey(
+      [=](GroupAddress group) { SendKeyRequest(group.data, GetGroupKey(group)); });
+  sentinel_.SetCheckCloseGroup([=](const GroupAddress& group, const std::vector<Address>& members) {
+    return connection_manager_.CouldBeCloseGroupOf(group.data, members);
+  });
 
   // PeterJ: Start listening on ports 5483 and 5433 (why two though?)
   // rudp_.Add(rudp::Contact(temp_id, EndpointPair{rudp::Endpoint{GetLocalIp(), 5483},
@@ -202,6 +406,10 @@ RoutingNode<Child>::RoutingNode()
 
 template <typename Child>
 RoutingNode<Child>::~RoutingNode() {
+  // Pending requests' handlers (e.g. for backup sends) refer to members.
+  inbound_.Stop();
+  asio_service_.Stop();
+  expiry_driver_.Stop();
   crux_asio_service_.Stop();
 }
 
@@ -210,13 +418,24 @@ template <typename DataType, typename CompletionToken>
 GetReturn<CompletionToken> RoutingNode<Child>::Get(Identity name, CompletionToken token) {
   GetHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  asio::post(asio_service_.service(), [=] {
-    MessageHeader our_header(std::make_pair(Destination(Address(name.string())), boost::none),
+  crux_asio_service_.service().post([=] {
+    const Address destination(name.string());
+    MessageHeader our_header(std::make_pair(Destination(destination), boost::none),
                              OurSourceAddress(), ++message_id_, Authority::node);
     GetData request(DataType::Tag::kValue, name, OurSourceAddress());
-    auto message(Serialise(our_header, MessageToTag<GetData>::value(), request));
-    for (const auto& target : connection_manager_.GetTarget(Address(name.string()))) {
-      connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
+    const auto sent(std::chrono::steady_clock::now());
+    ResponseTable::Handler on_response(
+        [this, handler, sent](asio::error_code error, SerialisedMessage data) mutable {
+          if (!error)
+            get_latencies_.Add(std::chrono::steady_clock::now() - sent);
+          handler(error, std::move(data));
+        });
+    if (hedge_options_) {
+      SendHedgedRequest(OutboundMessage(our_header, request), destination,
+                        our_header.MessageId(), std::move(on_response));
+    } else {
+      SendRequest(OutboundMessage(our_header, request), destination, our_header.MessageId(),
+                  std::move(on_response));
     }
   });
   return result.get();
@@ -232,16 +451,14 @@ PutReturn<CompletionToken> RoutingNode<Child>::Put(Address to, DataType data,
                                                    CompletionToken token) {
   PutHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  asio::post(asio_service_.service(), [=] {
+  crux_asio_service_.service().post([=] {
     MessageHeader our_header(std::make_pair(Destination(to), boost::none), OurSourceAddress(),
                              ++message_id_, Authority::client);
     PutData request(DataType::Tag::kValue, data.serialise());
     // FIXME(dirvine) For client in real put this needs signed :08/02/2015
     // fixme data should serialise properly and not require the above call to serialse()
-    auto message(Serialise(our_header, MessageToTag<PutData>::value(), request));
-    for (const auto& target : connection_manager_.GetTarget(to)) {
-      connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
-    }
+    SendRequest(OutboundMessage(our_header, request), to, our_header.MessageId(),
+                [handler](asio::error_code error, SerialisedMessage) mutable { handler(error); });
   });
   return result.get();
 }
@@ -252,17 +469,122 @@ PostReturn<CompletionToken> RoutingNode<Child>::Post(Address to, FunctorType fun
                                                      CompletionToken token) {
   PostHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
   asio::async_result<decltype(handler)> result(handler);
-  asio::post(asio_service_.service(), [=] {
+  crux_asio_service_.service().post([=] {
     MessageHeader our_header(std::make_pair(Destination(to), boost::none), OurSourceAddress(),
                              ++message_id_, Authority::node);
-    PutData request(FunctorType::Tag::kValue, functor);
+    routing::Post request(FunctorType::Tag::kValue, Identity(to.string()), functor.serialise());
     // FIXME(dirvine) This needs signed :08/02/2015
-    auto message(Serialise(our_header, MessageToTag<routing::Post>::value(), request));
+    SendRequest(OutboundMessage(our_header, request), to, our_header.MessageId(),
+                [handler](asio::error_code error, SerialisedMessage) mutable { handler(error); });
+  });
+  return result.get();
+}
 
-    for (const auto& target : connection_manager_.GetTarget(to)) {
-      // FIXME(PeterJ) Call the above handler when all send handlers finish.
-      connection_manager_.FindPeer(target)->Send(message, [](asio::error_code) {});
-    }
+template <typename Child>
+template <typename CompletionToken>
+BatchReturn<CompletionToken> RoutingNode<Child>::PutBatch(std::vector<PutDataBatch::Entry> entries,
+                                                          CompletionToken token) {
+  BatchHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
+  asio::async_result<decltype(handler)> result(handler);
+  auto shared_entries(std::make_shared<std::vector<PutDataBatch::Entry>>(std::move(entries)));
+  crux_asio_service_.service().post([=] {
+    MessageHeader our_header(std::make_pair(Destination(OurId()), boost::none), OurSourceAddress(),
+                             ++message_id_, Authority::client);
+    SendBatch<PutDataBatch, PutDataBatchResponse>(
+        std::move(*shared_entries), our_header,
+        [handler](std::vector<BatchResult> results) mutable {
+          handler(asio::error_code(), std::move(results));
+        });
+  });
+  return result.get();
+}
+
+template <typename Child>
+template <typename CompletionToken>
+BatchReturn<CompletionToken> RoutingNode<Child>::GetBatch(std::vector<GetDataBatch::Entry> entries,
+                                                          CompletionToken token) {
+  BatchHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
+  asio::async_result<decltype(handler)> result(handler);
+  auto shared_entries(std::make_shared<std::vector<GetDataBatch::Entry>>(std::move(entries)));
+  crux_asio_service_.service().post([=] {
+    MessageHeader our_header(std::make_pair(Destination(OurId()), boost::none), OurSourceAddress(),
+                             ++message_id_, Authority::node);
+    SendBatch<GetDataBatch, GetDataBatchResponse>(
+        std::move(*shared_entries), our_header,
+        [handler](std::vector<BatchResult> results) mutable {
+          handler(asio::error_code(), std::move(results));
+        });
+  });
+  return result.get();
+}
+
+template <typename Child>
+template <typename CompletionToken>
+PutReturn<CompletionToken> RoutingNode<Child>::PutStream(Address to, DataTagValue tag,
+                                                         Identity name, SerialisedData data,
+                                                         CompletionToken token, uint32_t window) {
+  PutHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
+  asio::async_result<decltype(handler)> result(handler);
+  auto payload(std::make_shared<const SerialisedData>(std::move(data)));
+  crux_asio_service_.service().post([=] {
+    const auto count(FragmentCount(payload->size(), MaxFragmentSize()));
+    WindowedStream::Start(
+        count, std::max<uint32_t>(window, 1), WindowedStream::kDefaultMaxRetries,
+        [this, to, tag, name, payload, count](uint32_t index,
+                                              WindowedStream::Acknowledge acknowledge) {
+          MessageHeader our_header(std::make_pair(Destination(to), boost::none),
+                                   OurSourceAddress(), ++message_id_, Authority::client);
+          PutDataFragment request(tag, name, index, count, payload->size(),
+                                  CopyFragment(*payload, count, index));
+          SendRequest(OutboundMessage(our_header, request), to, our_header.MessageId(),
+                      [acknowledge](asio::error_code error, SerialisedMessage) {
+                        acknowledge(error);
+                      });
+        },
+        [handler](asio::error_code error) mutable { handler(error); });
+  });
+  return result.get();
+}
+
+template <typename Child>
+template <typename CompletionToken>
+GetReturn<CompletionToken> RoutingNode<Child>::GetStream(DataTagValue tag, Identity name,
+                                                         CompletionToken token, uint32_t window) {
+  GetHandler<CompletionToken> handler(std::forward<decltype(token)>(token));
+  asio::async_result<decltype(handler)> result(handler);
+  crux_asio_service_.service().post([=] {
+    // Fragment 0 gives the payload's layout, so is fetched before the rest.
+    SendGetFragment(tag, name, 0, 0, 0, [=](asio::error_code error,
+                                            GetDataFragmentResponse first) mutable {
+      if (!error && first.total_size() > stream_reassembly_.Capacity())
+        error = make_error_code(CommonErrors::unable_to_handle_request);
+      if (error)
+        return handler(error, SerialisedMessage());
+      const auto count(first.count());
+      const auto total_size(first.total_size());
+      auto payload(std::make_shared<SerialisedMessage>(total_size));
+      std::copy(std::begin(*first.data()), std::end(*first.data()), std::begin(*payload));
+      WindowedStream::Start(
+          count - 1, std::max<uint32_t>(window, 1), WindowedStream::kDefaultMaxRetries,
+          [this, tag, name, count, total_size, payload](
+              uint32_t index, WindowedStream::Acknowledge acknowledge) {
+            SendGetFragment(tag, name, index + 1, count, total_size,
+                            [payload, acknowledge](asio::error_code error,
+                                                   GetDataFragmentResponse fragment) {
+                              if (!error) {
+                                const auto begin(FragmentBounds(payload->size(), fragment.count(),
+                                                                fragment.index()).first);
+                                std::copy(std::begin(*fragment.data()), std::end(*fragment.data()),
+                                          std::begin(*payload) +
+                                              static_cast<std::ptrdiff_t>(begin));
+                              }
+                              acknowledge(error);
+                            });
+          },
+          [handler, payload](asio::error_code error) mutable {
+            handler(error, error ? SerialisedMessage() : std::move(*payload));
+          });
+    });
   });
   return result.get();
 }
@@ -272,56 +594,345 @@ void RoutingNode<Child>::ConnectToCloseGroup() {
   FindGroup message(NodeAddress(OurId()), OurId());
   MessageHeader header(DestinationAddress(std::make_pair(Destination(OurId()), boost::none)),
                        SourceAddress{OurSourceAddress()}, ++message_id_, Authority::node);
+  OutboundMessage outbound(header, message);
   if (bootstrap_node_) {
     auto peer = connection_manager_.FindPeer(*bootstrap_node_);
-    peer->Send(Serialise(header, MessageToTag<FindGroup>::value(), message),
-               [](asio::error_code error) {
+    if (!peer)
+      return;
+    outbound.Send(*peer, [](asio::error_code error) {
       if (error) {
         LOG(kWarning) << "rudp cannot send via bootstrap node" << error.message();
       }
     });
     return;
   }
-  for (const auto& target : connection_manager_.GetTarget(OurId())) {
-    auto peer = connection_manager_.FindPeer(target);
-    peer->Send(Serialise(header, MessageToTag<Connect>::value(), message),
-               [](asio::error_code error) {
-      if (error) {
-        LOG(kWarning) << "rudp cannot send" << error.message();
-      }
-    });
+  outbound.Send(connection_manager_, connection_manager_.GetTarget(OurId()));
+}
+
+template <typename Child>
+template <typename Message>
+void RoutingNode<Child>::SendKeyRequest(const Address& target, const Message& message) {
+  MessageHeader header(DestinationAddress(std::make_pair(Destination(target), boost::none)),
+                       SourceAddress{OurSourceAddress()}, ++message_id_, Authority::node);
+  OutboundMessage(header, message).Send(connection_manager_, connection_manager_.GetTarget(target));
+}
+
+template <typename Child>
+void RoutingNode<Child>::SendRequest(const OutboundMessage& message, const Address& destination,
+                                     MessageId message_id, ResponseTable::Handler handler) {
+  // Registered before sending, so even an immediate response finds it.
+  const ResponseTable::Key key(destination, message_id);
+  if (!responses_.Add(key, std::move(handler)))
+    return;
+  if (message.Send(connection_manager_, connection_manager_.GetTarget(destination)) == 0)
+    responses_.Complete(key, asio::error::network_unreachable, SerialisedMessage());
+}
+
+template <typename Child>
+void RoutingNode<Child>::SendHedgedRequest(const OutboundMessage& message,
+                                           const Address& destination, MessageId message_id,
+                                           ResponseTable::Handler handler) {
+  const ResponseTable::Key key(destination, message_id);
+  if (!responses_.Add(key, std::move(handler)))
+    return;
+  const auto targets(connection_manager_.GetTarget(destination));
+  const auto percentile(get_latencies_.Percentile(hedge_options_->percentile));
+  HedgedRequest<boost::asio::steady_timer>::Start(
+      crux_asio_service_.service(), responses_, key,
+      std::vector<Address>(std::begin(targets), std::end(targets)),
+      percentile ? *percentile : hedge_options_->initial_delay, hedge_options_->max_attempts,
+      [this, message](const Address& target) {
+        return message.Send(connection_manager_, std::vector<Address>(1, target)) != 0;
+      });
+}
+
+template <typename Child>
+template <typename Batch, typename Response>
+void RoutingNode<Child>::SendBatch(std::vector<typename Batch::Entry> entries,
+                                   const MessageHeader& requester, BatchCollector::Done done) {
+  std::vector<Identity> names;
+  names.reserve(entries.size());
+  for (const auto& entry : entries)
+    names.push_back(entry.name);
+  auto collector(std::make_shared<BatchCollector>(std::move(names), std::move(done)));
+  const auto plan(PlanBatch(
+      entries,
+      [this](const Address& name) { return connection_manager_.AddressInCloseGroupRange(name); },
+      [this](const Address& name) -> boost::optional<Address> {
+        const auto targets(connection_manager_.GetTarget(name));
+        if (targets.empty())
+          return boost::none;
+        return *std::begin(targets);
+      }));
+  collector->SetAll(plan.unroutable, asio::error::network_unreachable);
+
+  for (const auto index : plan.local) {
+    const Address name(entries[index].name.string());
+    HandleBatchEntry(entries[index],
+                     MessageHeader(std::make_pair(Destination(name), boost::none),
+                                   requester.Source(), requester.MessageId(),
+                                   requester.FromAuthority()),
+                     index, *collector);
+  }
+
+  for (const auto& part : plan.remote) {
+    std::vector<typename Batch::Entry> part_entries;
+    part_entries.reserve(part.second.size());
+    for (const auto index : part.second)
+      part_entries.push_back(std::move(entries[index]));
+    const MessageHeader header(std::make_pair(Destination(part.first), boost::none),
+                               OurSourceAddress(), ++message_id_, Authority::node);
+    const auto indices(part.second);
+    collector->AddPart();
+    // Sent straight to the next hop rather than swarmed, as the batch is split again there.
+    const ResponseTable::Key key(part.first, header.MessageId());
+    if (!responses_.Add(key, [collector, indices](asio::error_code error,
+                                                  SerialisedMessage response) {
+          if (error) {
+            collector->SetAll(indices, error);
+          } else {
+            try {
+              InputVectorStream binary_input_stream{response};
+              RecordBatchResponse(Parse<Response>(binary_input_stream), indices, *collector);
+            } catch (const std::exception&) {
+              collector->SetAll(indices, make_error_code(CommonErrors::parsing_error));
+            }
+          }
+          collector->PartDone();
+        })) {
+      continue;
+    }
+    if (OutboundMessage(header, MakeBatch(std::move(part_entries), requester))
+            .Send(connection_manager_, std::vector<Address>(1, part.first)) == 0) {
+      responses_.Complete(key, asio::error::network_unreachable, SerialisedMessage());
+    }
+  }
+  collector->PartDone();
+}
+
+template <typename Child>
+PutDataBatch RoutingNode<Child>::MakeBatch(std::vector<PutDataBatch::Entry> entries,
+                                           const MessageHeader& /*requester*/) {
+  return PutDataBatch(std::move(entries));
+}
+
+template <typename Child>
+GetDataBatch RoutingNode<Child>::MakeBatch(std::vector<GetDataBatch::Entry> entries,
+                                           const MessageHeader& requester) {
+  return GetDataBatch(std::move(entries), requester.Source());
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleBatchEntry(const PutDataBatch::Entry& entry, MessageHeader header,
+                                          size_t index, BatchCollector& collector) {
+  try {
+    collector.Set(index, ToErrorCode(StoreData(PutData(entry.tag, entry.data), header)));
+  } catch (const maidsafe_error& error) {
+    collector.Set(index, error.code());
+  }
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleBatchEntry(const GetDataBatch::Entry& entry, MessageHeader header,
+                                          size_t index, BatchCollector& collector) {
+  try {
+    auto result(static_cast<Child*>(this)->HandleGet(
+        header.Source(), OurAuthority(Address(entry.name.string()), header), entry.tag,
+        entry.name));
+    if (!result)
+      collector.Set(index, ToErrorCode(result.error()));
+    else if (result->which() == 1u)
+      collector.Set(index, asio::error_code(), boost::get<std::vector<byte>>(*result));
+    else  // to be sent on, which as for a single GetData isn't supported yet
+      collector.Set(index, make_error_code(CommonErrors::no_such_element));
+  } catch (const maidsafe_error& error) {
+    collector.Set(index, error.code());
+  }
+}
+
+template <typename Child>
+void RoutingNode<Child>::RecordBatchResponse(PutDataBatchResponse response,
+                                             const std::vector<size_t>& indices,
+                                             BatchCollector& collector) {
+  const auto& errors(response.errors());
+  if (errors.size() != indices.size())
+    return collector.SetAll(indices, make_error_code(CommonErrors::parsing_error));
+  for (size_t i(0); i < indices.size(); ++i)
+    collector.Set(indices[i], ToErrorCode(errors[i]));
+}
+
+template <typename Child>
+void RoutingNode<Child>::RecordBatchResponse(GetDataBatchResponse response,
+                                             const std::vector<size_t>& indices,
+                                             BatchCollector& collector) {
+  auto results(response.take_results());
+  if (results.size() != indices.size())
+    return collector.SetAll(indices, make_error_code(CommonErrors::parsing_error));
+  for (size_t i(0); i < indices.size(); ++i) {
+    if (results[i].error)
+      collector.Set(indices[i], ToErrorCode(*results[i].error));
+    else if (results[i].data)
+      collector.Set(indices[i], asio::error_code(), std::move(*results[i].data));
+    else
+      collector.Set(indices[i], make_error_code(CommonErrors::no_such_element));
+  }
+}
+
+template <typename Child>
+void RoutingNode<Child>::SendGetFragment(
+    DataTagValue tag, const Identity& name, uint32_t index, uint32_t count, uint64_t total_size,
+    std::function<void(asio::error_code, GetDataFragmentResponse)> handler) {
+  const Address destination(name.string());
+  MessageHeader our_header(std::make_pair(Destination(destination), boost::none),
+                           OurSourceAddress(), ++message_id_, Authority::node);
+  SendRequest(OutboundMessage(our_header, GetDataFragment(tag, name, index)), destination,
+              our_header.MessageId(),
+              [=](asio::error_code error, SerialisedMessage serialised) {
+                GetDataFragmentResponse response;
+                if (!error) {
+                  try {
+                    InputVectorStream binary_input_stream{serialised};
+                    response = Parse<GetDataFragmentResponse>(binary_input_stream);
+                  } catch (const std::exception&) {
+                    error = make_error_code(CommonErrors::parsing_error);
+                  }
+                }
+                if (!error && response.error())
+                  error = ToErrorCode(*response.error());
+                if (!error) {
+                  const auto bounds(
+                      FragmentBounds(response.total_size(), response.count(), index));
+                  if (!response.data() || response.index() != index ||
+                      index >= response.count() ||
+                      (count != 0 &&
+                       (response.count() != count || response.total_size() != total_size)) ||
+                      response.data()->size() != bounds.second - bounds.first) {
+                    LOG(kWarning) << "Fragment " << index << " doesn't fit its payload.";
+                    error = make_error_code(CommonErrors::parsing_error);
+                  }
+                }
+                handler(error, std::move(response));
+              });
+}
+
+template <typename Child>
+GetDataFragmentResponse RoutingNode<Child>::ServeFragment(const GetDataFragment& request,
+                                                          const MessageHeader& header) {
+  auto payload(stream_sources_.Get(request.name()));
+  if (!payload) {
+    auto result(static_cast<Child*>(this)->HandleGet(
+        header.Source(), OurAuthority(Address(request.name().string()), header), request.tag(),
+        request.name()));
+    if (!result)
+      return GetDataFragmentResponse(request.name(), request.index(), result.error());
+    if (result->which() != 1u) {
+      // To be sent on, which as for a single GetData isn't supported yet
+      return GetDataFragmentResponse(request.name(), request.index(),
+                                     MakeError(CommonErrors::no_such_element));
+    }
+    payload = std::make_shared<const SerialisedData>(
+        std::move(boost::get<std::vector<byte>>(*result)));
+    stream_sources_.Add(request.name(), *payload);
+  }
+  const auto& data(**payload);
+  const auto count(FragmentCount(data.size(), MaxFragmentSize()));
+  if (request.index() >= count) {
+    return GetDataFragmentResponse(request.name(), request.index(),
+                                   MakeError(CommonErrors::invalid_parameter));
+  }
+  return GetDataFragmentResponse(request.name(), request.index(), count, data.size(),
+                                 CopyFragment(data, count, request.index()));
+}
+
+template <typename Child>
+void RoutingNode<Child>::CompleteRequest(const MessageHeader& header, asio::error_code error,
+                                         SerialisedMessage response) {
+  // Responses come from the group at (or the node with) the address the request was sent to.
+  if (!responses_.Complete(ResponseTable::Key(header.FromAddress(), header.MessageId()), error,
+                           std::move(response))) {
+    LOG(kVerbose) << "Response matches no outstanding request.";
   }
 }
 
 template <typename Child>
-void RoutingNode<Child>::MessageReceived(NodeId /* peer_id */,
-                                         SerialisedMessage serialised_message) {
-  InputVectorStream binary_input_stream{serialised_message};
-  MessageHeader header;
-  MessageTypeTag tag;
-  Identity name;
+void RoutingNode<Child>::Enqueue(NodeId peer_id, const SerialisedMessage& serialised_message) {
+  // The header is parsed once, here, and handed on with the stream positioned at the body.
+  auto received(std::make_shared<ReceivedMessage>(std::move(peer_id), serialised_message));
   try {
-    Parse(binary_input_stream, header, tag);
+    Parse(received->body, received->header, received->tag);
   } catch (const std::exception&) {
     LOG(kError) << "header failure." << boost::current_exception_diagnostic_information();
     return;
   }
+  const auto destination(received->header.Destination().first);
+  if (draining_ && destination.data != OurId())
+    return;
+  const auto size(serialised_message.size());
+  if (!admission_.Admit(received->peer_id, Prioritise(received->tag), size)) {
+    LOG(kVerbose) << "Message shed by admission control.";
+    return;
+  }
+  const bool for_our_group(destination.data == OurId() ||
+                           connection_manager_.AddressInCloseGroupRange(destination));
+  if (!inbound_.Push(Classify(received->tag, for_our_group), [this, received, size] {
+        MessageReceived(*received);
+        admission_.Release(size);
+      })) {
+    LOG(kVerbose) << "Inbound queue full, message dropped.";
+    admission_.Release(size);
+  }
+}
+
+template <typename Child>
+void RoutingNode<Child>::MessageReceived(ReceivedMessage& message) {
+  const auto& peer_id(message.peer_id);
+  const auto& serialised_message(message.serialised);
+  auto& binary_input_stream(message.body);
+  auto& header(message.header);
+  const auto tag(message.tag);
 
-  if (filter_.Check(header.FilterValue()))
+  if (filter_.Check(header.FilterValue())) {
+    if (swarm_fanout_)
+      swarm_fanout_->Duplicate(header.Destination().first);
     return;  // already seen
+  }
   // add to filter as soon as posible
-  filter_.Add({header.FilterValue()});
+  filter_.Add(header.FilterValue());
+
+  // A client relaying through us names us as the source node.  Responses to it come back to us
+  // with its address as the destination reply_to, and go straight to the peer it was heard from
+  // rather than being forwarded on.
+  if (header.RelayedMessage() && header.FromNode().data == OurId()) {
+    relays_.Add(header.ReplyToAddress()->data, peer_id);
+  } else if (header.Destination().second && header.Destination().first.data == OurId()) {
+    const auto relay(relays_.Get(header.Destination().second->data));
+    if (!relay) {
+      LOG(kVerbose) << "No relay for response to client.";
+      return;
+    }
+    OutboundMessage(serialised_message).Send(connection_manager_, std::vector<Address>(1, *relay));
+    return;
+  }
 
-  // We add these to cache
-  if (tag == MessageTypeTag::GetDataResponse) {
-    auto data = Parse<GetDataResponse>(binary_input_stream);
-    if (data.data())
-      cache_.Add(data.name(), *data.data());
+  // Bodies parsed here for the cache are handed on to the handler below rather than parsed twice.
+  boost::optional<GetDataResponse> get_data_response;
+  boost::optional<GetData> get_data;
+  try {
+    // We add these to cache
+    if (tag == MessageTypeTag::GetDataResponse) {
+      get_data_response = Parse<GetDataResponse>(binary_input_stream);
+      if (get_data_response->data())
+        cache_.Add(get_data_response->name(), *get_data_response->data());
+    } else if (tag == MessageTypeTag::GetData) {
+      get_data = Parse<GetData>(binary_input_stream);
+    }
+  } catch (const std::exception&) {
+    LOG(kError) << "message failure." << boost::current_exception_diagnostic_information();
+    return;
   }
   // if we can satisfy request from cache we do
-  if (tag == MessageTypeTag::GetData) {
-    auto data = Parse<GetData>(binary_input_stream);
-    auto test = cache_.Get(data.name());
+  if (get_data) {
+    auto test = cache_.Get(get_data->name());
     // FIXME(dirvine) move to upper lauer :09/02/2015
     // if (test) {
     //   GetDataResponse response(data.name(), test);
@@ -338,57 +949,79 @@ void RoutingNode<Child>::MessageReceived(NodeId /* peer_id */,
     // }
   }
 
-  // send to next node(s) even our close group (swarm mode)
-  for (const auto& target : connection_manager_.GetTarget(header.Destination().first)) {
-    PeerNode* peer = connection_manager_.FindPeer(target);
-    peer->Send(serialised_message, [](asio::error_code error) {
-      if (error) {
-        LOG(kWarning) << "cannot send" << error.message();
-      }
-    });
-  }
-  // FIXME(dirvine) We need new rudp for this :26/01/2015
-  if (header.RelayedMessage() &&
-      std::any_of(std::begin(connected_nodes_), std::end(connected_nodes_),
-                  [&header](const Address& node) { return node == *header.ReplyToAddress(); })) {
-    // send message to connected node
+  // Batches are sent hop by hop to a node, which splits them itself (see SendBatch), so they
+  // aren't swarmed on like other messages.
+  if (tag == MessageTypeTag::PutDataBatch || tag == MessageTypeTag::PutDataBatchResponse ||
+      tag == MessageTypeTag::GetDataBatch || tag == MessageTypeTag::GetDataBatchResponse) {
+    if (header.Destination().first.data != OurId())
+      return;
+    try {
+      MessageDispatcher<RoutingNode>::Dispatch(*this, tag, binary_input_stream, std::move(header));
+    } catch (const std::exception&) {
+      LOG(kError) << "message failure." << boost::current_exception_diagnostic_information();
+    }
     return;
   }
 
+  // send to next node(s) even our close group (swarm mode)
+  auto targets(connection_manager_.GetTarget(header.Destination().first));
+  if (swarm_fanout_) {
+    const auto selected(swarm_fanout_->Received(header.Destination().first, targets));
+    if (!selected.empty())
+      OutboundMessage(serialised_message).Send(connection_manager_, selected);
+  } else if (!targets.empty()) {
+    OutboundMessage(serialised_message).Send(connection_manager_, targets);
+  }
   if (!connection_manager_.AddressInCloseGroupRange(header.Destination().first))
     return;  // not for us
 
-  // FIXME(dirvine) Sentinel check here!!  :19/01/2015
-  switch (tag) {
-    case MessageTypeTag::Connect:
-      HandleMessage(Parse<Connect>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::ConnectResponse:
-      HandleMessage(Parse<ConnectResponse>(binary_input_stream));
-      break;
-    case MessageTypeTag::FindGroup:
-      HandleMessage(Parse<FindGroup>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::FindGroupResponse:
-      HandleMessage(Parse<FindGroupResponse>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::GetData:
-      static_cast<Child*>(this)
-          ->HandleMessage(Parse<GetData>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::GetDataResponse:
-      // static_cast<Child*>(this)
-      //     ->HandleMessage(Parse<GetDataResponse>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::PutData:
-      HandleMessage(Parse<PutData>(binary_input_stream), std::move(header));
-      break;
-    case MessageTypeTag::Post:
-      HandleMessage(Parse<routing::Post>(binary_input_stream), std::move(header));
-      break;
-    default:
-      LOG(kWarning) << "Received message of unknown type.";
-      break;
+  // Key responses are handed to the sentinel by their handlers.  A Connect or ConnectResponse
+  // carries its sender's own key, which the network can't vouch for until the sender has joined.
+  if (header.Signature() && tag != MessageTypeTag::GetKeyResponse &&
+      tag != MessageTypeTag::GetGroupKeyResponse && tag != MessageTypeTag::Connect &&
+      tag != MessageTypeTag::ConnectResponse) {
+    CheckSignatures(std::move(header), tag, serialised_message);
+    return;
+  }
+  try {
+    if (get_data_response)
+      HandleMessage(std::move(*get_data_response), std::move(header));
+    else if (get_data)
+      HandleMessage(std::move(*get_data), std::move(header));
+    else
+      MessageDispatcher<RoutingNode>::Dispatch(*this, tag, binary_input_stream, std::move(header));
+  } catch (const std::exception&) {
+    LOG(kError) << "message failure." << boost::current_exception_diagnostic_information();
+  }
+}
+
+template <typename Child>
+void RoutingNode<Child>::CheckSignatures(MessageHeader header, MessageTypeTag tag,
+                                         const SerialisedMessage& serialised_message) {
+  // The signatures are over the body alone, which follows the header and tag.
+  const auto body_offset(Serialise(header, tag).size());
+  if (body_offset > serialised_message.size())
+    return;
+  SerialisedMessage body(std::begin(serialised_message) + body_offset,
+                         std::end(serialised_message));
+  try {
+    sentinel_.Add(header, tag, std::move(body), [=](Sentinel::Result result) {
+      crux_asio_service_.service().post([=] {
+        if (!result) {
+          LOG(kWarning) << "Signature check failed: " << result.error().what();
+          return;
+        }
+        try {
+          InputVectorStream binary_input_stream{std::get<2>(*result)};
+          MessageDispatcher<RoutingNode>::Dispatch(*this, tag, binary_input_stream,
+                                                   MessageHeader(header));
+        } catch (const std::exception&) {
+          LOG(kError) << "message failure." << boost::current_exception_diagnostic_information();
+        }
+      });
+    });
+  } catch (const std::exception&) {
+    LOG(kError) << "message failure." << boost::current_exception_diagnostic_information();
   }
 }
 
@@ -435,16 +1068,9 @@ void RoutingNode<Child>::HandleMessage(Connect connect, MessageHeader original_h
   // FIXME(dirvine) Do we need to pass a shared_from_this type object or this may segfault on
   // shutdown
   // :24/01/2015
-  for (auto& target : targets) {
-    connection_manager_.FindPeer(target)
-        ->Send(Serialise(header, MessageToTag<ConnectResponse>::value(), respond),
-               [connect, this](asio::error_code error_code) {
-          if (error_code)
-            return;
-        });
-  }
+  OutboundMessage(header, respond).Send(connection_manager_, targets);
 
-  connection_manager_.AddNode(NodeInfo(connect.requester_id(), connect.requester_fob(), true),
+  connection_manager_.AddNode(NodeInfo(connect.requester_id(), connect.take_requester_fob(), true),
                               connect.requester_endpoints());
 
   // if (added)
@@ -452,12 +1078,13 @@ void RoutingNode<Child>::HandleMessage(Connect connect, MessageHeader original_h
 }
 
 template <typename Child>
-void RoutingNode<Child>::HandleMessage(ConnectResponse connect_response) {
+void RoutingNode<Child>::HandleMessage(ConnectResponse connect_response,
+                                       MessageHeader /* original_header */) {
   if (!connection_manager_.IsManaged(connect_response.requester_id()))
     return;
 
   connection_manager_.AddNode(
-      NodeInfo(connect_response.requester_id(), connect_response.receiver_fob(), true),
+      NodeInfo(connect_response.requester_id(), connect_response.take_receiver_fob(), true),
       connect_response.receiver_endpoints());
 
   // auto target = connect_response.requester_id();
@@ -480,18 +1107,24 @@ void RoutingNode<Child>::HandleMessage(ConnectResponse connect_response) {
 }
 template <typename Child>
 void RoutingNode<Child>::HandleMessage(FindGroup find_group, MessageHeader original_header) {
-  auto group = connection_manager_.OurCloseGroup();
-  // add ourselves
-  group.push_back(passport::PublicPmid(our_fob_));
-  FindGroupResponse response(find_group.target_id(), std::move(group));
+  // The signed response only changes with our close group, so is built at most once per target
+  // per close group version.
+  const auto response(find_group_responses_.Get(
+      find_group.target_id(), connection_manager_.CloseGroupVersion(), [&] {
+        // Signed by each member and accumulated by the sentinel, so it has to be the same body
+        // from every member.
+        auto body(Serialise(FindGroupResponse(find_group.target_id(),
+                                              connection_manager_.CloseGroupOf(
+                                                  find_group.target_id()))));
+        auto signature(asymm::Sign(body, our_fob_.private_key()));
+        return SignedResponseCache::SignedBody{
+            std::make_shared<const SerialisedData>(std::move(body)), std::move(signature)};
+      }));
   MessageHeader header(DestinationAddress(original_header.ReturnDestinationAddress()),
                        SourceAddress(OurSourceAddress(GroupAddress(find_group.target_id()))),
-                       original_header.MessageId(), Authority::nae_manager,
-                       asymm::Sign(Serialise(response), our_fob_.private_key()));
-  auto message(Serialise(header, MessageToTag<FindGroupResponse>::value(), response));
-  for (const auto& node : connection_manager_.GetTarget(original_header.FromNode())) {
-    connection_manager_.FindPeer(node)->Send(message, [](asio::error_code) {});
-  }
+                       original_header.MessageId(), Authority::nae_manager, response.signature);
+  OutboundMessage(header, MessageTypeTag::FindGroupResponse, *response.body)
+      .Send(connection_manager_, connection_manager_.GetTarget(original_header.FromNode()));
 }
 
 template <typename Child>
@@ -500,45 +1133,240 @@ void RoutingNode<Child>::HandleMessage(FindGroupResponse find_group_reponse,
   // this is called to get our group on bootstrap, we will try and connect to each of these nodes
   // Only other reason is to allow the sentinel to check signatures and those calls will just fall
   // through here.
-  for (const auto node_pmid : find_group_reponse.group()) {
+  // Each Connect names its receiver so has to be serialised per group member, but only once for
+  // all of the targets it's sent to.
+  for (const auto& node_pmid : find_group_reponse.group()) {
     Address node_id(node_pmid.name()->string());
     if (!connection_manager_.IsManaged(node_id))
       continue;
     Connect message(NextEndpointPair(), OurId(), node_id, passport::PublicPmid(our_fob_));
     MessageHeader header(DestinationAddress(std::make_pair(Destination(node_id), boost::none)),
                          SourceAddress{OurSourceAddress()}, ++message_id_, Authority::nae_manager);
-    for (const auto& target : connection_manager_.GetTarget(node_id))
-      connection_manager_.FindPeer(target)->Send(
-          Serialise(header, MessageToTag<Connect>::value(), message), [](asio::error_code) {});
+    OutboundMessage(header, message)
+        .Send(connection_manager_, connection_manager_.GetTarget(node_id));
   }
 }
 
 template <typename Child>
-void RoutingNode<Child>::HandleMessage(GetData get_data, MessageHeader header) {
-  auto result = static_cast<Child*>(this)->HandleGet(header.Source(),
-                                                     OurAuthority(Address(get_data.name()), header),
-                                                     get_data.tag(), get_data.name());
+void RoutingNode<Child>::HandleMessage(GetData get_data, MessageHeader original_header) {
+  auto result = static_cast<Child*>(this)->HandleGet(
+      original_header.Source(), OurAuthority(Address(get_data.name()), original_header),
+      get_data.tag(), get_data.name());
+  boost::optional<GetDataResponse> response;
   if (!result) {
-    // send back error
-    return;
-  }
-  if (result->which() == 0u) {
-    // send on
+    response = GetDataResponse(Identity(get_data.name()), result.error());
   } else if (result->which() == 1u) {
-    // send back the data
+    response = GetDataResponse(Identity(get_data.name()),
+                               std::move(boost::get<std::vector<byte>>(*result)));
+  } else {  // to be sent on to the nodes holding the data, which isn't supported yet
+    response = GetDataResponse(Identity(get_data.name()), MakeError(CommonErrors::no_such_element));
   }
+  MessageHeader header(original_header.ReturnDestinationAddress(),
+                       OurSourceAddress(GroupAddress(Address(get_data.name().string()))),
+                       original_header.MessageId(), Authority::nae_manager);
+  OutboundMessage(header, *response)
+      .Send(connection_manager_, connection_manager_.GetTarget(original_header.FromNode()));
 }
 
 template <typename Child>
-void RoutingNode<Child>::HandleMessage(PutData /*put_data*/, MessageHeader /* original_header */) {}
+void RoutingNode<Child>::HandleMessage(GetDataResponse get_data_response,
+                                       MessageHeader original_header) {
+  if (get_data_response.error()) {
+    // A hedged Get may yet be answered by one of the other targets it was sent to.
+    responses_.Fail(ResponseTable::Key(original_header.FromAddress(), original_header.MessageId()),
+                    ToErrorCode(*get_data_response.error()));
+  } else if (get_data_response.data()) {
+    CompleteRequest(original_header, asio::error_code(), *get_data_response.take_data());
+  }
+}
 
 template <typename Child>
-void RoutingNode<Child>::HandleMessage(PutDataResponse /*put_data_response*/,
-                                       MessageHeader /* original_header */) {}
+void RoutingNode<Child>::HandleMessage(GetKey get_key, MessageHeader original_header) {
+  const Address& target(get_key.node_address().data);
+  boost::optional<passport::PublicPmid> fob;
+  if (target == OurId()) {
+    fob = passport::PublicPmid(our_fob_);
+  } else if (PeerNode* peer = connection_manager_.FindPeer(target)) {
+    fob = peer->node_info().dht_fob;
+  }
+  if (!fob)
+    return;
+  GetKeyResponse response(get_key.node_address(), std::move(*fob));
+  MessageHeader header(DestinationAddress(original_header.ReturnDestinationAddress()),
+                       SourceAddress(OurSourceAddress(GroupAddress(target))),
+                       original_header.MessageId(), Authority::nae_manager,
+                       asymm::Sign(Serialise(response), our_fob_.private_key()));
+  OutboundMessage(header, response)
+      .Send(connection_manager_, connection_manager_.GetTarget(original_header.FromNode()));
+}
 
 template <typename Child>
-void RoutingNode<Child>::HandleMessage(routing::Post /* post */,
-                                       MessageHeader /* original_header */) {}
+void RoutingNode<Child>::HandleMessage(GetKeyResponse get_key_response,
+                                       MessageHeader original_header) {
+  // The sentinel learns the key once a quorum of the group's responses agree on it.
+  sentinel_.Add(std::move(original_header), MessageTypeTag::GetKeyResponse,
+                Serialise(get_key_response));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(GetGroupKey get_group_key, MessageHeader original_header) {
+  // Each member's response is accumulated by the requester, so all must send the same body.
+  GetGroupKeyResponse response(
+      get_group_key.group_address(),
+      connection_manager_.CloseGroupOf(get_group_key.group_address().data));
+  MessageHeader header(DestinationAddress(original_header.ReturnDestinationAddress()),
+                       SourceAddress(OurSourceAddress(get_group_key.group_address())),
+                       original_header.MessageId(), Authority::nae_manager,
+                       asymm::Sign(Serialise(response), our_fob_.private_key()));
+  OutboundMessage(header, response)
+      .Send(connection_manager_, connection_manager_.GetTarget(original_header.FromNode()));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(GetGroupKeyResponse get_group_key_response,
+                                       MessageHeader original_header) {
+  sentinel_.Add(std::move(original_header), MessageTypeTag::GetGroupKeyResponse,
+                Serialise(get_group_key_response));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(PutKey /* put_key */, MessageHeader /* original_header */) {}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(PutData put_data, MessageHeader original_header) {
+  PutDataResponse response(put_data.tag(), SerialisedData(), StoreData(put_data, original_header));
+  MessageHeader header(original_header.ReturnDestinationAddress(),
+                       OurSourceAddress(GroupAddress(original_header.Destination().first.data)),
+                       original_header.MessageId(), Authority::nae_manager);
+  OutboundMessage(header, response)
+      .Send(connection_manager_, connection_manager_.GetTarget(original_header.FromNode()));
+}
+
+template <typename Child>
+maidsafe_error RoutingNode<Child>::StoreData(const PutData& put_data,
+                                             const MessageHeader& header) {
+  if (!static_cast<Child*>(this)->HandlePut(header.Destination().first.data, put_data.data()))
+    return MakeError(CommonErrors::unable_to_handle_request);
+  return MakeError(CommonErrors::success);
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(PutDataResponse put_data_response,
+                                       MessageHeader original_header) {
+  CompleteRequest(original_header, ToErrorCode(put_data_response.error()), SerialisedMessage());
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(routing::Post post, MessageHeader original_header) {
+  PostResponse response(post.tag(), Identity(post.name()), SerialisedData());
+  if (!static_cast<Child*>(this)->HandlePost(post.data())) {
+    response = PostResponse(post.tag(), Identity(post.name()),
+                            MakeError(CommonErrors::unable_to_handle_request));
+  }
+  MessageHeader header(original_header.ReturnDestinationAddress(),
+                       OurSourceAddress(GroupAddress(original_header.Destination().first.data)),
+                       original_header.MessageId(), Authority::nae_manager);
+  OutboundMessage(header, response)
+      .Send(connection_manager_, connection_manager_.GetTarget(original_header.FromNode()));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(PostResponse post_response,
+                                       MessageHeader original_header) {
+  CompleteRequest(original_header,
+                  post_response.error() ? ToErrorCode(*post_response.error()) : asio::error_code(),
+                  post_response.take_data());
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(PutDataBatch put_data_batch, MessageHeader original_header) {
+  SendBatch<PutDataBatch, PutDataBatchResponse>(
+      put_data_batch.take_entries(), original_header,
+      [this, original_header](std::vector<BatchResult> results) {
+        std::vector<maidsafe_error> errors;
+        errors.reserve(results.size());
+        for (const auto& result : results) {
+          errors.push_back(result.error ? maidsafe_error(result.error)
+                                        : MakeError(CommonErrors::success));
+        }
+        PutDataBatchResponse response(std::move(errors));
+        MessageHeader header(original_header.ReturnDestinationAddress(), OurSourceAddress(),
+                             original_header.MessageId(), Authority::node);
+        OutboundMessage(header, response)
+            .Send(connection_manager_, std::vector<Address>(1, original_header.FromNode().data));
+      });
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(PutDataBatchResponse put_data_batch_response,
+                                       MessageHeader original_header) {
+  CompleteRequest(original_header, asio::error_code(), Serialise(put_data_batch_response));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(GetDataBatch get_data_batch, MessageHeader original_header) {
+  SendBatch<GetDataBatch, GetDataBatchResponse>(
+      get_data_batch.take_entries(), original_header,
+      [this, original_header](std::vector<BatchResult> results) {
+        std::vector<GetDataBatchResponse::Result> response_results(results.size());
+        for (size_t i(0); i < results.size(); ++i) {
+          if (results[i].error)
+            response_results[i].error = maidsafe_error(results[i].error);
+          else
+            response_results[i].data = std::move(results[i].data);
+        }
+        GetDataBatchResponse response(std::move(response_results));
+        MessageHeader header(original_header.ReturnDestinationAddress(), OurSourceAddress(),
+                             original_header.MessageId(), Authority::node);
+        OutboundMessage(header, response)
+            .Send(connection_manager_, std::vector<Address>(1, original_header.FromNode().data));
+      });
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(GetDataBatchResponse get_data_batch_response,
+                                       MessageHeader original_header) {
+  CompleteRequest(original_header, asio::error_code(), Serialise(get_data_batch_response));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(PutDataFragment put_data_fragment,
+                                       MessageHeader original_header) {
+  maidsafe_error error(MakeError(CommonErrors::success));
+  try {
+    auto payload(stream_reassembly_.Add(
+        ReassemblyBuffer::Key(original_header.FromAddress(), put_data_fragment.name()),
+        put_data_fragment.index(), put_data_fragment.count(), put_data_fragment.total_size(),
+        put_data_fragment.data()));
+    if (payload)
+      error = StoreData(PutData(put_data_fragment.tag(), std::move(*payload)), original_header);
+  } catch (const maidsafe_error& reassembly_error) {
+    error = reassembly_error;
+  }
+  PutDataResponse response(put_data_fragment.tag(), SerialisedData(), std::move(error));
+  MessageHeader header(original_header.ReturnDestinationAddress(),
+                       OurSourceAddress(GroupAddress(original_header.Destination().first.data)),
+                       original_header.MessageId(), Authority::nae_manager);
+  OutboundMessage(header, response)
+      .Send(connection_manager_, connection_manager_.GetTarget(original_header.FromNode()));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(GetDataFragment get_data_fragment,
+                                       MessageHeader original_header) {
+  auto response(ServeFragment(get_data_fragment, original_header));
+  MessageHeader header(original_header.ReturnDestinationAddress(),
+                       OurSourceAddress(GroupAddress(Address(get_data_fragment.name().string()))),
+                       original_header.MessageId(), Authority::nae_manager);
+  OutboundMessage(header, response)
+      .Send(connection_manager_, connection_manager_.GetTarget(original_header.FromNode()));
+}
+
+template <typename Child>
+void RoutingNode<Child>::HandleMessage(GetDataFragmentResponse get_data_fragment_response,
+                                       MessageHeader original_header) {
+  CompleteRequest(original_header, asio::error_code(), Serialise(get_data_fragment_response));
+}
 
 template <typename Child>
 SourceAddress RoutingNode<Child>::OurSourceAddress() const {
@@ -558,7 +1386,7 @@ SourceAddress RoutingNode<Child>::OurSourceAddress(GroupAddress group) const {
 //   MessageHeader header(DestinationAddress(std::make_pair(Destination(target), boost::none)),
 //                        SourceAddress{OurSourceAddress()}, ++message_id_);
 //
-//   rudp_.Send(target, Serialise(header, MessageToTag<Message>::value(), message), handler);
+//   rudp_.Send(target, Serialise(header, MessageToTag<Message>::value, message), handler);
 // }
 //
 // void RoutingNode::OnBootstrap(asio::error_code error, rudp::Contact contact,
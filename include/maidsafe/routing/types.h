@@ -28,12 +28,14 @@
 #include "boost/expected/expected.hpp"
 #include "boost/variant/variant.hpp"
 #include "asio/async_result.hpp"
+#include "asio/error_code.hpp"
 #include "asio/handler_type.hpp"
 #include "asio/ip/udp.hpp"
 
 #include "maidsafe/passport/types.h"
 #include "maidsafe/passport/passport.h"
 #include "maidsafe/common/node_id.h"
+#include "maidsafe/common/types.h"
 #include "maidsafe/common/data_types/data_type_values.h"
 #include "maidsafe/common/tagged_value.h"
 
@@ -91,6 +93,14 @@ using SerialisedMessage = std::vector<byte>;
 using Checksum = crypto::SHA1Hash;
 using CloseGroupDifference = std::pair<std::vector<Address>, std::vector<Address>>;
 
+// The outcome of one entry of a PutBatch or GetBatch.  |data| is only set for a GetBatch entry
+// which succeeded.
+struct BatchResult {
+  Identity name;
+  asio::error_code error;
+  SerialisedMessage data;
+};
+
 
 template <typename CompletionToken>
 using BootstrapHandlerHandler =
@@ -118,6 +128,15 @@ using GetHandler =
 template <typename CompletionToken>
 using GetReturn = typename asio::async_result<GetHandler<CompletionToken>>::type;
 
+// Called with one BatchResult per entry, in the order the entries were given.
+template <typename CompletionToken>
+using BatchHandler =
+    typename asio::handler_type<CompletionToken,
+                                void(asio::error_code, std::vector<BatchResult>)>::type;
+
+template <typename CompletionToken>
+using BatchReturn = typename asio::async_result<BatchHandler<CompletionToken>>::type;
+
 template <typename CompletionToken>
 using RequestHandler =
     typename asio::handler_type<CompletionToken, void(asio::error_code, SerialisedMessage)>::type;
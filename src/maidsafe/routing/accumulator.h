@@ -19,13 +19,12 @@
 #ifndef MAIDSAFE_ROUTING_ACCUMULATOR_H_
 #define MAIDSAFE_ROUTING_ACCUMULATOR_H_
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <limits>
-#include <list>
 #include <map>
-#include <tuple>
-#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -33,6 +32,8 @@
 
 #include "maidsafe/common/node_id.h"
 
+#include "maidsafe/routing/hash.h"
+#include "maidsafe/routing/timing_wheel.h"
 #include "maidsafe/routing/types.h"
 
 namespace maidsafe {
@@ -41,105 +42,276 @@ namespace routing {
 
 // Accumulate data parts with time_to_live LRU-replacement cache
 // requires sender id to ensure parts are delivered from different senders
-template <typename NameType, typename ValueType>
+//
+// Entries live in a node pool indexed by an open addressing (linear probing) hash table, and are
+// threaded onto an intrusive LRU list by pool index, so there is no per-name list node and no
+// duplicate copy of the name.  Add performs a single probe for a name already being accumulated.
+// Results are returned as views onto the stored entry; these are invalidated by the next call to
+// Add, so callers needing to keep the parts must copy them.
+//
+// Without a TimingWheel, expired entries are purged from the LRU front when a new name is added.
+// Given one, each entry is instead removed by its own timer when its time_to_live elapses.  The
+// number of names held can be bounded by |capacity|, the least recently used name being dropped.
+template <typename NameType, typename ValueType,
+          typename Hash = detail::Hasher<NameType>>
 class Accumulator {
  public:
+  using Map = std::map<NodeId, ValueType>;
+  using View = std::pair<const NameType&, const Map&>;
+
   Accumulator(std::chrono::steady_clock::duration time_to_live, uint32_t quorum)
-      : time_to_live_(time_to_live), quorum_(quorum) {}
+      : time_to_live_(time_to_live),
+        quorum_(quorum),
+        nodes_(),
+        free_(kNil),
+        index_(kInitialBuckets, kNil),
+        oldest_(kNil),
+        newest_(kNil),
+        size_(0),
+        hash_(),
+        capacity_(std::numeric_limits<size_t>::max()),
+        expiry_wheel_(nullptr) {}
+
+  // |expiry_wheel| may be null, in which case entries are purged as above.
+  Accumulator(std::chrono::steady_clock::duration time_to_live, uint32_t quorum, size_t capacity,
+              TimingWheel* expiry_wheel)
+      : Accumulator(time_to_live, quorum) {
+    capacity_ = std::max(capacity, size_t(1));
+    expiry_wheel_ = expiry_wheel;
+  }
+
+  ~Accumulator() {
+    if (!expiry_wheel_)
+      return;
+    for (auto node(oldest_); node != kNil; node = nodes_[node].newer)
+      expiry_wheel_->Cancel(nodes_[node].timer);
+  }
 
-  ~Accumulator() = default;
   Accumulator(const Accumulator&) = delete;
   Accumulator(Accumulator&&) = delete;
   Accumulator& operator=(const Accumulator&) = delete;
   Accumulator& operator=(Accumulator&&) = delete;
-  using Map = std::map<NodeId, ValueType>;
 
-  bool HaveName(NameType name) const { return (storage_.find(name) != std::end(storage_)); }
+  bool HaveName(const NameType& name) const {
+    return index_[Probe(name, hash_(name))] != kNil;
+  }
 
-  bool CheckQuorumReached(NameType name) const {
-    auto it = storage_.find(name);
-    if (it == std::end(storage_))
-      return false;
-    return (std::get<0>(it->second).size() >= quorum_);
+  bool CheckQuorumReached(const NameType& name) const {
+    const auto node(index_[Probe(name, hash_(name))]);
+    return node != kNil && nodes_[node].parts.size() >= quorum_;
   }
 
-  // returns true when the quorum has been reached. This will return Quorum times
-  // a tuple of valuetype which should be Source Address signature tag type and value
-  boost::optional<std::pair<NameType, Map>> Add(const NameType& name, ValueType value,
-                                                NodeId sender) {
-    auto it = storage_.find(name);
-    if (it == std::end(storage_)) {
-      AddNew(name, value, sender);
-      it = storage_.find(name);
+  // returns the parts once the quorum has been reached, and again for each later part. The view
+  // holds Source Address, signature, tag type and value per sender.
+  boost::optional<View> Add(const NameType& name, ValueType value, NodeId sender) {
+    if ((size_ + 1) * 4 > index_.size() * 3)
+      Rehash(index_.size() * 2);
+    const auto hash(hash_(name));
+    auto bucket(Probe(name, hash));
+    if (index_[bucket] == kNil) {
+      // removing entries to make room shifts the probe sequence
+      if (MakeRoom())
+        bucket = Probe(name, hash);
+      index_[bucket] = AddNew(name, hash);
     }
 
-    std::get<0>(it->second).insert(std::make_pair(std::move(sender), std::move(value)));
-    ReOrder(name);
-    if (std::get<0>(it->second).size() >= quorum_)
-      return std::make_pair(it->first, std::get<0>(it->second));
+    auto& node(nodes_[index_[bucket]]);
+    node.parts.insert(std::make_pair(std::move(sender), std::move(value)));
+    MoveToNewest(index_[bucket]);
+    if (node.parts.size() >= quorum_)
+      return View(node.name, node.parts);
     return boost::none;
   }
 
   // this is called when the return from Add returns a type that is incorrect
   // this means a node sent bad data, this method allows all parts to be collected
   // and we can attempt to identify the bad node.
-  boost::optional<std::pair<NameType, Map>> GetAll(const NameType& name) const {
-    auto it = storage_.find(name);
-    if (it == std::end(storage_))
+  boost::optional<View> GetAll(const NameType& name) const {
+    const auto node(index_[Probe(name, hash_(name))]);
+    if (node == kNil)
       return boost::none;
-    return std::make_pair(it->first, std::get<0>(it->second));
+    return View(nodes_[node].name, nodes_[node].parts);
   }
 
-  size_t size() const { return storage_.size(); }
+  size_t size() const { return size_; }
 
  private:
-  void AddNew(NameType name, ValueType value, NodeId sender) {
-    // check if we have entries with time expired
-    while (CheckTimeExpired())  // any old entries at beginning of the list
-      RemoveOldestElement();
+  static const uint32_t kNil = std::numeric_limits<uint32_t>::max();
+  static const size_t kInitialBuckets = 16;
 
-    // Record name as most-recently-used name
-    auto it = name_order_.insert(std::end(name_order_), name);
+  struct Node {
+    Node(NameType name_in, size_t hash_in)
+        : name(std::move(name_in)),
+          parts(),
+          added(std::chrono::steady_clock::now()),
+          hash(hash_in),
+          timer(0),
+          generation(0),
+          older(kNil),
+          newer(kNil) {}
 
-    // Create the name-value entry,
-    // linked to the usage record.
-    Map map;
-    map.insert(std::make_pair(sender, value));
-    storage_.insert(
-        std::make_pair(name, std::make_tuple(map, it, std::chrono::steady_clock::now())));
+    NameType name;
+    Map parts;
+    std::chrono::steady_clock::time_point added;
+    size_t hash;
+    TimingWheel::TimerId timer;
+    uint32_t generation;  // distinguishes reuses of the node, for timers already fired
+    uint32_t older, newer;  // LRU links, or next free node (in |newer|) when unused
+  };
+
+  // Returns the bucket holding |name|, or the empty bucket where it would be inserted.
+  size_t Probe(const NameType& name, size_t hash) const {
+    const size_t mask(index_.size() - 1);
+    for (size_t bucket(hash & mask);; bucket = (bucket + 1) & mask) {
+      const auto node(index_[bucket]);
+      if (node == kNil || (nodes_[node].hash == hash && nodes_[node].name == name))
+        return bucket;
+    }
   }
 
-  void RemoveOldestElement() {
-    assert(!name_order_.empty());
-    // Identify least recently used name
-    const auto it = storage_.find(name_order_.front());
-    assert(it != storage_.end());
-    // Erase both elements in both containers
-    storage_.erase(it);
-    name_order_.pop_front();
+  uint32_t AddNew(const NameType& name, size_t hash) {
+    uint32_t node(free_);
+    if (node == kNil) {
+      assert(nodes_.size() < kNil);
+      node = static_cast<uint32_t>(nodes_.size());
+      nodes_.emplace_back(name, hash);
+    } else {
+      free_ = nodes_[node].newer;
+      nodes_[node].name = name;
+      nodes_[node].added = std::chrono::steady_clock::now();
+      nodes_[node].hash = hash;
+      ++nodes_[node].generation;
+    }
+    nodes_[node].older = nodes_[node].newer = kNil;
+    LinkNewest(node);
+    ++size_;
+    if (expiry_wheel_ && time_to_live_ != std::chrono::steady_clock::duration::zero()) {
+      const auto generation(nodes_[node].generation);
+      nodes_[node].timer = expiry_wheel_->Schedule(time_to_live_, [this, node, generation] {
+        if (nodes_[node].generation == generation && nodes_[node].timer != 0) {
+          nodes_[node].timer = 0;
+          RemoveElement(node);
+        }
+      });
+    }
+    return node;
   }
 
-  bool CheckTimeExpired() const {
-    if (time_to_live_ == std::chrono::steady_clock::duration::zero() || storage_.empty())
+  // Returns true if any entries were removed.
+  bool MakeRoom() {
+    bool removed(RemoveExpired());
+    for (; size_ >= capacity_; removed = true)
+      RemoveOldestElement();
+    return removed;
+  }
+
+  // Removes any old entries at the beginning of the LRU list, unless the wheel expires them.
+  bool RemoveExpired() {
+    if (expiry_wheel_ || time_to_live_ == std::chrono::steady_clock::duration::zero())
       return false;
-    auto name = storage_.find(name_order_.front());
-    assert(name != std::end(storage_) && "cannot find element - should not happen");
-    return ((std::get<2>(name->second) + time_to_live_) < (std::chrono::steady_clock::now()));
+    const auto expired_before(std::chrono::steady_clock::now() - time_to_live_);
+    bool removed(false);
+    while (oldest_ != kNil && nodes_[oldest_].added < expired_before) {
+      RemoveOldestElement();
+      removed = true;
+    }
+    return removed;
+  }
+
+  void RemoveOldestElement() {
+    assert(oldest_ != kNil);
+    RemoveElement(oldest_);
+  }
+
+  void RemoveElement(uint32_t node) {
+    if (expiry_wheel_ && nodes_[node].timer != 0) {
+      expiry_wheel_->Cancel(nodes_[node].timer);
+      nodes_[node].timer = 0;
+    }
+    EraseFromIndex(node);
+    Unlink(node);
+    nodes_[node].parts.clear();
+    nodes_[node].newer = free_;
+    free_ = node;
+    --size_;
   }
 
-  void ReOrder(const NameType& name) {
-    const auto it = storage_.find(name);
-    assert(it != storage_.end());
-    name_order_.splice(name_order_.end(), name_order_, std::get<1>(it->second));
+  // Backward shift deletion, so no tombstones are needed.
+  void EraseFromIndex(uint32_t node) {
+    const size_t mask(index_.size() - 1);
+    size_t hole(nodes_[node].hash & mask);
+    while (index_[hole] != node)
+      hole = (hole + 1) & mask;
+    for (size_t next((hole + 1) & mask); index_[next] != kNil; next = (next + 1) & mask) {
+      const size_t home(nodes_[index_[next]].hash & mask);
+      // Move the entry back into the hole unless its home bucket lies cyclically in (hole, next].
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        index_[hole] = index_[next];
+        hole = next;
+      }
+    }
+    index_[hole] = kNil;
+  }
+
+  void Rehash(size_t bucket_count) {
+    std::vector<uint32_t> index(bucket_count, kNil);
+    const size_t mask(bucket_count - 1);
+    for (auto node(oldest_); node != kNil; node = nodes_[node].newer) {
+      size_t bucket(nodes_[node].hash & mask);
+      while (index[bucket] != kNil)
+        bucket = (bucket + 1) & mask;
+      index[bucket] = node;
+    }
+    index_.swap(index);
+  }
+
+  void LinkNewest(uint32_t node) {
+    nodes_[node].older = newest_;
+    nodes_[node].newer = kNil;
+    if (newest_ != kNil)
+      nodes_[newest_].newer = node;
+    else
+      oldest_ = node;
+    newest_ = node;
+  }
+
+  void Unlink(uint32_t node) {
+    auto& entry(nodes_[node]);
+    if (entry.older != kNil)
+      nodes_[entry.older].newer = entry.newer;
+    else
+      oldest_ = entry.newer;
+    if (entry.newer != kNil)
+      nodes_[entry.newer].older = entry.older;
+    else
+      newest_ = entry.older;
+  }
+
+  void MoveToNewest(uint32_t node) {
+    if (node == newest_)
+      return;
+    Unlink(node);
+    LinkNewest(node);
   }
 
   std::chrono::steady_clock::duration time_to_live_;
   uint32_t quorum_;
-  std::list<NameType> name_order_;
-  std::map<NameType, std::tuple<Map, typename std::list<NameType>::iterator,
-                                std::chrono::steady_clock::time_point>> storage_;
+  std::vector<Node> nodes_;
+  uint32_t free_;
+  std::vector<uint32_t> index_;  // power of two sized, kNil marks an empty bucket
+  uint32_t oldest_, newest_;
+  size_t size_;
+  Hash hash_;
+  size_t capacity_;
+  TimingWheel* expiry_wheel_;
 };
 
+template <typename NameType, typename ValueType, typename Hash>
+const uint32_t Accumulator<NameType, ValueType, Hash>::kNil;
+
+template <typename NameType, typename ValueType, typename Hash>
+const size_t Accumulator<NameType, ValueType, Hash>::kInitialBuckets;
+
 }  // namespace routing
 
 }  // namespace maidsafe
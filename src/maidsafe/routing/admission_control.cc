@@ -0,0 +1,132 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/admission_control.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+AdmissionPriority Prioritise(MessageTypeTag tag) {
+  switch (tag) {
+    case MessageTypeTag::GetData:
+    case MessageTypeTag::GetDataBatch:
+    case MessageTypeTag::GetDataFragment:
+      return AdmissionPriority::get;
+    case MessageTypeTag::Connect:
+    case MessageTypeTag::ConnectResponse:
+    case MessageTypeTag::FindGroup:
+    case MessageTypeTag::FindGroupResponse:
+    case MessageTypeTag::GetKey:
+    case MessageTypeTag::GetKeyResponse:
+    case MessageTypeTag::GetGroupKey:
+    case MessageTypeTag::GetGroupKeyResponse:
+    case MessageTypeTag::PutKey:
+      return AdmissionPriority::control;
+    default:
+      return AdmissionPriority::put;
+  }
+}
+
+AdmissionControl::AdmissionControl(AdmissionOptions options)
+    : options_(std::move(options)), mutex_(), peers_(), inflight_(0), counters_() {
+  if (options_.peer_messages_per_second <= 0.0 || options_.peer_message_burst < 1.0 ||
+      options_.peer_bytes_per_second <= 0.0 || options_.peer_byte_burst < 1.0 ||
+      options_.inflight_budget == 0 || options_.max_peers == 0) {
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+}
+
+bool AdmissionControl::Admit(const NodeId& peer_id, AdmissionPriority priority, uint64_t size,
+                             Clock::time_point now) {
+  const auto index(static_cast<size_t>(priority));
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found(peers_.find(peer_id));
+  if (found == std::end(peers_)) {
+    if (peers_.size() >= options_.max_peers)
+      ForgetIdlePeers(now);
+    found = peers_.insert(std::make_pair(peer_id, Buckets{options_.peer_message_burst,
+                                                          options_.peer_byte_burst, now})).first;
+  }
+  auto& buckets(found->second);
+  Refill(buckets, now);
+  if (buckets.messages < 1.0 || buckets.bytes < static_cast<double>(size)) {
+    ++counters_.shed_by_rate[index];
+    return false;
+  }
+  // Shed by budget before taking tokens, so that a peer isn't charged for work we refused.
+  const auto limit(static_cast<uint64_t>(options_.budget_shares[index] *
+                                         static_cast<double>(options_.inflight_budget)));
+  if (inflight_ + size > limit) {
+    ++counters_.shed_by_budget[index];
+    return false;
+  }
+  buckets.messages -= 1.0;
+  buckets.bytes -= static_cast<double>(size);
+  inflight_ += size;
+  ++counters_.admitted[index];
+  return true;
+}
+
+void AdmissionControl::Release(uint64_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  inflight_ -= std::min(size, inflight_);
+}
+
+uint64_t AdmissionControl::Inflight() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return inflight_;
+}
+
+AdmissionCounters AdmissionControl::Counters() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return counters_;
+}
+
+void AdmissionControl::Refill(Buckets& buckets, Clock::time_point now) const {
+  if (now <= buckets.updated)
+    return;
+  const double seconds(std::chrono::duration<double>(now - buckets.updated).count());
+  buckets.messages = std::min(options_.peer_message_burst,
+                              buckets.messages + seconds * options_.peer_messages_per_second);
+  buckets.bytes =
+      std::min(options_.peer_byte_burst, buckets.bytes + seconds * options_.peer_bytes_per_second);
+  buckets.updated = now;
+}
+
+void AdmissionControl::ForgetIdlePeers(Clock::time_point now) {
+  // A peer whose buckets would have refilled is indistinguishable from a new one.
+  for (auto itr(std::begin(peers_)); itr != std::end(peers_);) {
+    Refill(itr->second, now);
+    if (itr->second.messages >= options_.peer_message_burst &&
+        itr->second.bytes >= options_.peer_byte_burst) {
+      itr = peers_.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
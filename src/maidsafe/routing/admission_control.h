@@ -0,0 +1,116 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_ADMISSION_CONTROL_H_
+#define MAIDSAFE_ROUTING_ADMISSION_CONTROL_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include "maidsafe/common/node_id.h"
+
+#include "maidsafe/routing/hash.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// In the order traffic is shed: GetData which a cache elsewhere may answer goes first, then other
+// data (Puts, Posts and responses), and control and key traffic last.
+enum class AdmissionPriority : uint8_t { get, put, control };
+
+AdmissionPriority Prioritise(MessageTypeTag tag);
+
+struct AdmissionOptions {
+  AdmissionOptions()
+      : peer_messages_per_second(2000),
+        peer_message_burst(4000),
+        peer_bytes_per_second(32 * 1024 * 1024),
+        peer_byte_burst(64 * 1024 * 1024),
+        inflight_budget(256 * 1024 * 1024),
+        budget_shares{{0.7, 0.9, 1.0}},
+        max_peers(4096) {}
+
+  // Token buckets per peer, refilled continuously.  The byte burst must be at least the largest
+  // message.
+  double peer_messages_per_second, peer_message_burst;
+  double peer_bytes_per_second, peer_byte_burst;
+  // Bytes of admitted messages not yet released, across all peers.
+  uint64_t inflight_budget;
+  // Indexed by AdmissionPriority: the fraction of |inflight_budget| up to which each priority is
+  // still admitted, so the lower priorities are shed as the budget fills.
+  std::array<double, 3> budget_shares;
+  // Peers idle long enough for their buckets to refill are forgotten beyond this many.
+  size_t max_peers;
+};
+
+struct AdmissionCounters {
+  AdmissionCounters() : admitted(), shed_by_rate(), shed_by_budget() {}
+  // Indexed by AdmissionPriority.
+  std::array<uint64_t, 3> admitted, shed_by_rate, shed_by_budget;
+};
+
+// Decides whether to take on a received message before any work is done for it.  Each peer may
+// only send at its token buckets' rates (messages and bytes), and the bytes of all admitted
+// messages until they're released (i.e. handled) are limited to a global budget, within which the
+// lower priorities are shed first.  Thread-safe.
+class AdmissionControl {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit AdmissionControl(AdmissionOptions options = AdmissionOptions());
+  AdmissionControl(const AdmissionControl&) = delete;
+  AdmissionControl(AdmissionControl&&) = delete;
+  ~AdmissionControl() = default;
+  AdmissionControl& operator=(const AdmissionControl&) = delete;
+  AdmissionControl& operator=(AdmissionControl&&) = delete;
+
+  // Returns true if the message is admitted, in which case Release(|size|) must be called once it
+  // has been handled or dropped.
+  bool Admit(const NodeId& peer_id, AdmissionPriority priority, uint64_t size,
+             Clock::time_point now = Clock::now());
+  void Release(uint64_t size);
+
+  uint64_t Inflight() const;
+  AdmissionCounters Counters() const;
+
+ private:
+  struct Buckets {
+    double messages, bytes;
+    Clock::time_point updated;
+  };
+
+  void Refill(Buckets& buckets, Clock::time_point now) const;
+  void ForgetIdlePeers(Clock::time_point now);
+
+  const AdmissionOptions options_;
+  mutable std::mutex mutex_;
+  std::unordered_map<NodeId, Buckets, detail::Hasher<NodeId>> peers_;
+  uint64_t inflight_;
+  AdmissionCounters counters_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_ADMISSION_CONTROL_H_
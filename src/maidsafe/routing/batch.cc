@@ -0,0 +1,66 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/batch.h"
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+BatchCollector::BatchCollector(std::vector<Identity> names, Done done)
+    : mutex_(), results_(), parts_(1), done_(std::move(done)) {
+  results_.reserve(names.size());
+  for (auto& name : names)
+    results_.push_back(BatchResult{std::move(name),
+                                   make_error_code(CommonErrors::unable_to_handle_request),
+                                   SerialisedMessage()});
+}
+
+void BatchCollector::Set(size_t index, asio::error_code error, SerialisedMessage data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  results_.at(index).error = error;
+  results_.at(index).data = std::move(data);
+}
+
+void BatchCollector::SetAll(const std::vector<size_t>& indices, asio::error_code error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto index : indices)
+    results_.at(index).error = error;
+}
+
+void BatchCollector::AddPart() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++parts_;
+}
+
+void BatchCollector::PartDone() {
+  std::vector<BatchResult> results;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (parts_ == 0 || --parts_ != 0)
+      return;
+    results.swap(results_);
+  }
+  done_(std::move(results));
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
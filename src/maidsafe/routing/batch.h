@@ -0,0 +1,120 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_BATCH_H_
+#define MAIDSAFE_ROUTING_BATCH_H_
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asio/error_code.hpp"
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/routing/hash.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Upper limit on the entries in one PutDataBatch or GetDataBatch message, so that a batch stays a
+// reasonable size to hold, parse and retransmit.
+static const size_t kMaxBatchEntries = 256;
+
+// How the entries of a batch are to be handled, as indices into the batch's entries.
+struct BatchPlan {
+  // Entries for which this node is in the destination close group, i.e. where the batch splits.
+  std::vector<size_t> local;
+  // The other entries grouped by next hop, in groups of at most the maximum batch size.
+  std::vector<std::pair<Address, std::vector<size_t>>> remote;
+  // Entries with no next hop.
+  std::vector<size_t> unroutable;
+};
+
+// Each entry's destination is the group close to its name.  |is_local| should return true if this
+// node is in that group, otherwise |next_hop| should return the node to send the entry on to (or
+// boost::none if there is none).
+template <typename Entries, typename IsLocal, typename NextHop>
+BatchPlan PlanBatch(const Entries& entries, IsLocal is_local, NextHop next_hop,
+                    size_t max_entries = kMaxBatchEntries) {
+  BatchPlan plan;
+  std::unordered_map<Address, std::vector<size_t>, detail::Hasher<Address>> by_next_hop;
+  for (size_t i(0); i < entries.size(); ++i) {
+    const Address name(entries[i].name.string());
+    if (is_local(name)) {
+      plan.local.push_back(i);
+      continue;
+    }
+    const boost::optional<Address> hop(next_hop(name));
+    if (!hop) {
+      plan.unroutable.push_back(i);
+      continue;
+    }
+    auto& group(by_next_hop[*hop]);
+    group.push_back(i);
+    if (group.size() == max_entries) {
+      plan.remote.emplace_back(*hop, std::move(group));
+      group.clear();
+    }
+  }
+  for (auto& group : by_next_hop) {
+    if (!group.second.empty())
+      plan.remote.emplace_back(group.first, std::move(group.second));
+  }
+  return plan;
+}
+
+// Gathers the results of a batch whose entries are handled in parts (locally and by each next
+// hop), and calls |done| with them once every part has finished.  The collector starts with one
+// part, which is finished by the caller once it has added (with AddPart) all the others.  An entry
+// only succeeds once set to; any left unset is reported as unable_to_handle_request.
+// Thread-safe.
+class BatchCollector {
+ public:
+  using Done = std::function<void(std::vector<BatchResult>)>;
+
+  BatchCollector(std::vector<Identity> names, Done done);
+  BatchCollector(const BatchCollector&) = delete;
+  BatchCollector(BatchCollector&&) = delete;
+  ~BatchCollector() = default;
+  BatchCollector& operator=(const BatchCollector&) = delete;
+  BatchCollector& operator=(BatchCollector&&) = delete;
+
+  void Set(size_t index, asio::error_code error, SerialisedMessage data = SerialisedMessage());
+  void SetAll(const std::vector<size_t>& indices, asio::error_code error);
+  void AddPart();
+  void PartDone();
+
+ private:
+  std::mutex mutex_;
+  std::vector<BatchResult> results_;
+  size_t parts_;
+  Done done_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_BATCH_H_
@@ -19,6 +19,8 @@
 #include "maidsafe/routing/client.h"
 
 #include <chrono>
+#include <functional>
+#include <memory>
 
 #include "asio/use_future.hpp"
 
@@ -26,6 +28,7 @@
 #include "maidsafe/common/serialisation/binary_archive.h"
 #include "maidsafe/common/serialisation/serialisation.h"
 
+#include "maidsafe/routing/message_dispatch.h"
 #include "maidsafe/routing/utils.h"
 #include "maidsafe/routing/messages/messages.h"
 
@@ -41,9 +44,11 @@ Client::Client(asio::io_service& io_service, Identity our_id, asymm::Keys our_ke
       message_id_(RandomUint32()),
       bootstrap_node_(),
       bootstrap_handler_(),
-      connected_peers_(),
+      expiry_wheel_(),
+      connections_(expiry_wheel_, our_id_),
       filter_(std::chrono::minutes(20)),
-      sentinel_(io_service) {}
+      sentinel_(io_service),
+      expiry_driver_(crux_asio_service_.service(), expiry_wheel_) {}
 
 Client::Client(asio::io_service& io_service, const passport::Maid& maid)
     : crux_asio_service_(1),
@@ -58,9 +63,11 @@ Client::Client(asio::io_service& io_service, const passport::Maid& maid)
       message_id_(RandomUint32()),
       bootstrap_node_(),
       bootstrap_handler_(),
-      connected_peers_(),
+      expiry_wheel_(),
+      connections_(expiry_wheel_, our_id_),
       filter_(std::chrono::minutes(20)),
-      sentinel_(io_service) {}
+      sentinel_(io_service),
+      expiry_driver_(crux_asio_service_.service(), expiry_wheel_) {}
 
 Client::Client(asio::io_service& io_service, const passport::Mpid& mpid)
     : crux_asio_service_(1),
@@ -75,9 +82,39 @@ Client::Client(asio::io_service& io_service, const passport::Mpid& mpid)
       message_id_(RandomUint32()),
       bootstrap_node_(),
       bootstrap_handler_(),
-      connected_peers_(),
+      expiry_wheel_(),
+      connections_(expiry_wheel_, our_id_),
       filter_(std::chrono::minutes(20)),
-      sentinel_(io_service) {}
+      sentinel_(io_service),
+      expiry_driver_(crux_asio_service_.service(), expiry_wheel_) {}
+
+bool Client::AddConnection(PeerNode peer) {
+  const Address peer_id(peer.id());
+  auto shared_peer(std::make_shared<PeerNode>(std::move(peer)));
+  if (!connections_.Add(peer_id, [shared_peer](ClientConnectionPool::Message message,
+                                               std::function<void(asio::error_code)> on_sent) {
+        shared_peer->Send(message, on_sent);
+      })) {
+    return false;
+  }
+  if (!bootstrap_node_)
+    bootstrap_node_ = peer_id;
+  StartReceiving(shared_peer);
+  return true;
+}
+
+void Client::StartReceiving(std::shared_ptr<PeerNode> peer) {
+  std::weak_ptr<Client> weak_this(shared_from_this());
+  peer->Receive([weak_this, peer](asio::error_code error, const SerialisedMessage& bytes) {
+    auto this_ptr(weak_this.lock());
+    if (!this_ptr)
+      return;
+    if (error)
+      return this_ptr->ConnectionLost(peer->id());
+    this_ptr->MessageReceived(peer->id(), bytes);
+    this_ptr->StartReceiving(peer);
+  });
+}
 
 void Client::MessageReceived(const Address& /*peer_id*/, SerialisedMessage message) {
   InputVectorStream binary_input_stream(std::move(message));
@@ -96,49 +133,68 @@ void Client::MessageReceived(const Address& /*peer_id*/, SerialisedMessage messa
   // add to filter as soon as posible
   filter_.Add(header.FilterValue());
 
-  switch (tag) {
-    case MessageTypeTag::ConnectResponse:
-      HandleMessage(Parse<ConnectResponse>(binary_input_stream));
-      break;
-    case MessageTypeTag::GetDataResponse:
-      HandleMessage(Parse<GetDataResponse>(binary_input_stream));
-      break;
-    // case MessageTypeTag::PutDataResponse:
-    //   HandleMessage(
-    //       Parse<PutDataResponse>(binary_input_stream));
-    //   break;
-    // case MessageTypeTag::Post:
-    //   HandleMessage(Parse<Post>(binary_input_stream));
-    //   break;
-    // case MessageTypeTag::Request:
-    //   HandleMessage(Parse<Request>(binary_input_stream));
-    //   break;
-    // case MessageTypeTag::Response:
-    //   HandleMessage(Parse<MessageTypeTag::Response>(binary_input_stream));
-    //   break;
-    default:
-      LOG(kWarning) << "Received message of unknown type.";
-      break;
+  try {
+    MessageDispatcher<Client>::Dispatch(*this, tag, binary_input_stream, std::move(header));
+  }
+  catch (const std::exception&) {
+    LOG(kError) << "message failure: " << boost::current_exception_diagnostic_information();
   }
 }
 
-void Client::HandleMessage(ConnectResponse&& /*connect_response*/) {
+void Client::HandleMessage(ConnectResponse&& /*connect_response*/, MessageHeader&& /*header*/) {
 }
 
-void Client::HandleMessage(GetDataResponse&& /*get_data_response*/) {
+void Client::HandleMessage(GetDataResponse&& get_data_response, MessageHeader&& header) {
+  asio::error_code error;
+  SerialisedMessage data;
+  if (get_data_response.error())
+    error = ToErrorCode(*get_data_response.error());
+  else if (get_data_response.data())
+    data = *get_data_response.take_data();
+  else
+    return;
+  // Responses are relayed to us with the message id of our request, whichever connection it
+  // went out on.
+  if (!connections_.Complete(header.MessageId(), error, std::move(data)))
+    LOG(kVerbose) << "Response matches no outstanding request.";
 }
 
-void Client::HandleMessage(routing::Post&& /*post*/) {
+void Client::HandleMessage(PutDataResponse&& put_data_response, MessageHeader&& header) {
+  const asio::error_code error(ToErrorCode(put_data_response.error()));
+  if (!connections_.Complete(header.MessageId(), error, SerialisedMessage()))
+    LOG(kVerbose) << "Response matches no outstanding request.";
 }
 
-void Client::HandleMessage(PostResponse&& /*post_response*/) {
+void Client::HandleMessage(routing::Post&& /*post*/, MessageHeader&& /*header*/) {
 }
 
-// void ConnectionLost(NodeId /* peer */) { /*LostNetworkConnection(peer);*/ }
+void Client::HandleMessage(PostResponse&& post_response, MessageHeader&& header) {
+  const asio::error_code error(post_response.error() ? ToErrorCode(*post_response.error())
+                                                     : asio::error_code());
+  if (!connections_.Complete(header.MessageId(), error, post_response.take_data()))
+    LOG(kVerbose) << "Response matches no outstanding request.";
+}
+
+void Client::ConnectionLost(const Address& peer_id) {
+  // Requests outstanding on the connection are sent again via the others.
+  if (!connections_.Remove(peer_id))
+    return;
+  if (bootstrap_node_ && *bootstrap_node_ == peer_id) {
+    const auto remaining(connections_.Connections());
+    if (remaining.empty())
+      bootstrap_node_ = boost::none;
+    else
+      bootstrap_node_ = remaining.front();
+  }
+}
 
 SourceAddress Client::OurSourceAddress() const {
   assert(bootstrap_node_);
-  return SourceAddress(NodeAddress(*bootstrap_node_), boost::none, ReplyToAddress(OurId()));
+  return OurSourceAddress(*bootstrap_node_);
+}
+
+SourceAddress Client::OurSourceAddress(const Address& relay) const {
+  return SourceAddress(NodeAddress(relay), boost::none, ReplyToAddress(OurId()));
 }
 
 }  // namespace routing
@@ -0,0 +1,195 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/client_connection_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "asio/error.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+const size_t ClientConnectionPool::kDefaultMaxConnections = 4;
+
+ClientConnectionPool::ClientConnectionPool(TimingWheel& timeout_wheel, Address our_id,
+                                           size_t max_connections)
+    : our_id_(std::move(our_id)),
+      max_connections_(max_connections),
+      mutex_(),
+      connections_(),
+      requests_(),
+      failed_over_(0),
+      responses_(timeout_wheel) {
+  if (max_connections_ == 0)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+}
+
+bool ClientConnectionPool::Add(Address node, Sender sender) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (connections_.size() == max_connections_ || Find(node))
+    return false;
+  connections_.push_back(Connection{std::move(node), std::move(sender), 0});
+  return true;
+}
+
+bool ClientConnectionPool::Remove(const Address& node) {
+  std::vector<PendingSend> sends;
+  std::vector<MessageId> unreachable;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found(std::find_if(std::begin(connections_), std::end(connections_),
+                                  [&](const Connection& connection) {
+                                    return connection.node == node;
+                                  }));
+    if (found == std::end(connections_))
+      return false;
+    connections_.erase(found);
+    for (auto& request : requests_) {
+      if (request.second.connection != node)
+        continue;
+      Connection* const connection(LeastLoaded());
+      if (!connection) {
+        unreachable.push_back(request.first);
+        continue;
+      }
+      ++connection->outstanding;
+      request.second.connection = connection->node;
+      sends.push_back(
+          PendingSend{request.first, request.second.builder, connection->node, connection->sender});
+      ++failed_over_;
+    }
+    for (const auto message_id : unreachable)
+      requests_.erase(message_id);
+  }
+  LOG(kInfo) << "Lost a connection, failing over " << sends.size() << " requests and failing "
+             << unreachable.size();
+  for (auto& send : sends)
+    Start(std::move(send));
+  for (const auto message_id : unreachable) {
+    responses_.Complete(ResponseTable::Key(our_id_, message_id), asio::error::network_unreachable,
+                        SerialisedMessage());
+  }
+  return true;
+}
+
+void ClientConnectionPool::Send(MessageId message_id, Builder builder, Handler handler,
+                                std::chrono::steady_clock::duration timeout) {
+  asio::error_code error(asio::error::already_started);
+  PendingSend send{message_id, std::move(builder), Address(), Sender()};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (requests_.count(message_id) == 0) {
+      if (Connection* const connection = LeastLoaded()) {
+        ++connection->outstanding;
+        send.connection = connection->node;
+        send.sender = connection->sender;
+        requests_.insert(std::make_pair(message_id, Request{send.builder, send.connection}));
+        error = asio::error_code();
+      } else {
+        error = asio::error::network_unreachable;
+      }
+    }
+  }
+  if (error)
+    return handler(error, SerialisedMessage());
+
+  responses_.Add(ResponseTable::Key(our_id_, message_id),
+                 [this, message_id, handler](asio::error_code error, SerialisedMessage response) {
+                   Forget(message_id);
+                   handler(error, std::move(response));
+                 },
+                 timeout);
+  Start(std::move(send));
+}
+
+bool ClientConnectionPool::Complete(MessageId message_id, asio::error_code error,
+                                    SerialisedMessage response) {
+  return responses_.Complete(ResponseTable::Key(our_id_, message_id), error, std::move(response));
+}
+
+std::vector<Address> ClientConnectionPool::Connections() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Address> nodes;
+  for (const auto& connection : connections_)
+    nodes.push_back(connection.node);
+  return nodes;
+}
+
+size_t ClientConnectionPool::Outstanding() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return requests_.size();
+}
+
+size_t ClientConnectionPool::Outstanding(const Address& node) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found(std::find_if(
+      std::begin(connections_), std::end(connections_),
+      [&](const Connection& connection) { return connection.node == node; }));
+  return found == std::end(connections_) ? 0 : found->outstanding;
+}
+
+uint64_t ClientConnectionPool::FailedOver() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return failed_over_;
+}
+
+ClientConnectionPool::Connection* ClientConnectionPool::LeastLoaded() {
+  const auto found(std::min_element(std::begin(connections_), std::end(connections_),
+                                    [](const Connection& lhs, const Connection& rhs) {
+                                      return lhs.outstanding < rhs.outstanding;
+                                    }));
+  return found == std::end(connections_) ? nullptr : &*found;
+}
+
+ClientConnectionPool::Connection* ClientConnectionPool::Find(const Address& node) {
+  for (auto& connection : connections_) {
+    if (connection.node == node)
+      return &connection;
+  }
+  return nullptr;
+}
+
+void ClientConnectionPool::Start(PendingSend send) {
+  const Address connection(send.connection);
+  send.sender(send.builder(connection), [this, connection](asio::error_code error) {
+    if (!error)
+      return;
+    LOG(kWarning) << "Send failed, dropping connection: " << error.message();
+    Remove(connection);
+  });
+}
+
+void ClientConnectionPool::Forget(MessageId message_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found(requests_.find(message_id));
+  if (found == std::end(requests_))
+    return;
+  if (Connection* const connection = Find(found->second.connection))
+    --connection->outstanding;
+  requests_.erase(found);
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
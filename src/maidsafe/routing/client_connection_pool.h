@@ -0,0 +1,124 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_CLIENT_CONNECTION_POOL_H_
+#define MAIDSAFE_ROUTING_CLIENT_CONNECTION_POOL_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "asio/error_code.hpp"
+
+#include "maidsafe/routing/response_table.h"
+#include "maidsafe/routing/timing_wheel.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// A client's connections to a few nodes of its close group, over which all of its requests are
+// multiplexed.  Requests are matched to their responses by message id, so any number may be
+// outstanding on one connection.  Each is sent on the connection with the fewest outstanding;
+// when a connection is lost (or a send on it fails) the requests outstanding on it are sent again
+// on those remaining, and only fail, with asio::error::network_unreachable, once there are none.
+// The relay node is part of a request's header, so each send builds the message for the
+// connection it goes out on.  Senders, builders and handlers are never invoked with the pool's
+// lock held.  Thread-safe.
+class ClientConnectionPool {
+ public:
+  using Message = std::shared_ptr<const SerialisedMessage>;
+  // Sends |message| on one connection; the callback is given the result of the send.
+  using Sender = std::function<void(Message message, std::function<void(asio::error_code)>)>;
+  // Builds the request to be relayed by |connection|.
+  using Builder = std::function<Message(const Address& connection)>;
+  using Handler = ResponseTable::Handler;
+  static const size_t kDefaultMaxConnections;
+
+  ClientConnectionPool(TimingWheel& timeout_wheel, Address our_id,
+                       size_t max_connections = kDefaultMaxConnections);
+  ClientConnectionPool(const ClientConnectionPool&) = delete;
+  ClientConnectionPool(ClientConnectionPool&&) = delete;
+  ~ClientConnectionPool() = default;
+  ClientConnectionPool& operator=(const ClientConnectionPool&) = delete;
+  ClientConnectionPool& operator=(ClientConnectionPool&&) = delete;
+
+  // Returns false if |node| is already in the pool or the pool is full.
+  bool Add(Address node, Sender sender);
+  // Fails the requests outstanding on |node| over to the remaining connections.  Returns false if
+  // |node| isn't in the pool.
+  bool Remove(const Address& node);
+  // Sends request |message_id| on the least loaded connection.  |handler| is completed once, by
+  // Complete, on timeout, or with asio::error::already_started if |message_id| is outstanding.
+  void Send(MessageId message_id, Builder builder, Handler handler,
+            std::chrono::steady_clock::duration timeout = ResponseTable::kDefaultTimeout);
+  // Returns false if no request is outstanding for |message_id|.
+  bool Complete(MessageId message_id, asio::error_code error, SerialisedMessage response);
+
+  std::vector<Address> Connections() const;
+  // Requests outstanding, in total and on |node|.
+  size_t Outstanding() const;
+  size_t Outstanding(const Address& node) const;
+  // Sends of requests which were outstanding on a lost connection.
+  uint64_t FailedOver() const;
+
+ private:
+  struct Connection {
+    Address node;
+    Sender sender;
+    size_t outstanding;
+  };
+
+  struct Request {
+    Builder builder;
+    Address connection;
+  };
+
+  struct PendingSend {
+    MessageId message_id;
+    Builder builder;
+    Address connection;
+    Sender sender;
+  };
+
+  // Must be called with |mutex_| held.  Returns nullptr if there are no connections.
+  Connection* LeastLoaded();
+  Connection* Find(const Address& node);
+  void Start(PendingSend send);
+  void Forget(MessageId message_id);
+
+  const Address our_id_;
+  const size_t max_connections_;
+  mutable std::mutex mutex_;
+  std::vector<Connection> connections_;
+  std::unordered_map<MessageId, Request> requests_;
+  uint64_t failed_over_;
+  // Declared last so that any handlers it cancels on destruction find the pool intact.
+  ResponseTable responses_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_CLIENT_CONNECTION_POOL_H_
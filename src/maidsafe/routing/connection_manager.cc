@@ -28,6 +28,7 @@
 #include "boost/asio/spawn.hpp"
 
 #include "maidsafe/common/convert.h"
+#include "maidsafe/common/log.h"
 
 #include "maidsafe/routing/peer_node.h"
 #include "maidsafe/routing/routing_table.h"
@@ -50,6 +51,8 @@ ConnectionManager::ConnectionManager(boost::asio::io_service& ios, PublicPmid ou
       our_id_(our_fob_.name()->string()),
       peers_(Comparison(our_id_)),
       current_close_group_(),
+      close_group_version_(0),
+      draining_(false),
       destroy_indicator_(new boost::none_t()) {}
 
 bool ConnectionManager::IsManaged(const Address& node_id) const {
@@ -59,17 +62,69 @@ bool ConnectionManager::IsManaged(const Address& node_id) const {
 
 std::set<Address, ConnectionManager::Comparison> ConnectionManager::GetTarget(
     const Address& target_node) const {
-  // TODO(PeterJ): The previous code was quite more complicated, so recheck correctness of this one.
-  return std::set<Address, Comparison>(Comparison(target_node));
-  // for (const auto& peer : peers_) {
-  //  result.insert(peer.first);
-  //}
-  // return result;
-  // auto nodes(routing_table_.TargetNodes(target_node));
-  ////nodes.erase(std::remove_if(std::begin(nodes), std::end(nodes),
-  ////                           [](NodeInfo& node) { return !node.connected(); }),
-  ////            std::end(nodes));
-  // return nodes;
+  // As RoutingTable::TargetNodes: our close group if the peer closest to the target is in it,
+  // otherwise the RoutingTable::Parallelism() peers closest to the target.
+  std::set<Address, Comparison> result{Comparison(target_node)};
+  if (peers_.empty())
+    return result;
+  std::vector<Address> closest_to_target;
+  closest_to_target.reserve(peers_.size());
+  for (const auto& peer : peers_)
+    closest_to_target.push_back(peer.first);
+  const auto parallelism(std::min(RoutingTable::Parallelism(), closest_to_target.size()));
+  std::partial_sort(std::begin(closest_to_target), std::begin(closest_to_target) + parallelism,
+                    std::end(closest_to_target), Comparison(target_node));
+
+  // |peers_| is ordered by closeness to us, so our close group is its first GroupSize entries.
+  const auto closest_index(
+      std::distance(std::begin(peers_), peers_.find(closest_to_target.front())));
+  if (static_cast<size_t>(closest_index) < GroupSize) {
+    size_t count(0);
+    for (auto itr(std::begin(peers_)); itr != std::end(peers_) && count < GroupSize;
+         ++itr, ++count) {
+      result.insert(itr->first);
+    }
+  } else {
+    result.insert(std::begin(closest_to_target), std::begin(closest_to_target) + parallelism);
+  }
+  return result;
+}
+
+std::vector<PublicPmid> ConnectionManager::CloseGroupOf(const Address& target) const {
+  std::vector<std::pair<Address, const PublicPmid*>> nodes;
+  nodes.reserve(peers_.size() + 1);
+  nodes.emplace_back(our_id_, &our_fob_);
+  for (const auto& peer : peers_)
+    nodes.emplace_back(peer.first, &peer.second.node_info().dht_fob);
+  const auto size(std::min(GroupSize, nodes.size()));
+  const Comparison closer_to_target(target);
+  std::partial_sort(std::begin(nodes), std::begin(nodes) + size, std::end(nodes),
+                    [&](const std::pair<Address, const PublicPmid*>& lhs,
+                        const std::pair<Address, const PublicPmid*>& rhs) {
+                      return closer_to_target(lhs.first, rhs.first);
+                    });
+  std::vector<PublicPmid> result;
+  result.reserve(size);
+  for (size_t i(0); i < size; ++i)
+    result.push_back(*nodes[i].second);
+  return result;
+}
+
+bool ConnectionManager::CouldBeCloseGroupOf(const Address& target,
+                                            const std::vector<Address>& members) const {
+  if (members.empty())
+    return false;
+  const auto left_out = [&](const Address& node) {
+    return Address::CloserToTarget(node, members.back(), target) &&
+           std::find(std::begin(members), std::end(members), node) == std::end(members);
+  };
+  if (left_out(our_id_))
+    return false;
+  for (const auto& peer : peers_) {
+    if (left_out(peer.first))
+      return false;
+  }
+  return true;
 }
 
 // boost::optional<CloseGroupDifference> ConnectionManager::LostNetworkConnection(
@@ -78,14 +133,59 @@ std::set<Address, ConnectionManager::Comparison> ConnectionManager::GetTarget(
 //  return GroupChanged();
 //}
 
+void ConnectionManager::Drain(std::chrono::steady_clock::duration timeout,
+                              std::function<void(size_t)> handler) {
+  draining_ = true;
+  acceptors_.clear();
+  being_connected_.clear();
+  ContinueDrain(make_shared<boost::asio::steady_timer>(io_service_),
+                std::chrono::steady_clock::now() + timeout, move(handler));
+}
+
+size_t ConnectionManager::SendsInFlight() const {
+  size_t in_flight(0);
+  for (const auto& peer : peers_)
+    in_flight += peer.second.SendsInFlight();
+  return in_flight;
+}
+
+void ConnectionManager::ContinueDrain(std::shared_ptr<boost::asio::steady_timer> timer,
+                                      std::chrono::steady_clock::time_point deadline,
+                                      std::function<void(size_t)> handler) {
+  // Polled, as the sends' own handlers belong to their callers.
+  static const std::chrono::steady_clock::duration kPollInterval(std::chrono::milliseconds(5));
+  const auto in_flight(SendsInFlight());
+  const auto now(std::chrono::steady_clock::now());
+  if (in_flight == 0 || now >= deadline) {
+    Shutdown();
+    if (handler)
+      handler(in_flight);
+    return;
+  }
+  timer->expires_from_now(std::min(kPollInterval, deadline - now));
+  weak_ptr<none_t> destroy_guard = destroy_indicator_;
+  timer->async_wait([=](boost::system::error_code) {
+    if (!destroy_guard.lock())
+      return;
+    ContinueDrain(timer, deadline, handler);
+  });
+}
+
 optional<CloseGroupDifference> ConnectionManager::DropNode(const Address& their_id) {
   // routing_table_.DropNode(their_id);
-  peers_.erase(their_id);
-  return GroupChanged();
+  if (peers_.erase(their_id) == 0)
+    return boost::none;
+  auto changed(GroupChanged());
+  if (on_connection_lost_)
+    on_connection_lost_(their_id);
+  return changed;
 }
 
 // acceptor_(io_service_, crux::endpoint(boost::asio::ip::udp::v4(), 5483)),
 void ConnectionManager::StartAccepting(unsigned short port) {
+  if (draining_)
+    return;
+
   auto acceptor_i = acceptors_.find(port);
 
   if (acceptor_i == acceptors_.end()) {
@@ -135,6 +235,9 @@ void ConnectionManager::StartAccepting(unsigned short port) {
 void ConnectionManager::AddNode(optional<NodeInfo> assumed_node_info, EndpointPair eps) {
   static const crux::endpoint unspecified_ep(boost::asio::ip::udp::v4(), 0);
 
+  if (draining_)
+    return;
+
   // TODO(PeterJ): Try the internal endpoint as well
   auto endpoint = convert::ToBoost(eps.external);
 
@@ -188,6 +291,10 @@ void ConnectionManager::AddNode(optional<NodeInfo> assumed_node_info, EndpointPa
 }
 
 void ConnectionManager::InsertPeer(PeerNode&& node_arg) {
+  // A connection completing while we drain is dropped with |node_arg|.
+  if (draining_)
+    return;
+
   const auto& id = node_arg.id();
   const auto pair = peers_.insert(std::make_pair(id, std::move(node_arg)));
 
@@ -197,6 +304,7 @@ void ConnectionManager::InsertPeer(PeerNode&& node_arg) {
 
   auto& node = pair.first->second;
 
+  GroupChanged();
   StartReceiving(node);
 
   if (on_connection_added_) {
@@ -210,8 +318,13 @@ void ConnectionManager::StartReceiving(PeerNode& node) {
   node.Receive([=, &node](asio::error_code error, const SerialisedMessage& bytes) {
     if (!node_guard.lock())
       return;
-    if (error)
+    if (error) {
+      // The peer is still ours, so it wasn't dropped or shut down: the connection failed.
+      LOG(kInfo) << "Lost connection to peer: " << error.message();
+      const Address id(node.id());
+      DropNode(id);
       return;
+    }
     if (!on_receive_)
       return;
     // Complex handler invocation to be safe in cases where the
@@ -243,6 +356,7 @@ optional<CloseGroupDifference> ConnectionManager::GroupChanged() {
   if (new_group_ids != current_close_group_) {
     auto changed = std::make_pair(new_group_ids, current_close_group_);
     current_close_group_ = new_group_ids;
+    ++close_group_version_;
     return changed;
   }
 
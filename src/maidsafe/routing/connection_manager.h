@@ -38,6 +38,8 @@ destiations. In that case request a close_group message for this node.
 #ifndef MAIDSAFE_ROUTING_CONNECTION_MANAGER_H_
 #define MAIDSAFE_ROUTING_CONNECTION_MANAGER_H_
 
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <set>
@@ -45,6 +47,7 @@ destiations. In that case request a close_group message for this node.
 
 #include "asio/io_service.hpp"
 #include "boost/optional.hpp"
+#include "boost/asio/steady_timer.hpp"
 
 #include "maidsafe/crux/socket.hpp"
 #include "maidsafe/crux/acceptor.hpp"
@@ -84,7 +87,8 @@ class ConnectionManager {
   bool IsManaged(const Address& node_to_add) const;
   std::set<Address, Comparison> GetTarget(const Address& target_node) const;
   //boost::optional<CloseGroupDifference> LostNetworkConnection(const Address& node);
-  // routing wishes to drop a specific node (may be a node we cannot connect to)
+  // routing wishes to drop a specific node (may be a node we cannot connect to).  Also called when
+  // a peer's connection fails.
   boost::optional<CloseGroupDifference> DropNode(const Address& their_id);
   void AddNode(boost::optional<NodeInfo> node_to_add, EndpointPair);
 
@@ -100,6 +104,14 @@ class ConnectionManager {
     return result;
   }
 
+  // The GroupSize nodes we know of (us included) closest to |target|, ordered by closeness to it.
+  // Members of the group close to |target| know the same nodes, so they all answer with the same
+  // list, letting their signed answers be accumulated.
+  std::vector<PublicPmid> CloseGroupOf(const Address& target) const;
+  // False if we know of a node (us included) which |members|, ordered by closeness to |target|,
+  // leave out although it's closer to |target| than the furthest of them.
+  bool CouldBeCloseGroupOf(const Address& target, const std::vector<Address>& members) const;
+
   //size_t CloseGroupBucketDistance() const {
   //  return routing_table_.BucketIndex(routing_table_.OurCloseGroup().back().id);
   //}
@@ -113,6 +125,10 @@ class ConnectionManager {
 
   const Address& OurId() const { return our_id_; }
 
+  // Incremented each time our close group changes, so anything derived from the close group can
+  // be cached against it.
+  uint64_t CloseGroupVersion() const { return close_group_version_; }
+
   boost::optional<asymm::PublicKey> GetPublicKey(const Address& node) const {
     auto found_i = peers_.find(node);
     if (found_i == peers_.end()) { return boost::none; }
@@ -137,15 +153,28 @@ class ConnectionManager {
     on_connection_added_ = std::move(handler);
   }
 
+  // Called with the id of each peer removed by DropNode, including those whose connection failed.
+  template<class Handler /* void(NodeId) */>
+  void SetOnConnectionLost(Handler handler) {
+    on_connection_lost_ = std::move(handler);
+  }
+
   template<class Handler /* void(NodeId, SerialisedMessage) */>
   void SetOnReceive(Handler handler) {
     on_receive_ = std::move(handler);
   }
 
+  // Stops accepting and making connections, then waits up to |timeout| for the sends already
+  // started to complete before closing every connection (so the sends left are completed with
+  // operation_aborted).  |handler| is called with the number of sends which hadn't completed.
+  void Drain(std::chrono::steady_clock::duration timeout, std::function<void(size_t)> handler);
+  size_t SendsInFlight() const;
+
   void Shutdown() {
     acceptors_.clear();
     being_connected_.clear();
     peers_.clear();
+    GroupChanged();
   }
 
  private:
@@ -153,11 +182,15 @@ class ConnectionManager {
   void InsertPeer(PeerNode&&);
   std::weak_ptr<boost::none_t> DestroyGuard() { return destroy_indicator_; }
   void StartReceiving(PeerNode&);
+  void ContinueDrain(std::shared_ptr<boost::asio::steady_timer> timer,
+                     std::chrono::steady_clock::time_point deadline,
+                     std::function<void(size_t)> handler);
 
  private:
   boost::asio::io_service& io_service_;
 
   std::function<void(NodeId)> on_connection_added_;
+  std::function<void(NodeId)> on_connection_lost_;
   std::function<void(NodeId, const SerialisedMessage&)> on_receive_;
 
   PublicPmid our_fob_;
@@ -168,6 +201,9 @@ class ConnectionManager {
   std::map<Address, PeerNode, Comparison> peers_;
 
   std::vector<Address> current_close_group_;
+  uint64_t close_group_version_;
+  // Set once Drain is called, after which no connections are added.
+  bool draining_;
 
   std::shared_ptr<boost::none_t> destroy_indicator_;
 };
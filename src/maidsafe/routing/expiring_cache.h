@@ -0,0 +1,210 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_EXPIRING_CACHE_H_
+#define MAIDSAFE_ROUTING_EXPIRING_CACHE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/routing/hash.h"
+#include "maidsafe/routing/timing_wheel.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Value type for an ExpiringCache used as a set, e.g. the message filter.
+struct NoValue {};
+
+// Bounded cache whose entries are expired by a shared TimingWheel |time_to_live| after they were
+// added, rather than by scanning on insertion.  At most |capacity| entries are held; adding to a
+// full cache drops the least recently used entry.  Adding an existing key replaces its value and
+// restarts its time_to_live.  The wheel must outlive the cache.
+template <typename Key, typename Value = NoValue>
+class ExpiringCache {
+ public:
+  // Gives the cost of holding a value, e.g. its size in bytes.
+  using Cost = std::function<uint64_t(const Value&)>;
+
+  ExpiringCache(TimingWheel& expiry_wheel, std::chrono::steady_clock::duration time_to_live,
+                size_t capacity)
+      : ExpiringCache(expiry_wheel, time_to_live, capacity,
+                      std::numeric_limits<uint64_t>::max(), Cost()) {}
+
+  // As above, but the least recently used entries are also dropped to keep the total cost of the
+  // values held within |max_cost|.  A value costing more than that on its own isn't held at all.
+  ExpiringCache(TimingWheel& expiry_wheel, std::chrono::steady_clock::duration time_to_live,
+                size_t capacity, uint64_t max_cost, Cost cost)
+      : expiry_wheel_(expiry_wheel),
+        time_to_live_(time_to_live),
+        capacity_(std::max(capacity, size_t(1))),
+        max_cost_(max_cost),
+        cost_(std::move(cost)),
+        mutex_(),
+        entries_(),
+        order_(),
+        total_cost_(0),
+        generation_(0),
+        expired_(0),
+        evicted_(0) {}
+
+  ExpiringCache(const ExpiringCache&) = delete;
+  ExpiringCache(ExpiringCache&&) = delete;
+  ~ExpiringCache() {
+    for (const auto& entry : entries_)
+      expiry_wheel_.Cancel(entry.second.timer);
+  }
+  ExpiringCache& operator=(const ExpiringCache&) = delete;
+  ExpiringCache& operator=(ExpiringCache&&) = delete;
+
+  bool Check(const Key& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.count(key) != 0;
+  }
+
+  void Add(Key key, Value value = Value()) {
+    const uint64_t cost(cost_ ? cost_(value) : 0);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found(entries_.find(key));
+    if (cost > max_cost_) {
+      if (found != std::end(entries_))
+        Erase(found);
+      return;
+    }
+    if (found != std::end(entries_)) {
+      expiry_wheel_.Cancel(found->second.timer);
+      total_cost_ = total_cost_ - found->second.cost + cost;
+      found->second.value = std::move(value);
+      found->second.cost = cost;
+      found->second.generation = ++generation_;
+      found->second.timer = Schedule(key, generation_);
+      Touch(found->second);
+      // Older entries make room for the replacement, which is now the most recently used.
+      while (total_cost_ > max_cost_) {
+        Erase(entries_.find(*order_.front()));
+        ++evicted_;
+      }
+      return;
+    }
+    while (!entries_.empty() &&
+           (entries_.size() >= capacity_ || total_cost_ + cost > max_cost_)) {
+      Erase(entries_.find(*order_.front()));
+      ++evicted_;
+    }
+    const auto timer(Schedule(key, ++generation_));
+    const auto inserted(entries_.insert(
+        std::make_pair(std::move(key), Entry{std::move(value), cost, generation_, timer, {}})));
+    auto& entry(inserted.first->second);
+    entry.order = order_.insert(std::end(order_), &inserted.first->first);
+    total_cost_ += cost;
+  }
+
+  boost::optional<Value> Get(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found(entries_.find(key));
+    if (found == std::end(entries_))
+      return boost::none;
+    Touch(found->second);
+    return found->second.value;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+  size_t Capacity() const { return capacity_; }
+  // Total cost of the values held.
+  uint64_t TotalCost() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_cost_;
+  }
+  // Number of entries removed by their timers, and by making room for new entries.
+  uint64_t Expired() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return expired_;
+  }
+  uint64_t Evicted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return evicted_;
+  }
+
+ private:
+  // Keys are held once, in |entries_|; the usage order refers to them by address, which is stable
+  // in an unordered_map.
+  using Order = std::list<const Key*>;
+  struct Entry {
+    Value value;
+    uint64_t cost;
+    uint64_t generation;  // identifies the timer currently responsible for the entry
+    TimingWheel::TimerId timer;
+    typename Order::iterator order;
+  };
+  using Entries = std::unordered_map<Key, Entry, detail::Hasher<Key>>;
+
+  TimingWheel::TimerId Schedule(const Key& key, uint64_t generation) {
+    return expiry_wheel_.Schedule(time_to_live_,
+                                  [this, key, generation] { Expire(key, generation); });
+  }
+
+  void Expire(const Key& key, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found(entries_.find(key));
+    // The entry may have been replaced after this timer fired but before it ran.
+    if (found == std::end(entries_) || found->second.generation != generation)
+      return;
+    total_cost_ -= found->second.cost;
+    order_.erase(found->second.order);
+    entries_.erase(found);
+    ++expired_;
+  }
+
+  void Touch(Entry& entry) { order_.splice(std::end(order_), order_, entry.order); }
+
+  void Erase(typename Entries::iterator entry) {
+    expiry_wheel_.Cancel(entry->second.timer);
+    total_cost_ -= entry->second.cost;
+    order_.erase(entry->second.order);
+    entries_.erase(entry);
+  }
+
+  TimingWheel& expiry_wheel_;
+  const std::chrono::steady_clock::duration time_to_live_;
+  const size_t capacity_;
+  const uint64_t max_cost_;
+  const Cost cost_;
+  mutable std::mutex mutex_;
+  Entries entries_;
+  Order order_;
+  uint64_t total_cost_, generation_, expired_, evicted_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_EXPIRING_CACHE_H_
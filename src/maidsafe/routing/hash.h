@@ -0,0 +1,76 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_HASH_H_
+#define MAIDSAFE_ROUTING_HASH_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "maidsafe/common/node_id.h"
+#include "maidsafe/common/tagged_value.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace detail {
+
+// Hashing for the key types used in routing's hashed containers (addresses, tagged addresses,
+// identities, message ids and pairs of these).
+inline size_t HashValue(const NodeId& id) { return std::hash<std::string>()(id.string()); }
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, size_t>::type
+    HashValue(T value) {
+  return std::hash<typename std::conditional<std::is_enum<T>::value, uint64_t, T>::type>()(
+      static_cast<typename std::conditional<std::is_enum<T>::value, uint64_t, T>::type>(value));
+}
+
+// Anything else exposing its raw bytes via string(), e.g. Identity.
+template <typename T>
+auto HashValue(const T& value) -> decltype(std::hash<std::string>()(value.string())) {
+  return std::hash<std::string>()(value.string());
+}
+
+template <typename T, typename Tag>
+size_t HashValue(const TaggedValue<T, Tag>& value) {
+  return HashValue(value.data);
+}
+
+template <typename First, typename Second>
+size_t HashValue(const std::pair<First, Second>& value) {
+  const size_t seed(HashValue(value.first));
+  return seed ^ (HashValue(value.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+template <typename T>
+struct Hasher {
+  size_t operator()(const T& value) const { return HashValue(value); }
+};
+
+}  // namespace detail
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_HASH_H_
@@ -0,0 +1,151 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_HEDGED_REQUEST_H_
+#define MAIDSAFE_ROUTING_HEDGED_REQUEST_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "asio/error.hpp"
+
+#include "maidsafe/routing/response_table.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+struct HedgeOptions {
+  HedgeOptions()
+      : percentile(0.95), max_attempts(3), initial_delay(std::chrono::milliseconds(100)) {}
+
+  // A backup request is sent once this percentile of recent response latencies has passed
+  // without a response.
+  double percentile;
+  // Including the first request.
+  size_t max_attempts;
+  // Used as the backup delay until enough latencies have been measured.
+  std::chrono::steady_clock::duration initial_delay;
+};
+
+// Sends a request registered in a ResponseTable to a list of equivalent targets, best first.  The
+// first reachable target is sent the request at once, then each following target in turn whenever
+// |delay| passes without the request completing, up to |max_attempts| targets in all.  The first
+// valid response completes the request and later ones are dropped by the table, so one slow hop
+// no longer decides the latency of the whole request.  Templated on the timer type so that either
+// standalone or Boost asio services can be used.
+template <typename SteadyTimer>
+class HedgedRequest : public std::enable_shared_from_this<HedgedRequest<SteadyTimer>> {
+ public:
+  // Sends the request to one target, returning false if it couldn't be sent.
+  using Send = std::function<bool(const Address& target)>;
+
+  // |key| must already have been added to |responses|, which must outlive |io_service|'s handlers.
+  template <typename IoService>
+  static void Start(IoService& io_service, ResponseTable& responses, ResponseTable::Key key,
+                    std::vector<Address> targets, std::chrono::steady_clock::duration delay,
+                    size_t max_attempts, Send send) {
+    std::shared_ptr<HedgedRequest> request(new HedgedRequest(io_service, responses, std::move(key),
+                                                             std::move(targets), delay,
+                                                             max_attempts, std::move(send)));
+    if (!request->SendNext()) {
+      responses.Complete(request->key_, asio::error::network_unreachable, SerialisedMessage());
+      return;
+    }
+    request->ScheduleBackup();
+  }
+
+  HedgedRequest(const HedgedRequest&) = delete;
+  HedgedRequest(HedgedRequest&&) = delete;
+  ~HedgedRequest() = default;
+  HedgedRequest& operator=(const HedgedRequest&) = delete;
+  HedgedRequest& operator=(HedgedRequest&&) = delete;
+
+ private:
+  template <typename IoService>
+  HedgedRequest(IoService& io_service, ResponseTable& responses, ResponseTable::Key key,
+                std::vector<Address> targets, std::chrono::steady_clock::duration delay,
+                size_t max_attempts, Send send)
+      : responses_(responses),
+        key_(std::move(key)),
+        targets_(std::move(targets)),
+        delay_(delay),
+        max_attempts_(max_attempts),
+        send_(std::move(send)),
+        timer_(io_service),
+        next_(0),
+        sent_(0) {}
+
+  struct OnDelay {
+    template <typename ErrorCode>
+    void operator()(const ErrorCode& error) const {
+      if (!error)
+        request->SendBackup();
+    }
+    std::shared_ptr<HedgedRequest> request;
+  };
+
+  // Sends to the next target which can be reached.  Returns false if none can be.
+  bool SendNext() {
+    while (next_ < targets_.size()) {
+      if (send_(targets_[next_++])) {
+        ++sent_;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void ScheduleBackup() {
+    if (sent_ >= max_attempts_ || next_ >= targets_.size())
+      return;
+    timer_.expires_from_now(delay_);
+    timer_.async_wait(OnDelay{this->shared_from_this()});
+  }
+
+  void SendBackup() {
+    // No backup is needed if the request has been answered (or has timed out) meanwhile.
+    if (!responses_.AddAttempt(key_))
+      return;
+    if (!SendNext()) {
+      responses_.Fail(key_, asio::error::network_unreachable);
+      return;
+    }
+    ScheduleBackup();
+  }
+
+  ResponseTable& responses_;
+  const ResponseTable::Key key_;
+  const std::vector<Address> targets_;
+  const std::chrono::steady_clock::duration delay_;
+  const size_t max_attempts_;
+  const Send send_;
+  SteadyTimer timer_;
+  size_t next_, sent_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_HEDGED_REQUEST_H_
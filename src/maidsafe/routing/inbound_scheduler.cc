@@ -0,0 +1,146 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/inbound_scheduler.h"
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+const size_t InboundScheduler::kClassCount;
+
+InboundClass Classify(MessageTypeTag tag, bool for_our_group) {
+  switch (tag) {
+    case MessageTypeTag::Connect:
+    case MessageTypeTag::ConnectResponse:
+    case MessageTypeTag::FindGroup:
+    case MessageTypeTag::FindGroupResponse:
+      return InboundClass::control;
+    case MessageTypeTag::GetKey:
+    case MessageTypeTag::GetKeyResponse:
+    case MessageTypeTag::GetGroupKey:
+    case MessageTypeTag::GetGroupKeyResponse:
+    case MessageTypeTag::PutKey:
+      return InboundClass::key;
+    default:
+      return for_our_group ? InboundClass::data_local : InboundClass::data_forward;
+  }
+}
+
+InboundScheduler::InboundScheduler(Post post, size_t concurrency, InboundOptions options)
+    : post_(std::move(post)),
+      concurrency_(concurrency),
+      options_(std::move(options)),
+      mutex_(),
+      queues_(),
+      current_(0),
+      credit_(0),
+      running_(0),
+      stopped_(false) {
+  if (concurrency_ == 0)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  for (size_t i(0); i < kClassCount; ++i) {
+    if (options_.weights[i] == 0 || options_.capacities[i] == 0)
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+    queues_[i].handled = queues_[i].dropped = 0;
+  }
+  credit_ = options_.weights[current_];
+}
+
+bool InboundScheduler::Push(InboundClass inbound_class, Task task) {
+  if (!task)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto index(static_cast<size_t>(inbound_class));
+    auto& queue(queues_[index]);
+    if (stopped_ || queue.tasks.size() >= options_.capacities[index]) {
+      ++queue.dropped;
+      return false;
+    }
+    queue.tasks.push_back(std::move(task));
+    if (running_ == concurrency_)
+      return true;
+    ++running_;
+  }
+  post_([this] { Run(); });
+  return true;
+}
+
+void InboundScheduler::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stopped_ = true;
+  for (auto& queue : queues_) {
+    queue.dropped += queue.tasks.size();
+    queue.tasks.clear();
+  }
+}
+
+size_t InboundScheduler::Queued(InboundClass inbound_class) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queues_[static_cast<size_t>(inbound_class)].tasks.size();
+}
+
+uint64_t InboundScheduler::Handled(InboundClass inbound_class) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queues_[static_cast<size_t>(inbound_class)].handled;
+}
+
+uint64_t InboundScheduler::Dropped(InboundClass inbound_class) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queues_[static_cast<size_t>(inbound_class)].dropped;
+}
+
+void InboundScheduler::Run() {
+  Task task;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!Next(task)) {
+      --running_;
+      return;
+    }
+  }
+  task();
+  // Posted rather than looping here, so that other work on the io_service isn't starved.
+  post_([this] { Run(); });
+}
+
+bool InboundScheduler::Next(Task& task) {
+  if (stopped_)
+    return false;
+  // Each class in turn is handled up to its weight in messages while it has any waiting.
+  for (size_t checked(0); checked <= kClassCount; ++checked) {
+    auto& queue(queues_[current_]);
+    if (credit_ != 0 && !queue.tasks.empty()) {
+      --credit_;
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      ++queue.handled;
+      return true;
+    }
+    current_ = (current_ + 1) % kClassCount;
+    credit_ = options_.weights[current_];
+  }
+  return false;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,110 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_INBOUND_SCHEDULER_H_
+#define MAIDSAFE_ROUTING_INBOUND_SCHEDULER_H_
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "maidsafe/routing/messages/messages_fwd.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+enum class InboundClass : uint8_t { control, key, data_forward, data_local };
+
+// Connect and FindGroup traffic is control, key requests and responses (which the sentinel waits
+// on) are key, and everything else is data, local if |for_our_group| (i.e. the destination is
+// within our close group range) and otherwise only being forwarded.
+InboundClass Classify(MessageTypeTag tag, bool for_our_group);
+
+struct InboundOptions {
+  InboundOptions() : weights{{8, 4, 1, 2}}, capacities{{1024, 1024, 4096, 4096}} {}
+
+  // Indexed by InboundClass.  While several classes are waiting, each is handled in proportion to
+  // its weight.
+  std::array<uint32_t, 4> weights;
+  // Messages arriving for a full queue are dropped.
+  std::array<size_t, 4> capacities;
+};
+
+// Queues the tasks handling inbound messages by class and runs them on |io_service| in weighted
+// round robin order, so that a flood of one class (e.g. data being forwarded) can only delay the
+// others by its share of the handling threads rather than by the whole backlog.  No more than
+// |concurrency| tasks are run at a time, and which task is next is only decided as a thread becomes
+// free, so nothing queues up in |io_service| behind the flood.  Thread-safe.
+class InboundScheduler {
+ public:
+  using Task = std::function<void()>;
+  static const size_t kClassCount = 4;
+
+  template <typename IoService>
+  InboundScheduler(IoService& io_service, size_t concurrency,
+                   InboundOptions options = InboundOptions())
+      : InboundScheduler([&io_service](Task task) { io_service.post(std::move(task)); },
+                         concurrency, std::move(options)) {}
+  InboundScheduler(const InboundScheduler&) = delete;
+  InboundScheduler(InboundScheduler&&) = delete;
+  ~InboundScheduler() = default;
+  InboundScheduler& operator=(const InboundScheduler&) = delete;
+  InboundScheduler& operator=(InboundScheduler&&) = delete;
+
+  // Returns false if the task was dropped because its queue is full or we've stopped.
+  bool Push(InboundClass inbound_class, Task task);
+  // Drops all queued tasks and any pushed later.  Tasks already running complete.
+  void Stop();
+
+  size_t Queued(InboundClass inbound_class) const;
+  uint64_t Handled(InboundClass inbound_class) const;
+  uint64_t Dropped(InboundClass inbound_class) const;
+
+ private:
+  using Post = std::function<void(Task)>;
+
+  struct Queue {
+    std::deque<Task> tasks;
+    uint64_t handled, dropped;
+  };
+
+  InboundScheduler(Post post, size_t concurrency, InboundOptions options);
+  void Run();
+  // Must be called with |mutex_| held.
+  bool Next(Task& task);
+
+  const Post post_;
+  const size_t concurrency_;
+  const InboundOptions options_;
+  mutable std::mutex mutex_;
+  std::array<Queue, kClassCount> queues_;
+  size_t current_;
+  uint32_t credit_;
+  size_t running_;
+  bool stopped_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_INBOUND_SCHEDULER_H_
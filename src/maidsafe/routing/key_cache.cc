@@ -0,0 +1,117 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/key_cache.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+KeyCache::KeyCache(std::chrono::steady_clock::duration time_to_live, size_t capacity)
+    : time_to_live_(time_to_live),
+      capacity_(capacity),
+      groups_(),
+      nodes_(),
+      hits_(0),
+      misses_(0),
+      invalidations_(0) {}
+
+std::shared_ptr<const KeyCache::Keys> KeyCache::GetGroup(const GroupAddress& group) {
+  auto found(Find(groups_, group));
+  return found ? *found : nullptr;
+}
+
+void KeyCache::AddGroup(const GroupAddress& group, Keys keys) {
+  Insert(groups_, group, std::shared_ptr<const Keys>(std::make_shared<Keys>(std::move(keys))));
+}
+
+boost::optional<asymm::PublicKey> KeyCache::GetNode(const Address& node) {
+  auto found(Find(nodes_, node));
+  if (!found)
+    return boost::none;
+  return *found;
+}
+
+void KeyCache::AddNode(const Address& node, asymm::PublicKey key) {
+  Insert(nodes_, node, std::move(key));
+}
+
+void KeyCache::HandleChurn(const Address& node) {
+  for (auto it(std::begin(groups_)); it != std::end(groups_);) {
+    const auto& keys(*it->second.value);
+    const Address& target(it->first.data);
+    // A member left, or the node is closer to the group's address than its furthest member and so
+    // would now be in the group.
+    const bool member(keys.count(node) != 0);
+    const bool would_join(
+        keys.size() < GroupSize ||
+        std::any_of(std::begin(keys), std::end(keys), [&](const Keys::value_type& key) {
+          return Address::CloserToTarget(node, key.first, target);
+        }));
+    if (member || would_join) {
+      ++invalidations_;
+      it = groups_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+template <typename Name, typename Value>
+Value* KeyCache::Find(std::map<Name, Entry<Value>>& entries, const Name& name) {
+  auto found(entries.find(name));
+  if (found == std::end(entries)) {
+    ++misses_;
+    return nullptr;
+  }
+  if (found->second.added + time_to_live_ < std::chrono::steady_clock::now()) {
+    entries.erase(found);
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  return &found->second.value;
+}
+
+template <typename Name, typename Value>
+void KeyCache::Insert(std::map<Name, Entry<Value>>& entries, const Name& name, Value value) {
+  if (capacity_ == 0)
+    return;
+  auto found(entries.find(name));
+  if (found == std::end(entries) && entries.size() >= capacity_) {
+    const auto oldest(std::min_element(
+        std::begin(entries), std::end(entries),
+        [](const typename std::map<Name, Entry<Value>>::value_type& lhs,
+           const typename std::map<Name, Entry<Value>>::value_type& rhs) {
+          return lhs.second.added < rhs.second.added;
+        }));
+    LOG(kVerbose) << "Key cache full, evicting oldest entry.";
+    entries.erase(oldest);
+  }
+  entries[name] = Entry<Value>{std::move(value), std::chrono::steady_clock::now()};
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,94 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_KEY_CACHE_H_
+#define MAIDSAFE_ROUTING_KEY_CACHE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Holds keys which have already been confirmed, so checking further messages from the same group or
+// node doesn't need another GetKey/GetGroupKey round trip.  The Sentinel only adds a group's keys
+// once a quorum of the members listed have signed the response, and a node's key once its fob is
+// shown to be the node's own.  Entries expire after
+// |time_to_live| and group entries are also dropped when churn could have changed the group's
+// membership.  When full, the oldest entry of the same kind is evicted.  Not thread-safe.
+class KeyCache {
+ public:
+  using Keys = std::map<Address, asymm::PublicKey>;
+
+  KeyCache(std::chrono::steady_clock::duration time_to_live, size_t capacity);
+  KeyCache(const KeyCache&) = delete;
+  KeyCache(KeyCache&&) = delete;
+  ~KeyCache() = default;
+  KeyCache& operator=(const KeyCache&) = delete;
+  KeyCache& operator=(KeyCache&&) = delete;
+
+  std::shared_ptr<const Keys> GetGroup(const GroupAddress& group);
+  void AddGroup(const GroupAddress& group, Keys keys);
+  boost::optional<asymm::PublicKey> GetNode(const Address& node);
+  void AddNode(const Address& node, asymm::PublicKey key);
+
+  // |node| joined or left the network.  Drops every group which had it as a member, or which it
+  // is now close enough to join.
+  void HandleChurn(const Address& node);
+
+  size_t GroupCount() const { return groups_.size(); }
+  size_t NodeCount() const { return nodes_.size(); }
+  uint64_t Hits() const { return hits_; }
+  uint64_t Misses() const { return misses_; }
+  uint64_t Invalidations() const { return invalidations_; }
+
+ private:
+  template <typename Value>
+  struct Entry {
+    Value value;
+    std::chrono::steady_clock::time_point added;
+  };
+
+  template <typename Name, typename Value>
+  Value* Find(std::map<Name, Entry<Value>>& entries, const Name& name);
+  template <typename Name, typename Value>
+  void Insert(std::map<Name, Entry<Value>>& entries, const Name& name, Value value);
+
+  const std::chrono::steady_clock::duration time_to_live_;
+  const size_t capacity_;
+  std::map<GroupAddress, Entry<std::shared_ptr<const Keys>>> groups_;
+  std::map<Address, Entry<asymm::PublicKey>> nodes_;
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t invalidations_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_KEY_CACHE_H_
@@ -0,0 +1,70 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/latency_tracker.h"
+
+#include <algorithm>
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+const size_t LatencyTracker::kDefaultWindow;
+const size_t LatencyTracker::kMinimumSamples;
+
+LatencyTracker::LatencyTracker(size_t window) : window_(window), mutex_(), samples_(), next_(0) {
+  if (window_ == 0)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  samples_.reserve(window_);
+}
+
+void LatencyTracker::Add(Clock::duration latency) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (samples_.size() < window_) {
+    samples_.push_back(latency);
+  } else {
+    samples_[next_] = latency;
+    next_ = (next_ + 1) % window_;
+  }
+}
+
+boost::optional<LatencyTracker::Clock::duration> LatencyTracker::Percentile(double fraction) const {
+  std::vector<Clock::duration> samples;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.size() < kMinimumSamples)
+      return boost::none;
+    samples = samples_;
+  }
+  fraction = std::min(std::max(fraction, 0.0), 1.0);
+  const auto nth(std::begin(samples) +
+                 static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1)));
+  std::nth_element(std::begin(samples), nth, std::end(samples));
+  return *nth;
+}
+
+size_t LatencyTracker::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return samples_.size();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
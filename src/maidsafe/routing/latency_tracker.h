@@ -0,0 +1,66 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_LATENCY_TRACKER_H_
+#define MAIDSAFE_ROUTING_LATENCY_TRACKER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "boost/optional/optional.hpp"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Keeps the most recent |window| latency samples, so that percentiles follow current network
+// conditions.  Thread-safe.
+class LatencyTracker {
+ public:
+  using Clock = std::chrono::steady_clock;
+  static const size_t kDefaultWindow = 1024;
+  // Percentiles aren't reported until at least this many samples have been added.
+  static const size_t kMinimumSamples = 16;
+
+  explicit LatencyTracker(size_t window = kDefaultWindow);
+  LatencyTracker(const LatencyTracker&) = delete;
+  LatencyTracker(LatencyTracker&&) = delete;
+  ~LatencyTracker() = default;
+  LatencyTracker& operator=(const LatencyTracker&) = delete;
+  LatencyTracker& operator=(LatencyTracker&&) = delete;
+
+  void Add(Clock::duration latency);
+  // Returns the latency which |fraction| (in [0, 1]) of the recent samples didn't exceed, or
+  // boost::none if there are too few samples yet.
+  boost::optional<Clock::duration> Percentile(double fraction) const;
+  size_t size() const;
+
+ private:
+  const size_t window_;
+  mutable std::mutex mutex_;
+  std::vector<Clock::duration> samples_;
+  size_t next_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_LATENCY_TRACKER_H_
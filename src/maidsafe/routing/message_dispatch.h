@@ -0,0 +1,100 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGE_DISPATCH_H_
+#define MAIDSAFE_ROUTING_MESSAGE_DISPATCH_H_
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/messages/messages.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace detail {
+
+template <uint16_t Index, typename List>
+struct TagsMatchIndices;
+
+template <uint16_t Index>
+struct TagsMatchIndices<Index, TypeList<>> : std::true_type {};
+
+template <uint16_t Index, typename Message, typename... Rest>
+struct TagsMatchIndices<Index, TypeList<Message, Rest...>>
+    : std::integral_constant<bool, static_cast<uint16_t>(MessageToTag<Message>::value) == Index &&
+                                       TagsMatchIndices<Index + 1, TypeList<Rest...>>::value> {};
+
+}  // namespace detail
+
+static_assert(AllMessageTypes::size == kMessageTypeTagCount,
+              "AllMessageTypes must contain exactly one type per MessageTypeTag.");
+static_assert(detail::TagsMatchIndices<0, AllMessageTypes>::value,
+              "AllMessageTypes must be listed in MessageTypeTag order.");
+
+// Jump table of parse-and-dispatch thunks, one per MessageTypeTag, generated from AllMessageTypes.
+// Each thunk parses the message body and calls 'handler.HandleMessage(Message&&, MessageHeader&&)',
+// so a Handler which doesn't provide an overload for every message type fails to compile.  The
+// primary template is declared in messages_fwd.h so that handlers can befriend it.
+template <typename Handler, typename... Messages>
+class MessageDispatcher<Handler, TypeList<Messages...>> {
+ public:
+  // Returns false without touching the stream if the tag is unknown.  Parsing errors in the body
+  // are propagated to the caller.
+  static bool Dispatch(Handler& handler, MessageTypeTag tag, InputVectorStream& input_stream,
+                       MessageHeader&& header) {
+    const auto index(static_cast<uint16_t>(tag));
+    if (index >= kMessageTypeTagCount) {
+      LOG(kWarning) << "Received message of unknown type " << index;
+      return false;
+    }
+    kTable[index](handler, input_stream, std::move(header));
+    return true;
+  }
+
+ private:
+  using Thunk = void (*)(Handler&, InputVectorStream&, MessageHeader&&);
+
+  template <typename Message>
+  static void ParseAndDispatch(Handler& handler, InputVectorStream& input_stream,
+                               MessageHeader&& header) {
+    handler.HandleMessage(Parse<Message>(input_stream), std::move(header));
+  }
+
+  static const std::array<Thunk, sizeof...(Messages)> kTable;
+};
+
+template <typename Handler, typename... Messages>
+const std::array<typename MessageDispatcher<Handler, TypeList<Messages...>>::Thunk,
+                 sizeof...(Messages)> MessageDispatcher<Handler, TypeList<Messages...>>::kTable{
+    {&MessageDispatcher<Handler, TypeList<Messages...>>::template ParseAndDispatch<Messages>...}};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGE_DISPATCH_H_
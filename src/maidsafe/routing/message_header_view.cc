@@ -0,0 +1,42 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/message_header_view.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+const uint8_t MessageHeaderView::kVersion;
+const size_t MessageHeaderView::kAddressSize;
+const size_t MessageHeaderView::kFixedSize;
+const size_t MessageHeaderView::kVersionOffset;
+const size_t MessageHeaderView::kFlagsOffset;
+const size_t MessageHeaderView::kAuthorityOffset;
+const size_t MessageHeaderView::kMessageIdOffset;
+const size_t MessageHeaderView::kTagOffset;
+const size_t MessageHeaderView::kSignatureSizeOffset;
+const size_t MessageHeaderView::kDestinationOffset;
+const size_t MessageHeaderView::kDestinationReplyToOffset;
+const size_t MessageHeaderView::kSourceNodeOffset;
+const size_t MessageHeaderView::kSourceGroupOffset;
+const size_t MessageHeaderView::kSourceReplyToOffset;
+
+}  // namespace routing
+
+}  // namespace maidsafe
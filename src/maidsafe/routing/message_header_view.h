@@ -0,0 +1,267 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+/*
+Fixed layout wire format for a MessageHeader plus its MessageTypeTag (version 1).  All integers
+are big endian and every address has its own slot, so each field lives at a constant offset and
+can be read in place without running the message through cereal.  Absent optional addresses are
+written as zeros and flagged as absent in the flags byte.
+
+  offset  size  field
+       0     1  version (kVersion)
+       1     1  flags (see Flags below)
+       2     1  authority
+       3     1  reserved (zero)
+       4     4  message id
+       8     2  message type tag
+      10     2  signature size in bytes (zero when unsigned)
+      12    64  destination
+      76    64  destination reply_to
+     140    64  source node
+     204    64  source group
+     268    64  source reply_to
+     332     n  signature
+
+The message body follows immediately after the signature.
+*/
+
+#ifndef MAIDSAFE_ROUTING_MESSAGE_HEADER_VIEW_H_
+#define MAIDSAFE_ROUTING_MESSAGE_HEADER_VIEW_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <string>
+
+#include "boost/optional/optional.hpp"
+#include "boost/range/iterator_range.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/source_address.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+using ByteRange = boost::iterator_range<const byte*>;
+
+namespace detail {
+
+inline void PutUint16(uint16_t value, byte* out) {
+  out[0] = static_cast<byte>(value >> 8);
+  out[1] = static_cast<byte>(value);
+}
+
+inline void PutUint32(uint32_t value, byte* out) {
+  out[0] = static_cast<byte>(value >> 24);
+  out[1] = static_cast<byte>(value >> 16);
+  out[2] = static_cast<byte>(value >> 8);
+  out[3] = static_cast<byte>(value);
+}
+
+inline uint16_t GetUint16(const byte* in) {
+  return static_cast<uint16_t>((static_cast<uint16_t>(in[0]) << 8) | in[1]);
+}
+
+inline uint32_t GetUint32(const byte* in) {
+  return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16) |
+         (static_cast<uint32_t>(in[2]) << 8) | static_cast<uint32_t>(in[3]);
+}
+
+inline void PutAddress(const Address& address, byte* out) {
+  const auto raw(address.string());
+  assert(raw.size() == Address::kSize);
+  std::copy(std::begin(raw), std::end(raw), out);
+}
+
+inline Address GetAddress(ByteRange range) {
+  return Address(std::string(range.begin(), range.end()));
+}
+
+}  // namespace detail
+
+class MessageHeaderView {
+ public:
+  static const uint8_t kVersion = 1;
+  static const size_t kAddressSize = Address::kSize;
+  static const size_t kFixedSize = 12 + 5 * kAddressSize;
+
+  enum Flags : uint8_t {
+    kHasDestinationReplyTo = 0x01,
+    kHasSourceGroup = 0x02,
+    kHasSourceReplyTo = 0x04,
+    kHasSignature = 0x08
+  };
+
+  // Throws CommonErrors::parsing_error if the buffer is too short or was written with a different
+  // version.  The view does not own the bytes, so the buffer must outlive it.
+  MessageHeaderView(const byte* data, size_t size) : data_(data), size_(size) { Validate(); }
+  explicit MessageHeaderView(const SerialisedMessage& message)
+      : data_(message.data()), size_(message.size()) {
+    Validate();
+  }
+
+  MessageHeaderView(const MessageHeaderView&) = default;
+  MessageHeaderView& operator=(const MessageHeaderView&) = default;
+  ~MessageHeaderView() = default;
+
+  // Appends the fixed layout encoding of |header| and |tag| to |out|.  The message body should be
+  // appended after this.
+  static void Write(const MessageHeader& header, MessageTypeTag tag, SerialisedMessage& out) {
+    const auto destination(header.Destination());
+    const auto source(header.Source());
+    const auto signature(header.Signature());
+    const std::string signature_bytes(signature ? signature->string() : std::string());
+    if (signature_bytes.size() > 0xFFFF)
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+
+    const auto start(out.size());
+    out.resize(start + kFixedSize + signature_bytes.size(), 0);
+    byte* const base(&out[start]);
+
+    uint8_t flags(0);
+    if (destination.second)
+      flags |= kHasDestinationReplyTo;
+    if (source.group_address)
+      flags |= kHasSourceGroup;
+    if (source.reply_to_address)
+      flags |= kHasSourceReplyTo;
+    if (signature)
+      flags |= kHasSignature;
+
+    base[kVersionOffset] = kVersion;
+    base[kFlagsOffset] = flags;
+    base[kAuthorityOffset] = static_cast<byte>(header.FromAuthority());
+    detail::PutUint32(header.MessageId(), base + kMessageIdOffset);
+    detail::PutUint16(static_cast<uint16_t>(tag), base + kTagOffset);
+    detail::PutUint16(static_cast<uint16_t>(signature_bytes.size()), base + kSignatureSizeOffset);
+    detail::PutAddress(destination.first.data, base + kDestinationOffset);
+    if (destination.second)
+      detail::PutAddress(destination.second->data, base + kDestinationReplyToOffset);
+    detail::PutAddress(source.node_address.data, base + kSourceNodeOffset);
+    if (source.group_address)
+      detail::PutAddress(source.group_address->data, base + kSourceGroupOffset);
+    if (source.reply_to_address)
+      detail::PutAddress(source.reply_to_address->data, base + kSourceReplyToOffset);
+    std::copy(std::begin(signature_bytes), std::end(signature_bytes), base + kFixedSize);
+  }
+
+  static SerialisedMessage Write(const MessageHeader& header, MessageTypeTag tag) {
+    SerialisedMessage out;
+    Write(header, tag, out);
+    return out;
+  }
+
+  uint8_t Version() const { return data_[kVersionOffset]; }
+  MessageTypeTag Tag() const {
+    return static_cast<MessageTypeTag>(detail::GetUint16(data_ + kTagOffset));
+  }
+  uint32_t MessageId() const { return detail::GetUint32(data_ + kMessageIdOffset); }
+  Authority FromAuthority() const { return static_cast<Authority>(data_[kAuthorityOffset]); }
+
+  ByteRange Destination() const { return Slot(kDestinationOffset); }
+  boost::optional<ByteRange> DestinationReplyTo() const {
+    return OptionalSlot(kHasDestinationReplyTo, kDestinationReplyToOffset);
+  }
+  ByteRange FromNode() const { return Slot(kSourceNodeOffset); }
+  boost::optional<ByteRange> FromGroup() const {
+    return OptionalSlot(kHasSourceGroup, kSourceGroupOffset);
+  }
+  boost::optional<ByteRange> ReplyToAddress() const {
+    return OptionalSlot(kHasSourceReplyTo, kSourceReplyToOffset);
+  }
+  bool RelayedMessage() const { return (FlagsValue() & kHasSourceReplyTo) != 0; }
+  boost::optional<ByteRange> Signature() const {
+    if (!(FlagsValue() & kHasSignature))
+      return boost::none;
+    return ByteRange(data_ + kFixedSize, data_ + kFixedSize + SignatureSize());
+  }
+
+  // Size of the encoded header including the signature, i.e. the offset of the message body.
+  size_t Size() const { return kFixedSize + SignatureSize(); }
+  ByteRange Body() const { return ByteRange(data_ + Size(), data_ + size_); }
+
+  // Builds an owning MessageHeader from the viewed bytes (this copies every field).
+  MessageHeader ToMessageHeader() const {
+    DestinationAddress destination(std::make_pair(
+        routing::Destination(detail::GetAddress(Destination())), boost::none));
+    if (DestinationReplyTo())
+      destination.second = routing::ReplyToAddress(detail::GetAddress(*DestinationReplyTo()));
+    SourceAddress source(NodeAddress(detail::GetAddress(FromNode())), boost::none, boost::none);
+    if (FromGroup())
+      source.group_address = GroupAddress(detail::GetAddress(*FromGroup()));
+    if (ReplyToAddress())
+      source.reply_to_address = routing::ReplyToAddress(detail::GetAddress(*ReplyToAddress()));
+    if (Signature()) {
+      return MessageHeader(std::move(destination), std::move(source), MessageId(), FromAuthority(),
+                           asymm::Signature(std::string(Signature()->begin(),
+                                                        Signature()->end())));
+    }
+    return MessageHeader(std::move(destination), std::move(source), MessageId(), FromAuthority());
+  }
+
+ private:
+  static const size_t kVersionOffset = 0;
+  static const size_t kFlagsOffset = 1;
+  static const size_t kAuthorityOffset = 2;
+  static const size_t kMessageIdOffset = 4;
+  static const size_t kTagOffset = 8;
+  static const size_t kSignatureSizeOffset = 10;
+  static const size_t kDestinationOffset = 12;
+  static const size_t kDestinationReplyToOffset = kDestinationOffset + kAddressSize;
+  static const size_t kSourceNodeOffset = kDestinationReplyToOffset + kAddressSize;
+  static const size_t kSourceGroupOffset = kSourceNodeOffset + kAddressSize;
+  static const size_t kSourceReplyToOffset = kSourceGroupOffset + kAddressSize;
+
+  uint8_t FlagsValue() const { return data_[kFlagsOffset]; }
+  size_t SignatureSize() const { return detail::GetUint16(data_ + kSignatureSizeOffset); }
+
+  ByteRange Slot(size_t offset) const {
+    return ByteRange(data_ + offset, data_ + offset + kAddressSize);
+  }
+
+  boost::optional<ByteRange> OptionalSlot(uint8_t flag, size_t offset) const {
+    if (!(FlagsValue() & flag))
+      return boost::none;
+    return Slot(offset);
+  }
+
+  void Validate() const {
+    if (!data_ || size_ < kFixedSize || Version() != kVersion ||
+        ((FlagsValue() & kHasSignature) == 0) != (SignatureSize() == 0) || size_ < Size()) {
+      LOG(kWarning) << "Fixed layout header is invalid (" << size_ << " bytes).";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+    }
+  }
+
+  const byte* data_;
+  size_t size_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGE_HEADER_VIEW_H_
@@ -63,10 +63,11 @@ class Connect {
     archive(requester_endpoints_, requester_id_, receiver_id_, requester_fob_);
   }
 
-  EndpointPair requester_endpoints() const { return requester_endpoints_; }
-  Address requester_id() const { return requester_id_; }
-  Address receiver_id() const { return receiver_id_; }
-  passport::PublicPmid requester_fob() const { return requester_fob_; }
+  const EndpointPair& requester_endpoints() const { return requester_endpoints_; }
+  const Address& requester_id() const { return requester_id_; }
+  const Address& receiver_id() const { return receiver_id_; }
+  const passport::PublicPmid& requester_fob() const { return requester_fob_; }
+  passport::PublicPmid take_requester_fob() { return std::move(requester_fob_); }
 
  private:
   EndpointPair requester_endpoints_;
@@ -52,8 +52,8 @@ class FindGroup {
     archive(requester_id_, target_id_);
   }
 
-  NodeAddress requester_id() const { return requester_id_; }
-  Address target_id() const { return target_id_; }
+  const NodeAddress& requester_id() const { return requester_id_; }
+  const Address& target_id() const { return target_id_; }
 
  private:
   NodeAddress requester_id_;
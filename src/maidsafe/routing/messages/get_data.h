@@ -59,8 +59,8 @@ class GetData {
   }
 
   DataTagValue tag() const { return tag_; }
-  Identity name() const { return name_; }
-  SourceAddress requester() const { return requester_; }
+  const Identity& name() const { return name_; }
+  const SourceAddress& requester() const { return requester_; }
 
  private:
   DataTagValue tag_;
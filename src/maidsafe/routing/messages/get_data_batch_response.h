@@ -0,0 +1,81 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_GET_DATA_BATCH_RESPONSE_H_
+#define MAIDSAFE_ROUTING_MESSAGES_GET_DATA_BATCH_RESPONSE_H_
+
+#include <vector>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// The outcome of each entry of a GetDataBatch, in the order of the request's entries.  Each result
+// holds either the data or an error.
+class GetDataBatchResponse {
+ public:
+  struct Result {
+    template <typename Archive>
+    void serialize(Archive& archive) {
+      archive(data, error);
+    }
+
+    boost::optional<SerialisedData> data;
+    boost::optional<maidsafe_error> error;
+  };
+
+  GetDataBatchResponse() = default;
+  ~GetDataBatchResponse() = default;
+
+  explicit GetDataBatchResponse(std::vector<Result> results) : results_(std::move(results)) {}
+
+  GetDataBatchResponse(GetDataBatchResponse&& other) MAIDSAFE_NOEXCEPT
+      : results_(std::move(other.results_)) {}
+
+  GetDataBatchResponse& operator=(GetDataBatchResponse&& other) MAIDSAFE_NOEXCEPT {
+    results_ = std::move(other.results_);
+    return *this;
+  }
+
+  GetDataBatchResponse(const GetDataBatchResponse&) = delete;
+  GetDataBatchResponse& operator=(const GetDataBatchResponse&) = delete;
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(results_);
+  }
+
+  const std::vector<Result>& results() const { return results_; }
+  std::vector<Result> take_results() { return std::move(results_); }
+
+ private:
+  std::vector<Result> results_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_GET_DATA_BATCH_RESPONSE_H_
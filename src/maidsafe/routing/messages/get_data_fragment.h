@@ -0,0 +1,76 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_GET_DATA_FRAGMENT_H_
+#define MAIDSAFE_ROUTING_MESSAGES_GET_DATA_FRAGMENT_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/data_types/data_type_values.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Asks for fragment |index| of a payload too large for a single GetDataResponse.  The response
+// gives the number of fragments, so a requester starts by asking for fragment 0.
+class GetDataFragment {
+ public:
+  GetDataFragment() = default;
+  ~GetDataFragment() = default;
+
+  GetDataFragment(DataTagValue tag, Identity name, uint32_t index)
+      : tag_(tag), name_(std::move(name)), index_(index) {}
+
+  GetDataFragment(GetDataFragment&& other) MAIDSAFE_NOEXCEPT : tag_(std::move(other.tag_)),
+                                                               name_(std::move(other.name_)),
+                                                               index_(std::move(other.index_)) {}
+
+  GetDataFragment& operator=(GetDataFragment&& other) MAIDSAFE_NOEXCEPT {
+    tag_ = std::move(other.tag_);
+    name_ = std::move(other.name_);
+    index_ = std::move(other.index_);
+    return *this;
+  }
+
+  GetDataFragment(const GetDataFragment&) = delete;
+  GetDataFragment& operator=(const GetDataFragment&) = delete;
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(tag_, name_, index_);
+  }
+
+  DataTagValue tag() const { return tag_; }
+  const Identity& name() const { return name_; }
+  uint32_t index() const { return index_; }
+
+ private:
+  DataTagValue tag_;
+  Identity name_;
+  uint32_t index_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_GET_DATA_FRAGMENT_H_
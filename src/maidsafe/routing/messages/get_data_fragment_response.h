@@ -0,0 +1,105 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_GET_DATA_FRAGMENT_RESPONSE_H_
+#define MAIDSAFE_ROUTING_MESSAGES_GET_DATA_FRAGMENT_RESPONSE_H_
+
+#include <cstdint>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Fragment |index| of the |count| making up a payload of |total_size| bytes, or the error which
+// prevented it being fetched.
+class GetDataFragmentResponse {
+ public:
+  GetDataFragmentResponse() = default;
+  ~GetDataFragmentResponse() = default;
+
+  GetDataFragmentResponse(Identity name, uint32_t index, uint32_t count, uint64_t total_size,
+                          SerialisedData data)
+      : name_(std::move(name)),
+        index_(index),
+        count_(count),
+        total_size_(total_size),
+        data_(std::move(data)),
+        error_() {}
+
+  GetDataFragmentResponse(Identity name, uint32_t index, maidsafe_error error)
+      : name_(std::move(name)),
+        index_(index),
+        count_(0),
+        total_size_(0),
+        data_(),
+        error_(std::move(error)) {}
+
+  GetDataFragmentResponse(GetDataFragmentResponse&& other) MAIDSAFE_NOEXCEPT
+      : name_(std::move(other.name_)),
+        index_(std::move(other.index_)),
+        count_(std::move(other.count_)),
+        total_size_(std::move(other.total_size_)),
+        data_(std::move(other.data_)),
+        error_(std::move(other.error_)) {}
+
+  GetDataFragmentResponse& operator=(GetDataFragmentResponse&& other) MAIDSAFE_NOEXCEPT {
+    name_ = std::move(other.name_);
+    index_ = std::move(other.index_);
+    count_ = std::move(other.count_);
+    total_size_ = std::move(other.total_size_);
+    data_ = std::move(other.data_);
+    error_ = std::move(other.error_);
+    return *this;
+  }
+
+  GetDataFragmentResponse(const GetDataFragmentResponse&) = delete;
+  GetDataFragmentResponse& operator=(const GetDataFragmentResponse&) = delete;
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(name_, index_, count_, total_size_, data_, error_);
+  }
+
+  const Identity& name() const { return name_; }
+  uint32_t index() const { return index_; }
+  uint32_t count() const { return count_; }
+  uint64_t total_size() const { return total_size_; }
+  const boost::optional<SerialisedData>& data() const { return data_; }
+  const boost::optional<maidsafe_error>& error() const { return error_; }
+
+ private:
+  Identity name_;
+  uint32_t index_;
+  uint32_t count_;
+  uint64_t total_size_;
+  boost::optional<SerialisedData> data_;
+  boost::optional<maidsafe_error> error_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_GET_DATA_FRAGMENT_RESPONSE_H_
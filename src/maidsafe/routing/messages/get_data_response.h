@@ -60,9 +60,10 @@ class GetDataResponse {
     archive(name_, data_, error_);
   }
 
-  Identity name() const { return name_; }
-  boost::optional<SerialisedData> data() const { return data_; }
-  boost::optional<maidsafe_error> error() const { return error_; }
+  const Identity& name() const { return name_; }
+  const boost::optional<SerialisedData>& data() const { return data_; }
+  boost::optional<SerialisedData> take_data() { return std::move(data_); }
+  const boost::optional<maidsafe_error>& error() const { return error_; }
 
  private:
   Identity name_;
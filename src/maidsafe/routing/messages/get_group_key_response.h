@@ -0,0 +1,89 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_GET_GROUP_KEY_RESPONSE_H_
+#define MAIDSAFE_ROUTING_MESSAGES_GET_GROUP_KEY_RESPONSE_H_
+
+#include <vector>
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/passport/types.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+class GetGroupKeyResponse {
+ public:
+  GetGroupKeyResponse() = default;
+  ~GetGroupKeyResponse() = default;
+
+  GetGroupKeyResponse(GroupAddress group_address, std::vector<passport::PublicPmid> fobs)
+      : group_address_(std::move(group_address)), fobs_(std::move(fobs)) {}
+
+  GetGroupKeyResponse(GetGroupKeyResponse&& other) MAIDSAFE_NOEXCEPT
+      : group_address_(std::move(other.group_address_)),
+        fobs_(std::move(other.fobs_)) {}
+
+  GetGroupKeyResponse& operator=(GetGroupKeyResponse&& other) MAIDSAFE_NOEXCEPT {
+    group_address_ = std::move(other.group_address_);
+    fobs_ = std::move(other.fobs_);
+    return *this;
+  }
+
+  GetGroupKeyResponse(const GetGroupKeyResponse&) = delete;
+  GetGroupKeyResponse& operator=(const GetGroupKeyResponse&) = delete;
+
+  template <typename Archive>
+  Archive& load(Archive& archive) {
+    fobs_.clear();
+    std::size_t fobs_size(0);
+    archive(group_address_, fobs_size);
+    for (std::size_t i = 0; i < fobs_size; ++i) {
+      typename passport::PublicPmid::Name name;
+      typename passport::PublicPmid::serialised_type data;
+      archive(name, data);
+      fobs_.emplace_back(name, data);
+    }
+    return archive;
+  }
+
+  template <typename Archive>
+  Archive& save(Archive& archive) const {
+    archive(group_address_, fobs_.size());
+    for (const auto& fob : fobs_)
+      archive(fob.name(), fob.Serialise());
+    return archive;
+  }
+
+  const GroupAddress& group_address() const { return group_address_; }
+  const std::vector<passport::PublicPmid>& fobs() const { return fobs_; }
+  std::vector<passport::PublicPmid> take_fobs() { return std::move(fobs_); }
+
+ private:
+  GroupAddress group_address_;
+  std::vector<passport::PublicPmid> fobs_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_GET_GROUP_KEY_RESPONSE_H_
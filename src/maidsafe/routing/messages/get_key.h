@@ -0,0 +1,63 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_GET_KEY_H_
+#define MAIDSAFE_ROUTING_MESSAGES_GET_KEY_H_
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Requests the PublicPmid of a single node, which the group close to that node returns.
+class GetKey {
+ public:
+  GetKey() = default;
+  ~GetKey() = default;
+
+  explicit GetKey(NodeAddress node_address) : node_address_(std::move(node_address)) {}
+
+  GetKey(GetKey&& other) MAIDSAFE_NOEXCEPT : node_address_(std::move(other.node_address_)) {}
+
+  GetKey& operator=(GetKey&& other) MAIDSAFE_NOEXCEPT {
+    node_address_ = std::move(other.node_address_);
+    return *this;
+  }
+
+  GetKey(const GetKey&) = delete;
+  GetKey& operator=(const GetKey&) = delete;
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(node_address_);
+  }
+
+  const NodeAddress& node_address() const { return node_address_; }
+
+ private:
+  NodeAddress node_address_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_GET_KEY_H_
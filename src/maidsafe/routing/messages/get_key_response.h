@@ -0,0 +1,80 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_GET_KEY_RESPONSE_H_
+#define MAIDSAFE_ROUTING_MESSAGES_GET_KEY_RESPONSE_H_
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/passport/types.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+class GetKeyResponse {
+ public:
+  GetKeyResponse() = default;
+  ~GetKeyResponse() = default;
+
+  GetKeyResponse(NodeAddress node_address, passport::PublicPmid fob)
+      : node_address_(std::move(node_address)), fob_(std::move(fob)) {}
+
+  GetKeyResponse(GetKeyResponse&& other) MAIDSAFE_NOEXCEPT
+      : node_address_(std::move(other.node_address_)),
+        fob_(std::move(other.fob_)) {}
+
+  GetKeyResponse& operator=(GetKeyResponse&& other) MAIDSAFE_NOEXCEPT {
+    node_address_ = std::move(other.node_address_);
+    fob_ = std::move(other.fob_);
+    return *this;
+  }
+
+  GetKeyResponse(const GetKeyResponse&) = delete;
+  GetKeyResponse& operator=(const GetKeyResponse&) = delete;
+
+  template <typename Archive>
+  Archive& load(Archive& archive) {
+    typename passport::PublicPmid::Name name;
+    typename passport::PublicPmid::serialised_type data;
+    archive(node_address_, name, data);
+    fob_ = passport::PublicPmid(name, data);
+    return archive;
+  }
+
+  template <typename Archive>
+  Archive& save(Archive& archive) const {
+    archive(node_address_, fob_.name(), fob_.Serialise());
+    return archive;
+  }
+
+  const NodeAddress& node_address() const { return node_address_; }
+  const passport::PublicPmid& fob() const { return fob_; }
+  passport::PublicPmid take_fob() { return std::move(fob_); }
+
+ private:
+  NodeAddress node_address_;
+  passport::PublicPmid fob_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_GET_KEY_RESPONSE_H_
@@ -24,9 +24,22 @@
 #include "maidsafe/routing/messages/find_group.h"
 #include "maidsafe/routing/messages/find_group_response.h"
 #include "maidsafe/routing/messages/get_data.h"
+#include "maidsafe/routing/messages/get_data_batch.h"
+#include "maidsafe/routing/messages/get_data_batch_response.h"
+#include "maidsafe/routing/messages/get_data_fragment.h"
+#include "maidsafe/routing/messages/get_data_fragment_response.h"
 #include "maidsafe/routing/messages/get_data_response.h"
+#include "maidsafe/routing/messages/get_group_key.h"
+#include "maidsafe/routing/messages/get_group_key_response.h"
+#include "maidsafe/routing/messages/get_key.h"
+#include "maidsafe/routing/messages/get_key_response.h"
 #include "maidsafe/routing/messages/post.h"
+#include "maidsafe/routing/messages/post_response.h"
 #include "maidsafe/routing/messages/put_data.h"
+#include "maidsafe/routing/messages/put_data_batch.h"
+#include "maidsafe/routing/messages/put_data_batch_response.h"
+#include "maidsafe/routing/messages/put_data_fragment.h"
 #include "maidsafe/routing/messages/put_data_response.h"
+#include "maidsafe/routing/messages/put_key.h"
 
 #endif  // MAIDSAFE_ROUTING_MESSAGES_MESSAGES_H_
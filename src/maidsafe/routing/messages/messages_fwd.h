@@ -19,7 +19,9 @@
 #ifndef MAIDSAFE_ROUTING_MESSAGES_MESSAGES_FWD_H_
 #define MAIDSAFE_ROUTING_MESSAGES_MESSAGES_FWD_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 namespace maidsafe {
 
@@ -40,72 +42,145 @@ enum class MessageTypeTag : uint16_t {
   PostResponse,
   PutData,
   PutDataResponse,
-  PutKey
+  PutKey,
+  PutDataBatch,
+  PutDataBatchResponse,
+  GetDataBatch,
+  GetDataBatchResponse,
+  PutDataFragment,
+  GetDataFragment,
+  GetDataFragmentResponse
 };
 
+// Must be updated whenever a tag is appended above.  message_dispatch.h checks at compile time
+// that AllMessageTypes has exactly one entry per tag, in tag order.
+const uint16_t kMessageTypeTagCount =
+    static_cast<uint16_t>(MessageTypeTag::GetDataFragmentResponse) + 1;
+
 class Connect;
 class ConnectResponse;
 class FindGroup;
 class FindGroupResponse;
 class GetData;
 class GetDataResponse;
+class GetKey;
+class GetKeyResponse;
+class GetGroupKey;
+class GetGroupKeyResponse;
 class Post;
 class PostResponse;
 class PutData;
 class PutDataResponse;
+class PutKey;
+class PutDataBatch;
+class PutDataBatchResponse;
+class GetDataBatch;
+class GetDataBatchResponse;
+class PutDataFragment;
+class GetDataFragment;
+class GetDataFragmentResponse;
+
+template <typename... Types>
+struct TypeList {
+  static const std::size_t size = sizeof...(Types);
+};
+
+// Every message type, in MessageTypeTag order.
+using AllMessageTypes =
+    TypeList<Connect, ConnectResponse, FindGroup, FindGroupResponse, GetData, GetDataResponse,
+             GetKey, GetKeyResponse, GetGroupKey, GetGroupKeyResponse, Post, PostResponse, PutData,
+             PutDataResponse, PutKey, PutDataBatch, PutDataBatchResponse, GetDataBatch,
+             GetDataBatchResponse, PutDataFragment, GetDataFragment, GetDataFragmentResponse>;
 
+// Defined in routing/message_dispatch.h
+template <typename Handler, typename List = AllMessageTypes>
+class MessageDispatcher;
+
+// The tag of each message type, as MessageToTag<Message>::value.
 template <class T>
 struct MessageToTag;
 
 template <>
-struct MessageToTag<Connect> {
-  static MessageTypeTag value() { return MessageTypeTag::Connect; }
-};
+struct MessageToTag<Connect> : std::integral_constant<MessageTypeTag, MessageTypeTag::Connect> {};
 
 template <>
-struct MessageToTag<ConnectResponse> {
-  static MessageTypeTag value() { return MessageTypeTag::ConnectResponse; }
-};
+struct MessageToTag<ConnectResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::ConnectResponse> {};
 
 template <>
-struct MessageToTag<FindGroup> {
-  static MessageTypeTag value() { return MessageTypeTag::FindGroup; }
-};
+struct MessageToTag<FindGroup>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::FindGroup> {};
 
 template <>
-struct MessageToTag<FindGroupResponse> {
-  static MessageTypeTag value() { return MessageTypeTag::FindGroupResponse; }
-};
+struct MessageToTag<FindGroupResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::FindGroupResponse> {};
 
 template <>
-struct MessageToTag<GetData> {
-  static MessageTypeTag value() { return MessageTypeTag::GetData; }
-};
+struct MessageToTag<GetData> : std::integral_constant<MessageTypeTag, MessageTypeTag::GetData> {};
 
 template <>
-struct MessageToTag<GetDataResponse> {
-  static MessageTypeTag value() { return MessageTypeTag::GetDataResponse; }
-};
+struct MessageToTag<GetDataResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::GetDataResponse> {};
 
 template <>
-struct MessageToTag<PutData> {
-  static MessageTypeTag value() { return MessageTypeTag::PutData; }
-};
+struct MessageToTag<GetKey> : std::integral_constant<MessageTypeTag, MessageTypeTag::GetKey> {};
 
 template <>
-struct MessageToTag<PutDataResponse> {
-  static MessageTypeTag value() { return MessageTypeTag::PutDataResponse; }
-};
+struct MessageToTag<GetKeyResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::GetKeyResponse> {};
 
 template <>
-struct MessageToTag<Post> {
-  static MessageTypeTag value() { return MessageTypeTag::Post; }
-};
+struct MessageToTag<GetGroupKey>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::GetGroupKey> {};
 
 template <>
-struct MessageToTag<PostResponse> {
-  static MessageTypeTag value() { return MessageTypeTag::PostResponse; }
-};
+struct MessageToTag<GetGroupKeyResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::GetGroupKeyResponse> {};
+
+template <>
+struct MessageToTag<PutData> : std::integral_constant<MessageTypeTag, MessageTypeTag::PutData> {};
+
+template <>
+struct MessageToTag<PutDataResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::PutDataResponse> {};
+
+template <>
+struct MessageToTag<Post> : std::integral_constant<MessageTypeTag, MessageTypeTag::Post> {};
+
+template <>
+struct MessageToTag<PostResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::PostResponse> {};
+
+template <>
+struct MessageToTag<PutKey> : std::integral_constant<MessageTypeTag, MessageTypeTag::PutKey> {};
+
+template <>
+struct MessageToTag<PutDataBatch>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::PutDataBatch> {};
+
+template <>
+struct MessageToTag<PutDataBatchResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::PutDataBatchResponse> {};
+
+template <>
+struct MessageToTag<GetDataBatch>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::GetDataBatch> {};
+
+template <>
+struct MessageToTag<GetDataBatchResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::GetDataBatchResponse> {};
+
+template <>
+struct MessageToTag<PutDataFragment>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::PutDataFragment> {};
+
+template <>
+struct MessageToTag<GetDataFragment>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::GetDataFragment> {};
+
+template <>
+struct MessageToTag<GetDataFragmentResponse>
+    : std::integral_constant<MessageTypeTag, MessageTypeTag::GetDataFragmentResponse> {};
 
 }  // namespace routing
 
@@ -56,8 +56,9 @@ class Post {
   }
 
   DataTagValue tag() const { return tag_; }
-  Identity name() const { return name_; }
-  SerialisedData data() const { return data_; }
+  const Identity& name() const { return name_; }
+  const SerialisedData& data() const { return data_; }
+  SerialisedData take_data() { return std::move(data_); }
 
  private:
   DataTagValue tag_;
@@ -0,0 +1,83 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_POST_RESPONSE_H_
+#define MAIDSAFE_ROUTING_MESSAGES_POST_RESPONSE_H_
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/data_types/data_type_values.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+class PostResponse {
+ public:
+  PostResponse() = default;
+  ~PostResponse() = default;
+
+  PostResponse(DataTagValue tag, Identity name, SerialisedData data)
+      : tag_(tag), name_(std::move(name)), data_(std::move(data)), error_() {}
+
+  PostResponse(DataTagValue tag, Identity name, maidsafe_error error)
+      : tag_(tag), name_(std::move(name)), data_(), error_(std::move(error)) {}
+
+  PostResponse(PostResponse&& other) MAIDSAFE_NOEXCEPT : tag_(std::move(other.tag_)),
+                                                         name_(std::move(other.name_)),
+                                                         data_(std::move(other.data_)),
+                                                         error_(std::move(other.error_)) {}
+
+  PostResponse& operator=(PostResponse&& other) MAIDSAFE_NOEXCEPT {
+    tag_ = std::move(other.tag_);
+    name_ = std::move(other.name_);
+    data_ = std::move(other.data_);
+    error_ = std::move(other.error_);
+    return *this;
+  }
+
+  PostResponse(const PostResponse&) = delete;
+  PostResponse& operator=(const PostResponse&) = delete;
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(tag_, name_, data_, error_);
+  }
+
+  DataTagValue tag() const { return tag_; }
+  const Identity& name() const { return name_; }
+  const SerialisedData& data() const { return data_; }
+  SerialisedData take_data() { return std::move(data_); }
+  const boost::optional<maidsafe_error>& error() const { return error_; }
+
+ private:
+  DataTagValue tag_;
+  Identity name_;
+  SerialisedData data_;
+  boost::optional<maidsafe_error> error_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_POST_RESPONSE_H_
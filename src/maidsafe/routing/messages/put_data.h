@@ -52,7 +52,8 @@ class PutData {
   }
 
   DataTagValue tag() const { return tag_; }
-  SerialisedData data() const { return data_; }
+  const SerialisedData& data() const { return data_; }
+  SerialisedData take_data() { return std::move(data_); }
 
  private:
   DataTagValue tag_;
@@ -0,0 +1,79 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_BATCH_H_
+#define MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_BATCH_H_
+
+#include <vector>
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/data_types/data_type_values.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Many PutData requests sent to the same next hop in one message.  Each entry is routed by its
+// own name.
+class PutDataBatch {
+ public:
+  struct Entry {
+    template <typename Archive>
+    void serialize(Archive& archive) {
+      archive(tag, name, data);
+    }
+
+    DataTagValue tag;
+    Identity name;
+    SerialisedData data;
+  };
+
+  PutDataBatch() = default;
+  ~PutDataBatch() = default;
+
+  explicit PutDataBatch(std::vector<Entry> entries) : entries_(std::move(entries)) {}
+
+  PutDataBatch(PutDataBatch&& other) MAIDSAFE_NOEXCEPT : entries_(std::move(other.entries_)) {}
+
+  PutDataBatch& operator=(PutDataBatch&& other) MAIDSAFE_NOEXCEPT {
+    entries_ = std::move(other.entries_);
+    return *this;
+  }
+
+  PutDataBatch(const PutDataBatch&) = delete;
+  PutDataBatch& operator=(const PutDataBatch&) = delete;
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(entries_);
+  }
+
+  const std::vector<Entry>& entries() const { return entries_; }
+  std::vector<Entry> take_entries() { return std::move(entries_); }
+
+ private:
+  std::vector<Entry> entries_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_BATCH_H_
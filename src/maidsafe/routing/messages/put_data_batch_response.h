@@ -0,0 +1,66 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_BATCH_RESPONSE_H_
+#define MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_BATCH_RESPONSE_H_
+
+#include <vector>
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// The outcome of each entry of a PutDataBatch, in the order of the request's entries.
+class PutDataBatchResponse {
+ public:
+  PutDataBatchResponse() = default;
+  ~PutDataBatchResponse() = default;
+
+  explicit PutDataBatchResponse(std::vector<maidsafe_error> errors) : errors_(std::move(errors)) {}
+
+  PutDataBatchResponse(PutDataBatchResponse&& other) MAIDSAFE_NOEXCEPT
+      : errors_(std::move(other.errors_)) {}
+
+  PutDataBatchResponse& operator=(PutDataBatchResponse&& other) MAIDSAFE_NOEXCEPT {
+    errors_ = std::move(other.errors_);
+    return *this;
+  }
+
+  PutDataBatchResponse(const PutDataBatchResponse&) = delete;
+  PutDataBatchResponse& operator=(const PutDataBatchResponse&) = delete;
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(errors_);
+  }
+
+  const std::vector<maidsafe_error>& errors() const { return errors_; }
+
+ private:
+  std::vector<maidsafe_error> errors_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_BATCH_RESPONSE_H_
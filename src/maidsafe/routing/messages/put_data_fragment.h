@@ -0,0 +1,96 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_FRAGMENT_H_
+#define MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_FRAGMENT_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/data_types/data_type_values.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// One of |count| fragments of a payload too large for a single PutData.  The destination group
+// reassembles the fragments and stores the payload as a PutData of |tag|, acknowledging each
+// fragment with a PutDataResponse.
+class PutDataFragment {
+ public:
+  PutDataFragment() = default;
+  ~PutDataFragment() = default;
+
+  PutDataFragment(DataTagValue tag, Identity name, uint32_t index, uint32_t count,
+                  uint64_t total_size, SerialisedData data)
+      : tag_(tag),
+        name_(std::move(name)),
+        index_(index),
+        count_(count),
+        total_size_(total_size),
+        data_(std::move(data)) {}
+
+  PutDataFragment(PutDataFragment&& other) MAIDSAFE_NOEXCEPT
+      : tag_(std::move(other.tag_)),
+        name_(std::move(other.name_)),
+        index_(std::move(other.index_)),
+        count_(std::move(other.count_)),
+        total_size_(std::move(other.total_size_)),
+        data_(std::move(other.data_)) {}
+
+  PutDataFragment& operator=(PutDataFragment&& other) MAIDSAFE_NOEXCEPT {
+    tag_ = std::move(other.tag_);
+    name_ = std::move(other.name_);
+    index_ = std::move(other.index_);
+    count_ = std::move(other.count_);
+    total_size_ = std::move(other.total_size_);
+    data_ = std::move(other.data_);
+    return *this;
+  }
+
+  PutDataFragment(const PutDataFragment&) = delete;
+  PutDataFragment& operator=(const PutDataFragment&) = delete;
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(tag_, name_, index_, count_, total_size_, data_);
+  }
+
+  DataTagValue tag() const { return tag_; }
+  const Identity& name() const { return name_; }
+  uint32_t index() const { return index_; }
+  uint32_t count() const { return count_; }
+  uint64_t total_size() const { return total_size_; }
+  const SerialisedData& data() const { return data_; }
+
+ private:
+  DataTagValue tag_;
+  Identity name_;
+  uint32_t index_;
+  uint32_t count_;
+  uint64_t total_size_;
+  SerialisedData data_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_PUT_DATA_FRAGMENT_H_
@@ -56,8 +56,9 @@ class PutDataResponse {
   }
 
   DataTagValue tag() const { return tag_; }
-  SerialisedData data() const { return data_; }
-  maidsafe_error error() const { return error_; }
+  const SerialisedData& data() const { return data_; }
+  SerialisedData take_data() { return std::move(data_); }
+  const maidsafe_error& error() const { return error_; }
 
  private:
   DataTagValue tag_;
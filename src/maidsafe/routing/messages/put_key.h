@@ -0,0 +1,73 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGES_PUT_KEY_H_
+#define MAIDSAFE_ROUTING_MESSAGES_PUT_KEY_H_
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/passport/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Asks the group close to the fob's name to store it so that it can later be retrieved by GetKey.
+class PutKey {
+ public:
+  PutKey() = default;
+  ~PutKey() = default;
+
+  explicit PutKey(passport::PublicPmid fob) : fob_(std::move(fob)) {}
+
+  PutKey(PutKey&& other) MAIDSAFE_NOEXCEPT : fob_(std::move(other.fob_)) {}
+
+  PutKey& operator=(PutKey&& other) MAIDSAFE_NOEXCEPT {
+    fob_ = std::move(other.fob_);
+    return *this;
+  }
+
+  PutKey(const PutKey&) = delete;
+  PutKey& operator=(const PutKey&) = delete;
+
+  template <typename Archive>
+  Archive& load(Archive& archive) {
+    typename passport::PublicPmid::Name name;
+    typename passport::PublicPmid::serialised_type data;
+    archive(name, data);
+    fob_ = passport::PublicPmid(name, data);
+    return archive;
+  }
+
+  template <typename Archive>
+  Archive& save(Archive& archive) const {
+    archive(fob_.name(), fob_.Serialise());
+    return archive;
+  }
+
+  const passport::PublicPmid& fob() const { return fob_; }
+  passport::PublicPmid take_fob() { return std::move(fob_); }
+
+ private:
+  passport::PublicPmid fob_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGES_PUT_KEY_H_
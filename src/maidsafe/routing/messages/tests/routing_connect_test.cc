@@ -50,7 +50,7 @@ TEST(ConnectTest, BEH_SerialiseParse) {
   // Serialise
   auto connect_before(GenerateInstance());
   auto header_before(GetRandomMessageHeader());
-  auto tag_before(MessageToTag<Connect>::value());
+  auto tag_before(MessageToTag<Connect>::value);
 
   auto serialised_connect(Serialise(header_before, tag_before, connect_before));
 
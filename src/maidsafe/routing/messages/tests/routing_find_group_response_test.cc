@@ -48,7 +48,7 @@ TEST(FindGroupResponseTest, BEH_SerialiseParse) {
   // Serialise
   auto find_grp_resp_before(GenerateInstance());
   auto header_before(GetRandomMessageHeader());
-  auto tag_before(MessageToTag<FindGroupResponse>::value());
+  auto tag_before(MessageToTag<FindGroupResponse>::value);
 
   auto serialised_find_grp_rsp(Serialise(header_before, tag_before, find_grp_resp_before));
 
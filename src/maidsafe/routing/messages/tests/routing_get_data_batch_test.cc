@@ -0,0 +1,116 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/messages/get_data_batch.h"
+
+#include <vector>
+
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/messages/get_data_batch_response.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+GetDataBatch GenerateInstance() {
+  std::vector<GetDataBatch::Entry> entries;
+  for (int i(0); i != 10; ++i) {
+    entries.push_back(GetDataBatch::Entry{DataTagValue::kImmutableDataValue,
+                                          Identity{RandomString(Address::kSize)}});
+  }
+  return GetDataBatch{std::move(entries), GetRandomMessageHeader().Source()};
+}
+
+}  // anonymous namespace
+
+TEST(GetDataBatchTest, BEH_SerialiseParse) {
+  // Serialise
+  auto get_data_batch_before(GenerateInstance());
+  auto header_before(GetRandomMessageHeader());
+  auto tag_before(MessageToTag<GetDataBatch>::value);
+
+  auto serialised_get_data_batch(Serialise(header_before, tag_before, get_data_batch_before));
+
+  // Parse
+  GetDataBatch get_data_batch_after;
+  auto header_after(GetRandomMessageHeader());
+  auto tag_after(MessageTypeTag{});
+
+  InputVectorStream binary_input_stream{serialised_get_data_batch};
+
+  // Parse Header, Tag
+  Parse(binary_input_stream, header_after, tag_after);
+
+  EXPECT_EQ(header_before, header_after);
+  EXPECT_EQ(tag_before, tag_after);
+
+  // Parse the rest
+  Parse(binary_input_stream, get_data_batch_after);
+
+  const auto& before(get_data_batch_before.entries());
+  const auto& after(get_data_batch_after.entries());
+  ASSERT_EQ(before.size(), after.size());
+  for (size_t i(0); i < before.size(); ++i) {
+    EXPECT_EQ(before[i].tag, after[i].tag);
+    EXPECT_EQ(before[i].name, after[i].name);
+  }
+  EXPECT_EQ(get_data_batch_before.requester(), get_data_batch_after.requester());
+}
+
+TEST(GetDataBatchTest, BEH_ResponseSerialiseParse) {
+  const auto serialised_data(RandomString(Address::kSize));
+  std::vector<GetDataBatchResponse::Result> results(2);
+  results[0].data = SerialisedData(serialised_data.begin(), serialised_data.end());
+  results[1].error = MakeError(CommonErrors::no_such_element);
+  GetDataBatchResponse response_before(results);
+  auto serialised_response(Serialise(GetRandomMessageHeader(),
+                                     MessageToTag<GetDataBatchResponse>::value,
+                                     response_before));
+
+  InputVectorStream binary_input_stream{serialised_response};
+  MessageHeader header_after;
+  MessageTypeTag tag_after;
+  Parse(binary_input_stream, header_after, tag_after);
+  EXPECT_EQ(MessageTypeTag::GetDataBatchResponse, tag_after);
+  GetDataBatchResponse response_after;
+  Parse(binary_input_stream, response_after);
+
+  ASSERT_EQ(2U, response_after.results().size());
+  EXPECT_EQ(results[0].data, response_after.results()[0].data);
+  EXPECT_FALSE(response_after.results()[0].error);
+  EXPECT_FALSE(response_after.results()[1].data);
+  ASSERT_TRUE(response_after.results()[1].error);
+  EXPECT_EQ(results[1].error->code(), response_after.results()[1].error->code());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,112 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/messages/get_data_fragment.h"
+
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/messages/get_data_fragment_response.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+GetDataFragment GenerateInstance() {
+  return GetDataFragment{DataTagValue::kImmutableDataValue, Identity{RandomString(Address::kSize)},
+                         RandomUint32() % 100};
+}
+
+}  // anonymous namespace
+
+TEST(GetDataFragmentTest, BEH_SerialiseParse) {
+  // Serialise
+  auto get_data_fragment_before(GenerateInstance());
+  auto header_before(GetRandomMessageHeader());
+  auto tag_before(MessageToTag<GetDataFragment>::value);
+
+  auto serialised_get_data_fragment(
+      Serialise(header_before, tag_before, get_data_fragment_before));
+
+  // Parse
+  GetDataFragment get_data_fragment_after;
+  auto header_after(GetRandomMessageHeader());
+  auto tag_after(MessageTypeTag{});
+
+  InputVectorStream binary_input_stream{serialised_get_data_fragment};
+
+  // Parse Header, Tag
+  Parse(binary_input_stream, header_after, tag_after);
+
+  EXPECT_EQ(header_before, header_after);
+  EXPECT_EQ(tag_before, tag_after);
+
+  // Parse the rest
+  Parse(binary_input_stream, get_data_fragment_after);
+
+  EXPECT_EQ(get_data_fragment_before.tag(), get_data_fragment_after.tag());
+  EXPECT_EQ(get_data_fragment_before.name(), get_data_fragment_after.name());
+  EXPECT_EQ(get_data_fragment_before.index(), get_data_fragment_after.index());
+}
+
+TEST(GetDataFragmentTest, BEH_ResponseSerialiseParse) {
+  const Identity name{RandomString(Address::kSize)};
+  const auto serialised_data(RandomString(Address::kSize));
+  const SerialisedData data(serialised_data.begin(), serialised_data.end());
+  GetDataFragmentResponse data_before(name, 2, 5, 4 * 1024 * 1024, data);
+  GetDataFragmentResponse error_before(name, 9, MakeError(CommonErrors::invalid_parameter));
+
+  for (auto* response_before : {&data_before, &error_before}) {
+    auto serialised_response(Serialise(GetRandomMessageHeader(),
+                                       MessageToTag<GetDataFragmentResponse>::value,
+                                       *response_before));
+
+    InputVectorStream binary_input_stream{serialised_response};
+    MessageHeader header_after;
+    MessageTypeTag tag_after;
+    Parse(binary_input_stream, header_after, tag_after);
+    EXPECT_EQ(MessageTypeTag::GetDataFragmentResponse, tag_after);
+    GetDataFragmentResponse response_after;
+    Parse(binary_input_stream, response_after);
+
+    EXPECT_EQ(response_before->name(), response_after.name());
+    EXPECT_EQ(response_before->index(), response_after.index());
+    EXPECT_EQ(response_before->count(), response_after.count());
+    EXPECT_EQ(response_before->total_size(), response_after.total_size());
+    EXPECT_EQ(response_before->data(), response_after.data());
+    ASSERT_EQ(static_cast<bool>(response_before->error()),
+              static_cast<bool>(response_after.error()));
+    if (response_before->error())
+      EXPECT_EQ(response_before->error()->code(), response_after.error()->code());
+  }
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -39,7 +39,7 @@ TEST(GetDataTest, BEH_SerialiseParse) {
       DataTagValue::kPmidValue, Identity(RandomString(Address::kSize)),
       SourceAddress(NodeAddress(Address(RandomString(Address::kSize))), boost::none, boost::none)));
   auto header_before(GetRandomMessageHeader());
-  auto tag_before(MessageToTag<GetData>::value());
+  auto tag_before(MessageToTag<GetData>::value);
 
   auto serialised_get_data(Serialise(header_before, tag_before, get_data_before));
 
@@ -0,0 +1,83 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/messages/get_group_key_response.h"
+
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+GetGroupKeyResponse GenerateInstance() {
+  std::vector<passport::PublicPmid> fobs;
+  for (size_t i(0); i < 3; ++i)
+    fobs.emplace_back(passport::CreatePmidAndSigner().first);
+  return GetGroupKeyResponse{GroupAddress(Address{RandomString(Address::kSize)}), fobs};
+}
+
+}  // anonymous namespace
+
+TEST(GetGroupKeyResponseTest, BEH_SerialiseParse) {
+  // Serialise
+  auto get_group_key_rsp_before(GenerateInstance());
+  auto header_before(GetRandomMessageHeader());
+  auto tag_before(MessageToTag<GetGroupKeyResponse>::value);
+
+  auto serialised_get_group_key_rsp(Serialise(header_before, tag_before, get_group_key_rsp_before));
+
+  // Parse
+  GetGroupKeyResponse get_group_key_rsp_after;
+  auto header_after(GetRandomMessageHeader());
+  auto tag_after(MessageTypeTag{});
+
+  InputVectorStream binary_input_stream{serialised_get_group_key_rsp};
+
+  // Parse Header, Tag
+  Parse(binary_input_stream, header_after, tag_after);
+
+  EXPECT_EQ(header_before, header_after);
+  EXPECT_EQ(tag_before, tag_after);
+
+  // Parse the rest
+  Parse(binary_input_stream, get_group_key_rsp_after);
+
+  EXPECT_EQ(get_group_key_rsp_before.group_address(), get_group_key_rsp_after.group_address());
+  ASSERT_EQ(get_group_key_rsp_before.fobs().size(), get_group_key_rsp_after.fobs().size());
+  for (size_t i(0); i < get_group_key_rsp_before.fobs().size(); ++i)
+    EXPECT_EQ(get_group_key_rsp_before.fobs()[i].name(), get_group_key_rsp_after.fobs()[i].name());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -49,7 +49,7 @@ TEST(PostTest, BEH_SerialiseParse) {
   // Serialise
   auto post_before(GenerateInstance());
   auto header_before(GetRandomMessageHeader());
-  auto tag_before(MessageToTag<Post>::value());
+  auto tag_before(MessageToTag<Post>::value);
 
   auto serialised_post(Serialise(header_before, tag_before, post_before));
 
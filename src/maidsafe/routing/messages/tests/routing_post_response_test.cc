@@ -0,0 +1,80 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/messages/post_response.h"
+
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+PostResponse GenerateInstance() {
+  const auto serialised_data(RandomString(Address::kSize));
+  return PostResponse{DataTagValue::kPmidValue, Identity{RandomString(Address::kSize)},
+                      SerialisedData(serialised_data.begin(), serialised_data.end())};
+}
+
+}  // anonymous namespace
+
+TEST(PostResponseTest, BEH_SerialiseParse) {
+  // Serialise
+  auto post_rsp_before(GenerateInstance());
+  auto header_before(GetRandomMessageHeader());
+  auto tag_before(MessageToTag<PostResponse>::value);
+
+  auto serialised_post_rsp(Serialise(header_before, tag_before, post_rsp_before));
+
+  // Parse
+  PostResponse post_rsp_after;
+  auto header_after(GetRandomMessageHeader());
+  auto tag_after(MessageTypeTag{});
+
+  InputVectorStream binary_input_stream{serialised_post_rsp};
+
+  // Parse Header, Tag
+  Parse(binary_input_stream, header_after, tag_after);
+
+  EXPECT_EQ(header_before, header_after);
+  EXPECT_EQ(tag_before, tag_after);
+
+  // Parse the rest
+  Parse(binary_input_stream, post_rsp_after);
+
+  EXPECT_EQ(post_rsp_before.tag(), post_rsp_after.tag());
+  EXPECT_EQ(post_rsp_before.name(), post_rsp_after.name());
+  EXPECT_EQ(post_rsp_before.data(), post_rsp_after.data());
+  EXPECT_FALSE(post_rsp_after.error());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,114 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/messages/put_data_batch.h"
+
+#include <vector>
+
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+#include "maidsafe/routing/messages/put_data_batch_response.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+PutDataBatch GenerateInstance() {
+  std::vector<PutDataBatch::Entry> entries;
+  for (int i(0); i != 10; ++i) {
+    const auto serialised_data(RandomString(1 + RandomUint32() % 100));
+    entries.push_back(PutDataBatch::Entry{
+        DataTagValue::kImmutableDataValue, Identity{RandomString(Address::kSize)},
+        SerialisedData(serialised_data.begin(), serialised_data.end())});
+  }
+  return PutDataBatch{std::move(entries)};
+}
+
+}  // anonymous namespace
+
+TEST(PutDataBatchTest, BEH_SerialiseParse) {
+  // Serialise
+  auto put_data_batch_before(GenerateInstance());
+  auto header_before(GetRandomMessageHeader());
+  auto tag_before(MessageToTag<PutDataBatch>::value);
+
+  auto serialised_put_data_batch(Serialise(header_before, tag_before, put_data_batch_before));
+
+  // Parse
+  PutDataBatch put_data_batch_after;
+  auto header_after(GetRandomMessageHeader());
+  auto tag_after(MessageTypeTag{});
+
+  InputVectorStream binary_input_stream{serialised_put_data_batch};
+
+  // Parse Header, Tag
+  Parse(binary_input_stream, header_after, tag_after);
+
+  EXPECT_EQ(header_before, header_after);
+  EXPECT_EQ(tag_before, tag_after);
+
+  // Parse the rest
+  Parse(binary_input_stream, put_data_batch_after);
+
+  const auto& before(put_data_batch_before.entries());
+  const auto& after(put_data_batch_after.entries());
+  ASSERT_EQ(before.size(), after.size());
+  for (size_t i(0); i < before.size(); ++i) {
+    EXPECT_EQ(before[i].tag, after[i].tag);
+    EXPECT_EQ(before[i].name, after[i].name);
+    EXPECT_EQ(before[i].data, after[i].data);
+  }
+}
+
+TEST(PutDataBatchTest, BEH_ResponseSerialiseParse) {
+  const std::vector<maidsafe_error> errors{MakeError(CommonErrors::success),
+                                          MakeError(CommonErrors::invalid_parameter),
+                                          MakeError(CommonErrors::success)};
+  PutDataBatchResponse response_before(errors);
+  auto serialised_response(Serialise(GetRandomMessageHeader(),
+                                     MessageToTag<PutDataBatchResponse>::value,
+                                     response_before));
+
+  InputVectorStream binary_input_stream{serialised_response};
+  MessageHeader header_after;
+  MessageTypeTag tag_after;
+  Parse(binary_input_stream, header_after, tag_after);
+  EXPECT_EQ(MessageTypeTag::PutDataBatchResponse, tag_after);
+  PutDataBatchResponse response_after;
+  Parse(binary_input_stream, response_after);
+
+  ASSERT_EQ(errors.size(), response_after.errors().size());
+  for (size_t i(0); i < errors.size(); ++i)
+    EXPECT_EQ(errors[i].code(), response_after.errors()[i].code());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
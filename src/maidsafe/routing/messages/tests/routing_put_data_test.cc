@@ -48,7 +48,7 @@ TEST(PutDataTest, BEH_SerialiseParse) {
   // Serialise
   auto put_data_before(GenerateInstance());
   auto header_before(GetRandomMessageHeader());
-  auto tag_before(MessageToTag<PutData>::value());
+  auto tag_before(MessageToTag<PutData>::value);
 
   auto serialised_put_data(Serialise(header_before, tag_before, put_data_before));
 
@@ -74,6 +74,18 @@ TEST(PutDataTest, BEH_SerialiseParse) {
   EXPECT_EQ(put_data_before.data(), put_data_after.data());
 }
 
+TEST(PutDataTest, BEH_TakeData) {
+  auto put_data(GenerateInstance());
+  const auto* const payload(put_data.data().data());
+  const auto expected(put_data.data());
+
+  auto taken(put_data.take_data());
+  EXPECT_EQ(expected, taken);
+  // The buffer is moved out, not copied
+  EXPECT_EQ(payload, taken.data());
+  EXPECT_TRUE(put_data.data().empty());
+}
+
 }  // namespace test
 
 }  // namespace routing
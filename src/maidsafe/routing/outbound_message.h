@@ -0,0 +1,108 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_OUTBOUND_MESSAGE_H_
+#define MAIDSAFE_ROUTING_OUTBOUND_MESSAGE_H_
+
+#include <memory>
+#include <utility>
+
+#include "asio/error_code.hpp"
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/routing/connection_manager.h"
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/peer_node.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Serialises a header, tag and message body exactly once and shares the resulting buffer between
+// every peer it is sent to, rather than re-serialising (or copying) per target.  No header field
+// is rewritten per hop in the current protocol, so recipients all receive identical bytes.
+class OutboundMessage {
+ public:
+  template <typename Message>
+  OutboundMessage(const MessageHeader& header, const Message& message)
+      : serialised_(std::make_shared<const SerialisedMessage>(
+            Serialise(header, MessageToTag<Message>::value, message))) {}
+
+  // Prepends the header and tag to an already serialised body.  The binary archive writes no
+  // framing, so this produces the same bytes as serialising the header, tag and message together.
+  OutboundMessage(const MessageHeader& header, MessageTypeTag tag, const SerialisedData& body)
+      : serialised_() {
+    auto serialised(Serialise(header, tag));
+    serialised.insert(std::end(serialised), std::begin(body), std::end(body));
+    serialised_ = std::make_shared<const SerialisedMessage>(std::move(serialised));
+  }
+
+  // Wraps an already serialised message, e.g. one being forwarded on.
+  explicit OutboundMessage(SerialisedMessage serialised)
+      : serialised_(std::make_shared<const SerialisedMessage>(std::move(serialised))) {}
+
+  OutboundMessage(const OutboundMessage&) = default;
+  OutboundMessage& operator=(const OutboundMessage&) = default;
+  ~OutboundMessage() = default;
+
+  template <typename Handler /* void(asio::error_code) */>
+  void Send(PeerNode& peer, const Handler& handler) const {
+    peer.Send(serialised_, handler);
+  }
+
+  // Sends to each of |targets| which we are still connected to.  Returns the number of sends
+  // started.
+  template <typename Targets, typename Handler /* void(asio::error_code) */>
+  size_t Send(ConnectionManager& connection_manager, const Targets& targets,
+              const Handler& handler) const {
+    size_t sent(0);
+    for (const auto& target : targets) {
+      PeerNode* peer(connection_manager.FindPeer(target));
+      if (!peer) {
+        LOG(kVerbose) << "No longer connected to send target.";
+        continue;
+      }
+      Send(*peer, handler);
+      ++sent;
+    }
+    return sent;
+  }
+
+  template <typename Targets>
+  size_t Send(ConnectionManager& connection_manager, const Targets& targets) const {
+    return Send(connection_manager, targets, [](asio::error_code error) {
+      if (error)
+        LOG(kWarning) << "cannot send " << error.message();
+    });
+  }
+
+  const SerialisedMessage& Serialised() const { return *serialised_; }
+
+ private:
+  std::shared_ptr<const SerialisedMessage> serialised_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_OUTBOUND_MESSAGE_H_
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_ROUTING_PEER_NODE_H_
 #define MAIDSAFE_ROUTING_PEER_NODE_H_
 
+#include <atomic>
 #include <memory>
 
 #include "maidsafe/common/convert.h"
@@ -41,12 +42,14 @@ class PeerNode {
       : node_info_(std::move(other.node_info_)),
         receive_buffer_(std::move(other.receive_buffer_)),
         socket_(std::move(other.socket_)),
+        sends_in_flight_(std::move(other.sends_in_flight_)),
         destroy_indicator_(std::move(other.destroy_indicator_)) {}
 
   PeerNode& operator=(PeerNode&& other) {
     node_info_ = std::move(other.node_info_);
     receive_buffer_ = std::move(other.receive_buffer_);
     socket_ = std::move(other.socket_);
+    sends_in_flight_ = std::move(other.sends_in_flight_);
     destroy_indicator_ = std::move(other.destroy_indicator_);
     return *this;
   }
@@ -55,15 +58,25 @@ class PeerNode {
       : node_info_(std::move(node_info)),
         receive_buffer_(std::make_shared<SerialisedMessage>(MaxMessageSize())),
         socket_(std::move(socket)),
+        sends_in_flight_(std::make_shared<std::atomic<size_t>>(0)),
         destroy_indicator_(new boost::none_t) {}
 
   template <typename Message, typename Handler>
   void Send(Message msg, const Handler& handler) {
-    auto msg_ptr = std::make_shared<Message>(std::move(msg));
+    Send(std::make_shared<const Message>(std::move(msg)), handler);
+  }
+
+  // The buffer may be shared with sends to other peers; it is kept alive until this send completes.
+  template <typename Message, typename Handler>
+  void Send(std::shared_ptr<const Message> msg_ptr, const Handler& handler) {
     auto guard = DestroyGuard();
+    auto sends_in_flight = sends_in_flight_;
+    ++*sends_in_flight;
 
     socket_->async_send(boost::asio::buffer(*msg_ptr),
-                        [this, msg_ptr, handler, guard](boost::system::error_code error, size_t) {
+                        [this, msg_ptr, handler, guard, sends_in_flight](
+                            boost::system::error_code error, size_t) {
+      --*sends_in_flight;
       if (!guard.lock()) {
         // This object was destroyed.
         return handler(asio::error::operation_aborted);
@@ -102,6 +115,9 @@ class PeerNode {
     });
   }
 
+  // Sends started which haven't completed yet.
+  size_t SendsInFlight() const { return *sends_in_flight_; }
+
   const Address& id() const { return node_info_.id; }
   const NodeInfo& node_info() const { return node_info_; }
 
@@ -114,6 +130,7 @@ class PeerNode {
   NodeInfo node_info_;
   std::shared_ptr<SerialisedMessage> receive_buffer_;
   std::shared_ptr<crux::socket> socket_;  // TODO(Team): ditch shared_ptr
+  std::shared_ptr<std::atomic<size_t>> sends_in_flight_;
   std::shared_ptr<boost::none_t> destroy_indicator_;
 };
 
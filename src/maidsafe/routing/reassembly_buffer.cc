@@ -0,0 +1,135 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/reassembly_buffer.h"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+const std::chrono::steady_clock::duration ReassemblyBuffer::kDefaultTimeout =
+    std::chrono::minutes(2);
+
+ReassemblyBuffer::ReassemblyBuffer(TimingWheel& expiry_wheel, uint64_t capacity,
+                                   std::chrono::steady_clock::duration timeout)
+    : expiry_wheel_(expiry_wheel),
+      capacity_(capacity),
+      timeout_(timeout),
+      mutex_(),
+      payloads_(),
+      reserved_(0),
+      generation_(0),
+      expired_(0) {}
+
+ReassemblyBuffer::~ReassemblyBuffer() {
+  for (const auto& payload : payloads_)
+    expiry_wheel_.Cancel(payload.second.timer);
+}
+
+boost::optional<SerialisedData> ReassemblyBuffer::Add(const Key& key, uint32_t index,
+                                                      uint32_t count, uint64_t total_size,
+                                                      const SerialisedData& fragment) {
+  const auto bounds(FragmentBounds(total_size, count, index));
+  if (count == 0 || index >= count || fragment.size() != bounds.second - bounds.first) {
+    LOG(kWarning) << "Fragment " << index << " of " << count << " doesn't fit its payload.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found(payloads_.find(key));
+  if (found == std::end(payloads_)) {
+    if (total_size > capacity_ - reserved_) {
+      LOG(kWarning) << "No room to reassemble a payload of " << total_size << " bytes.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+    }
+    found = payloads_.insert(std::make_pair(key, Payload{SerialisedData(total_size),
+                                                         std::vector<bool>(count, false), count,
+                                                         0, 0})).first;
+    reserved_ += total_size;
+  } else if (found->second.received.size() != count || found->second.data.size() != total_size) {
+    LOG(kWarning) << "Fragment " << index << " doesn't match the layout of its payload.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  } else {
+    expiry_wheel_.Cancel(found->second.timer);
+  }
+
+  auto& payload(found->second);
+  if (!payload.received[index]) {
+    std::copy(std::begin(fragment), std::end(fragment),
+              std::begin(payload.data) + static_cast<std::ptrdiff_t>(bounds.first));
+    payload.received[index] = true;
+    --payload.missing;
+  }
+  if (payload.missing == 0) {
+    boost::optional<SerialisedData> data(std::move(payload.data));
+    reserved_ -= total_size;
+    payloads_.erase(found);
+    return data;
+  }
+  const auto generation(++generation_);
+  payload.generation = generation;
+  payload.timer =
+      expiry_wheel_.Schedule(timeout_, [this, key, generation] { Expire(key, generation); });
+  return boost::none;
+}
+
+void ReassemblyBuffer::Remove(const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found(payloads_.find(key));
+  if (found != std::end(payloads_))
+    Erase(found);
+}
+
+size_t ReassemblyBuffer::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return payloads_.size();
+}
+
+uint64_t ReassemblyBuffer::Reserved() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reserved_;
+}
+
+uint64_t ReassemblyBuffer::Expired() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return expired_;
+}
+
+void ReassemblyBuffer::Expire(const Key& key, uint64_t generation) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found(payloads_.find(key));
+  // A fragment may have arrived (restarting the timeout) after this timer fired but before it ran.
+  if (found == std::end(payloads_) || found->second.generation != generation)
+    return;
+  reserved_ -= found->second.data.size();
+  payloads_.erase(found);
+  ++expired_;
+}
+
+void ReassemblyBuffer::Erase(Payloads::iterator payload) {
+  expiry_wheel_.Cancel(payload->second.timer);
+  reserved_ -= payload->second.data.size();
+  payloads_.erase(payload);
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,124 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_REASSEMBLY_BUFFER_H_
+#define MAIDSAFE_ROUTING_REASSEMBLY_BUFFER_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/routing/hash.h"
+#include "maidsafe/routing/timing_wheel.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// A payload of |total_size| bytes is split into |count| fragments, each but the last holding
+// FragmentSize bytes.  An empty payload is sent as one empty fragment.
+inline uint32_t FragmentCount(uint64_t total_size, uint64_t max_fragment_size) {
+  return static_cast<uint32_t>(std::max<uint64_t>(
+      1, (total_size + max_fragment_size - 1) / std::max<uint64_t>(max_fragment_size, 1)));
+}
+
+inline uint64_t FragmentSize(uint64_t total_size, uint32_t count) {
+  return count == 0 ? 0 : (total_size + count - 1) / count;
+}
+
+// Byte range [first, second) of the payload held by fragment |index|.
+inline std::pair<uint64_t, uint64_t> FragmentBounds(uint64_t total_size, uint32_t count,
+                                                    uint32_t index) {
+  const auto fragment_size(FragmentSize(total_size, count));
+  const auto begin(std::min(total_size, index * fragment_size));
+  return std::make_pair(begin, std::min(total_size, begin + fragment_size));
+}
+
+inline SerialisedData CopyFragment(const SerialisedData& payload, uint32_t count, uint32_t index) {
+  const auto bounds(FragmentBounds(payload.size(), count, index));
+  return SerialisedData(std::begin(payload) + static_cast<std::ptrdiff_t>(bounds.first),
+                        std::begin(payload) + static_cast<std::ptrdiff_t>(bounds.second));
+}
+
+// Reassembles payloads from fragments arriving in any order.  Space for a whole payload is
+// reserved when its first fragment arrives, and payloads which would take the total reserved over
+// |capacity| bytes are refused, so the buffer's memory stays bounded however many streams are
+// open.  A payload is dropped if no fragment of it arrives for |timeout|; the wheel must outlive
+// the buffer.  Thread-safe.
+class ReassemblyBuffer {
+ public:
+  // The sender (or, for a Get, the destination) and the name of the payload.
+  using Key = std::pair<Address, Identity>;
+  static const std::chrono::steady_clock::duration kDefaultTimeout;
+
+  ReassemblyBuffer(TimingWheel& expiry_wheel, uint64_t capacity,
+                   std::chrono::steady_clock::duration timeout = kDefaultTimeout);
+  ReassemblyBuffer(const ReassemblyBuffer&) = delete;
+  ReassemblyBuffer(ReassemblyBuffer&&) = delete;
+  ~ReassemblyBuffer();
+  ReassemblyBuffer& operator=(const ReassemblyBuffer&) = delete;
+  ReassemblyBuffer& operator=(ReassemblyBuffer&&) = delete;
+
+  // Returns the whole payload, and forgets it, once its last missing fragment is added.  Repeated
+  // fragments are ignored.  Throws CommonErrors::invalid_parameter if the fragment doesn't match
+  // the payload's layout, and CommonErrors::unable_to_handle_request if the payload doesn't fit.
+  boost::optional<SerialisedData> Add(const Key& key, uint32_t index, uint32_t count,
+                                      uint64_t total_size, const SerialisedData& fragment);
+  void Remove(const Key& key);
+
+  size_t size() const;
+  uint64_t Reserved() const;
+  uint64_t Capacity() const { return capacity_; }
+  uint64_t Expired() const;
+
+ private:
+  struct Payload {
+    SerialisedData data;
+    std::vector<bool> received;
+    uint32_t missing;
+    uint64_t generation;
+    TimingWheel::TimerId timer;
+  };
+  using Payloads = std::unordered_map<Key, Payload, detail::Hasher<Key>>;
+
+  void Expire(const Key& key, uint64_t generation);
+  void Erase(Payloads::iterator payload);
+
+  TimingWheel& expiry_wheel_;
+  const uint64_t capacity_;
+  const std::chrono::steady_clock::duration timeout_;
+  mutable std::mutex mutex_;
+  Payloads payloads_;
+  uint64_t reserved_, generation_, expired_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_REASSEMBLY_BUFFER_H_
@@ -0,0 +1,152 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/response_table.h"
+
+#include <vector>
+
+namespace maidsafe {
+
+namespace routing {
+
+const std::chrono::steady_clock::duration ResponseTable::kDefaultTimeout =
+    std::chrono::seconds(30);
+
+ResponseTable::ResponseTable(TimingWheel& timeout_wheel)
+    : timeout_wheel_(timeout_wheel),
+      mutex_(),
+      requests_(),
+      generation_(0),
+      refusal_(),
+      completed_(0),
+      timed_out_(0) {}
+
+ResponseTable::~ResponseTable() { CancelAll(); }
+
+bool ResponseTable::Add(Key key, Handler handler, std::chrono::steady_clock::duration timeout) {
+  asio::error_code error(asio::error::already_started);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (refusal_) {
+      error = refusal_;
+    } else if (requests_.count(key) == 0) {
+      const auto generation(++generation_);
+      const auto timer(timeout_wheel_.Schedule(
+          timeout, [this, key, generation] { Expire(key, generation); }));
+      requests_.insert(
+          std::make_pair(std::move(key), Request{std::move(handler), timer, generation, 1, 0}));
+      return true;
+    }
+  }
+  handler(error, SerialisedMessage());
+  return false;
+}
+
+bool ResponseTable::Complete(const Key& key, asio::error_code error, SerialisedMessage response) {
+  Handler handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found(requests_.find(key));
+    if (found == std::end(requests_))
+      return false;
+    timeout_wheel_.Cancel(found->second.timer);
+    handler = std::move(found->second.handler);
+    requests_.erase(found);
+    ++completed_;
+  }
+  handler(error, std::move(response));
+  return true;
+}
+
+bool ResponseTable::AddAttempt(const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto found(requests_.find(key));
+  if (found == std::end(requests_))
+    return false;
+  ++found->second.attempts;
+  return true;
+}
+
+bool ResponseTable::Fail(const Key& key, asio::error_code error) {
+  Handler handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found(requests_.find(key));
+    if (found == std::end(requests_) || ++found->second.failures < found->second.attempts)
+      return false;
+    timeout_wheel_.Cancel(found->second.timer);
+    handler = std::move(found->second.handler);
+    requests_.erase(found);
+    ++completed_;
+  }
+  handler(error, SerialisedMessage());
+  return true;
+}
+
+void ResponseTable::CancelAll(asio::error_code error) {
+  std::vector<Handler> handlers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& request : requests_) {
+      timeout_wheel_.Cancel(request.second.timer);
+      handlers.push_back(std::move(request.second.handler));
+    }
+    requests_.clear();
+  }
+  for (auto& handler : handlers)
+    handler(error, SerialisedMessage());
+}
+
+void ResponseTable::StopAccepting(asio::error_code error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  refusal_ = error;
+}
+
+void ResponseTable::Expire(const Key& key, uint64_t generation) {
+  Handler handler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found(requests_.find(key));
+    // The request may have been completed and its key reused after this timer fired.
+    if (found == std::end(requests_) || found->second.generation != generation)
+      return;
+    handler = std::move(found->second.handler);
+    requests_.erase(found);
+    ++timed_out_;
+  }
+  handler(asio::error::timed_out, SerialisedMessage());
+}
+
+size_t ResponseTable::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return requests_.size();
+}
+
+uint64_t ResponseTable::Completed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return completed_;
+}
+
+uint64_t ResponseTable::TimedOut() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return timed_out_;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,117 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_RESPONSE_TABLE_H_
+#define MAIDSAFE_ROUTING_RESPONSE_TABLE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "asio/error.hpp"
+#include "asio/error_code.hpp"
+
+#include "maidsafe/common/error.h"
+
+#include "maidsafe/routing/hash.h"
+#include "maidsafe/routing/timing_wheel.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Outstanding Get/Put/Post requests, keyed by the address a request was sent to and its message
+// id, so that the response can complete the caller's handler.  Each handler is completed exactly
+// once: by the first matching response (further copies, e.g. from other group members, are
+// ignored), with asio::error::timed_out when its deadline passes, or with
+// asio::error::operation_aborted when the table is destroyed.  Deadlines are timers on a shared
+// TimingWheel, which must outlive the table.  Handlers are never invoked with the table's lock
+// held.  Thread-safe.
+class ResponseTable {
+ public:
+  using Key = std::pair<Address, MessageId>;
+  using Handler = std::function<void(asio::error_code, SerialisedMessage)>;
+  static const std::chrono::steady_clock::duration kDefaultTimeout;
+
+  explicit ResponseTable(TimingWheel& timeout_wheel);
+  ResponseTable(const ResponseTable&) = delete;
+  ResponseTable(ResponseTable&&) = delete;
+  ~ResponseTable();
+  ResponseTable& operator=(const ResponseTable&) = delete;
+  ResponseTable& operator=(ResponseTable&&) = delete;
+
+  // If |key| is already outstanding, |handler| is completed at once with
+  // asio::error::already_started and false is returned; after StopAccepting, with the error given
+  // there.
+  bool Add(Key key, Handler handler,
+           std::chrono::steady_clock::duration timeout = kDefaultTimeout);
+  // Returns false if no request is outstanding for |key|.
+  bool Complete(const Key& key, asio::error_code error, SerialisedMessage response);
+  // Records that the request for |key| has been sent to one more target (a request starts with
+  // one attempt), e.g. as a backup for a slow first target.  Returns false if the request is no
+  // longer outstanding, in which case it shouldn't be sent.
+  bool AddAttempt(const Key& key);
+  // Records a failed attempt.  The handler is only completed, with |error|, once every attempt has
+  // failed, so that a valid response from another target can still complete it.  Returns true if
+  // the handler was completed.
+  bool Fail(const Key& key, asio::error_code error);
+  // Completes every outstanding handler with |error|.
+  void CancelAll(asio::error_code error = asio::error::operation_aborted);
+  // Refuses further requests with |error|.  Those outstanding can still complete.
+  void StopAccepting(asio::error_code error);
+
+  size_t size() const;
+  uint64_t Completed() const;
+  uint64_t TimedOut() const;
+
+ private:
+  struct Request {
+    Handler handler;
+    TimingWheel::TimerId timer;
+    uint64_t generation;
+    size_t attempts;
+    size_t failures;
+  };
+
+  void Expire(const Key& key, uint64_t generation);
+
+  TimingWheel& timeout_wheel_;
+  mutable std::mutex mutex_;
+  std::unordered_map<Key, Request, detail::Hasher<Key>> requests_;
+  uint64_t generation_;
+  asio::error_code refusal_;
+  uint64_t completed_;
+  uint64_t timed_out_;
+};
+
+// The response messages carry a maidsafe_error, where CommonErrors::success means no error.
+inline asio::error_code ToErrorCode(const maidsafe_error& error) {
+  if (error.code() == make_error_code(CommonErrors::success))
+    return asio::error_code();
+  return error.code();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_RESPONSE_TABLE_H_
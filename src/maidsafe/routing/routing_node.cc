@@ -83,7 +83,7 @@ namespace routing {
 //   MessageHeader header(DestinationAddress(std::make_pair(Destination(OurId()), boost::none)),
 //                        SourceAddress{OurSourceAddress()}, ++message_id_);
 //   if (bootstrap_node_) {
-//     rudp_.Send(*bootstrap_node_, Serialise(header, MessageToTag<FindGroup>::value(), message),
+//     rudp_.Send(*bootstrap_node_, Serialise(header, MessageToTag<FindGroup>::value, message),
 //                [](asio::error_code error) {
 //       if (error) {
 //         LOG(kWarning) << "rudp cannot send via bootstrap node" << error.message();
@@ -93,7 +93,7 @@ namespace routing {
 //     return;
 //   }
 //   for (const auto& target : connection_manager_.GetTarget(OurId()))
-//     rudp_.Send(target.id, Serialise(header, MessageToTag<Connect>::value(), message),
+//     rudp_.Send(target.id, Serialise(header, MessageToTag<Connect>::value, message),
 //                [](asio::error_code error) {
 //       if (error) {
 //         LOG(kWarning) << "rudp cannot send" << error.message();
@@ -211,7 +211,7 @@ namespace routing {
 //   // shutdown
 //   // :24/01/2015
 //   for (auto& target : targets) {
-//     rudp_.Send(target.id, Serialise(header, MessageToTag<ConnectResponse>::value(), respond),
+//     rudp_.Send(target.id, Serialise(header, MessageToTag<ConnectResponse>::value, respond),
 //                [connect, this](asio::error_code error_code) {
 //       if (error_code)
 //         return;
@@ -268,7 +268,7 @@ namespace routing {
 //                        SourceAddress(OurSourceAddress(GroupAddress(find_group.target_id()))),
 //                        original_header.MessageId(),
 //                        asymm::Sign(Serialise(response), our_fob_.private_key()));
-//   auto message(Serialise(header, MessageToTag<FindGroupResponse>::value(), response));
+//   auto message(Serialise(header, MessageToTag<FindGroupResponse>::value, response));
 //   for (const auto& node : connection_manager_.GetTarget(original_header.FromNode())) {
 //     rudp_.Send(node.id, message, asio::use_future).get();
 //   }
@@ -287,7 +287,7 @@ namespace routing {
 //     MessageHeader header(DestinationAddress(std::make_pair(Destination(node.id), boost::none)),
 //                          SourceAddress{OurSourceAddress()}, ++message_id_);
 //     for (const auto& target : connection_manager_.GetTarget(node.id))
-//       rudp_.Send(target.id, Serialise(header, MessageToTag<Connect>::value(), message),
+//       rudp_.Send(target.id, Serialise(header, MessageToTag<Connect>::value, message),
 //                  [](asio::error_code error) {
 //         if (error) {
 //           LOG(kWarning) << "rudp cannot send" << error.message();
@@ -324,7 +324,7 @@ namespace routing {
 //   MessageHeader header(DestinationAddress(std::make_pair(Destination(target), boost::none)),
 //                        SourceAddress{OurSourceAddress()}, ++message_id_);
 //
-//   rudp_.Send(target, Serialise(header, MessageToTag<Message>::value(), message), handler);
+//   rudp_.Send(target, Serialise(header, MessageToTag<Message>::value, message), handler);
 // }
 //
 // void RoutingNode::OnBootstrap(asio::error_code error, rudp::Contact contact,
@@ -18,34 +18,350 @@
 
 #include "maidsafe/routing/sentinel.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/routing/messages/get_group_key_response.h"
+#include "maidsafe/routing/messages/get_key_response.h"
+
 namespace maidsafe {
 
 namespace routing {
 
+const std::chrono::steady_clock::duration Sentinel::kDefaultKeyRequestTimeout =
+    std::chrono::seconds(30);
+
+namespace {
+
+const std::chrono::steady_clock::duration kKeyTimeToLive(std::chrono::minutes(20));
+const size_t kKeyCacheCapacity(1000);
+const std::chrono::steady_clock::duration kPartsTimeToLive(std::chrono::minutes(20));
+// Messages being accumulated at once, per accumulator.
+const size_t kAccumulatorCapacity(10000);
+
+}  // unnamed namespace
+
+Sentinel::Sentinel(asio::io_service& io_service)
+    : Sentinel(io_service, std::max(1U, std::thread::hardware_concurrency())) {}
+
+Sentinel::Sentinel(asio::io_service& io_service, TimingWheel& expiry_wheel)
+    : Sentinel(io_service, std::max(1U, std::thread::hardware_concurrency()),
+               kDefaultKeyRequestTimeout, &expiry_wheel) {}
+
+Sentinel::Sentinel(asio::io_service& io_service, uint32_t verifier_threads,
+                   std::chrono::steady_clock::duration key_request_timeout,
+                   TimingWheel* expiry_wheel)
+    : io_service_(io_service),
+      key_request_timeout_(key_request_timeout),
+      expiry_wheel_(expiry_wheel),
+      verifier_(verifier_threads),
+      send_get_key_(),
+      send_get_group_key_(),
+      check_close_group_(),
+      pending_group_keys_(),
+      pending_node_keys_(),
+      key_cache_(kKeyTimeToLive, kKeyCacheCapacity),
+      key_requests_sent_(0),
+      key_requests_saved_(0),
+      group_accumulator_(kPartsTimeToLive, QuorumSize, kAccumulatorCapacity, expiry_wheel),
+      key_accumulator_(kPartsTimeToLive, QuorumSize, kAccumulatorCapacity, expiry_wheel) {}
+
+Sentinel::~Sentinel() {
+  CancelDeadlines(pending_group_keys_);
+  CancelDeadlines(pending_node_keys_);
+}
+
 boost::optional<std::future<Sentinel::ResultType>> Sentinel::Add(MessageHeader header,
                                                                  MessageTypeTag tag,
                                                                  SerialisedMessage message) {
-  if (tag == MessageTypeTag::GetKeyResponse) {
+  auto promise(std::make_shared<std::promise<ResultType>>());
+  if (!Add(std::move(header), tag, std::move(message), [promise](Result result) {
+        if (result)
+          promise->set_value(std::move(*result));
+        else
+          promise->set_exception(std::make_exception_ptr(result.error()));
+      })) {
+    return boost::none;
+  }
+  return promise->get_future();
+}
+
+bool Sentinel::Add(MessageHeader header, MessageTypeTag tag, SerialisedMessage message,
+                   ResultHandler handler) {
+  ExpireKeyRequests();
+  if (!header.Signature()) {
+    LOG(kWarning) << "Unsigned message can't be checked.";
+    return false;
+  }
+  Entry entry{header.Source(), tag, *header.Signature()};
+
+  if (tag == MessageTypeTag::GetKeyResponse || tag == MessageTypeTag::GetGroupKeyResponse) {
     if (!header.FromGroup())  // "keys should always come from a group");
       BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
-    if (group_key_accumulator_.Add(*header.FromGroup(),
-                                   std::make_tuple(header.Source(), tag, std::move(message)),
-                                   header.FromNode())) {
-      // get the other accumulator and go for it
+    // Only answers to our own requests are taken, so nobody can push keys on us unasked.
+    const bool requested(
+        tag == MessageTypeTag::GetGroupKeyResponse
+            ? pending_group_keys_.count(*header.FromGroup()) != 0
+            : pending_node_keys_.count(NodeAddress(header.FromGroup()->data)) != 0);
+    if (!requested) {
+      LOG(kVerbose) << "Ignoring unrequested key response.";
+      return false;
+    }
+    // The group members must agree on the response body before its signatures are checked.
+    const auto agreement(key_accumulator_.Add(std::make_pair(*header.FromGroup(),
+                                                             header.MessageId()),
+                                              std::move(message), std::move(entry),
+                                              header.FromNode()));
+    if (agreement) {
+      Parts agreed;
+      for (const auto& part : agreement->votes.second) {
+        if (part.second.payload == agreement->payload)
+          agreed.insert(part);
+      }
+      AddKeys(header, tag, *agreement->payload, agreed);
+    }
+    return false;
+  }
+
+  if (!header.FromGroup()) {  // direct message
+    Parts parts;
+    parts.insert(std::make_pair(
+        header.FromNode().data,
+        Votes::Vote{std::string(), std::make_shared<const SerialisedMessage>(std::move(message)),
+                    std::move(entry)}));
+    const auto key(key_cache_.GetNode(header.FromNode().data));
+    if (key) {
+      Verify(parts, Keys{std::make_pair(header.FromNode().data, *key)}, 1, std::move(handler));
+    } else {
+      Park(RequestKeys(pending_node_keys_, header.FromNode(), send_get_key_), std::move(parts), 1,
+           std::move(handler));
     }
+    return true;
+  }
+
+  const GroupAddress group(*header.FromGroup());
+  const auto keys(key_cache_.GetGroup(group));
+  // Fetch the keys while the rest of the parts accumulate.  This only sends a request if none is in
+  // flight, and isn't counted as one avoided otherwise: that's decided per check, in Park.
+  if (!keys)
+    RequestKeys(pending_group_keys_, group, send_get_group_key_);
+
+  const auto agreement(group_accumulator_.Add(std::make_pair(group, header.MessageId()),
+                                              std::move(message), std::move(entry),
+                                              header.FromNode()));
+  // Only the part completing the first quorum of agreeing parts starts verification; later parts
+  // are surplus.
+  if (!agreement)
+    return false;
+  // Dissenting parts are left out, as their signatures are over a different message.  The parts
+  // share the agreed message, so this copies only the per sender entries.
+  Parts agreed;
+  for (const auto& part : agreement->votes.second) {
+    if (part.second.payload == agreement->payload)
+      agreed.insert(part);
+  }
+  if (keys) {
+    Verify(agreed, *keys, QuorumSize, std::move(handler));
   } else {
-    if (header.FromGroup() && !group_accumulator_.HaveName(*header.FromGroup())) {  // we need
-      // to send a findkey for this GroupAddress
+    Park(RequestKeys(pending_group_keys_, group, send_get_group_key_), std::move(agreed),
+         QuorumSize, std::move(handler));
+  }
+  return true;
+}
 
-    } else if (!node_accumulator_.HaveName(header.FromNode())) {  // we need
-      // to send a findkey for this SourceAddress
+template <typename Name, typename SendRequest>
+Sentinel::PendingKeyRequest& Sentinel::RequestKeys(std::map<Name, PendingKeyRequest>& pending,
+                                                   const Name& name,
+                                                   const SendRequest& send_request) {
+  auto found(pending.find(name));
+  if (found != std::end(pending))
+    return found->second;
+  ++key_requests_sent_;
+  if (send_request)
+    send_request(name);
+  else
+    LOG(kWarning) << "No means of requesting keys.";
+  TimingWheel::TimerId deadline(0);
+  if (expiry_wheel_) {
+    auto* const requests(&pending);
+    deadline = expiry_wheel_->Schedule(
+        key_request_timeout_, [this, requests, name] { ExpireKeyRequest(*requests, name); });
+  }
+  return pending.insert(std::make_pair(name, PendingKeyRequest{std::chrono::steady_clock::now(),
+                                                               deadline,
+                                                               std::vector<ParkedCheck>()}))
+      .first->second;
+}
+
+void Sentinel::Park(PendingKeyRequest& request, Parts parts, size_t quorum,
+                    ResultHandler handler) {
+  // The request was sent for the first check parked on it; any later check would have sent one.
+  if (!request.parked.empty())
+    ++key_requests_saved_;
+  request.parked.push_back(ParkedCheck{std::move(parts), quorum, std::move(handler)});
+}
+
+template <typename Name>
+void Sentinel::ReleaseParked(std::map<Name, PendingKeyRequest>& pending, const Name& name,
+                             const Keys& keys) {
+  auto found(pending.find(name));
+  if (found == std::end(pending))
+    return;
+  if (expiry_wheel_)
+    expiry_wheel_->Cancel(found->second.deadline);
+  auto parked(std::move(found->second.parked));
+  pending.erase(found);
+  for (auto& check : parked)
+    Verify(check.parts, keys, check.quorum, std::move(check.handler));
+}
+
+template <typename Name>
+void Sentinel::ExpireKeyRequest(std::map<Name, PendingKeyRequest>& pending, const Name& name) {
+  auto found(pending.find(name));
+  if (found == std::end(pending))
+    return;
+  auto request(std::move(found->second));
+  pending.erase(found);
+  FailParked(request);
+}
+
+void Sentinel::ExpireKeyRequests() {
+  if (expiry_wheel_)
+    return;
+  const auto expired_before(std::chrono::steady_clock::now() - key_request_timeout_);
+  ExpireKeyRequests(pending_group_keys_, expired_before);
+  ExpireKeyRequests(pending_node_keys_, expired_before);
+}
+
+template <typename Name>
+void Sentinel::ExpireKeyRequests(std::map<Name, PendingKeyRequest>& pending,
+                                 std::chrono::steady_clock::time_point expired_before) {
+  for (auto it(std::begin(pending)); it != std::end(pending);) {
+    if (it->second.sent >= expired_before) {
+      ++it;
+      continue;
     }
+    auto request(std::move(it->second));
+    it = pending.erase(it);
+    FailParked(request);
   }
+}
+
+void Sentinel::FailParked(PendingKeyRequest& request) {
+  LOG(kInfo) << "Timed out waiting for keys, failing " << request.parked.size()
+             << " parked checks.";
+  for (auto& check : request.parked)
+    check.handler(boost::make_unexpected(MakeError(CommonErrors::unable_to_handle_request)));
+}
 
-  if (node_key_accumulator_.HaveName(header.FromNode())) {  // ok direct
-  } else if (header.FromGroup() && group_key_accumulator_.HaveName(*header.FromGroup())) {  // ok dht
+template <typename Name>
+void Sentinel::CancelDeadlines(const std::map<Name, PendingKeyRequest>& pending) {
+  if (!expiry_wheel_)
+    return;
+  for (const auto& request : pending)
+    expiry_wheel_->Cancel(request.second.deadline);
+}
+
+void Sentinel::AddKeys(const MessageHeader& header, MessageTypeTag tag,
+                       const SerialisedMessage& body, const Parts& parts) {
+  try {
+    InputVectorStream binary_input_stream{body};
+    if (tag == MessageTypeTag::GetGroupKeyResponse) {
+      auto response(Parse<GetGroupKeyResponse>(binary_input_stream));
+      const GroupAddress& group(response.group_address());
+      if (group != *header.FromGroup())
+        return;
+      // Members answer with the group's closest nodes, closest first (see
+      // ConnectionManager::CloseGroupOf).
+      Keys keys;
+      std::vector<Address> members;
+      for (const auto& fob : response.fobs()) {
+        const Address name(fob.name()->string());
+        if (!members.empty() && !Address::CloserToTarget(members.back(), name, group.data)) {
+          LOG(kWarning) << "Group key response isn't ordered by closeness to the group.";
+          return;
+        }
+        members.push_back(name);
+        keys.insert(std::make_pair(name, fob.public_key()));
+      }
+      if (members.size() > GroupSize ||
+          (check_close_group_ && !check_close_group_(group, members))) {
+        LOG(kWarning) << "Group key response doesn't list the group's closest members.";
+        return;
+      }
+      if (!SignedByQuorum(parts, keys, body))
+        return;
+      ReleaseParked(pending_group_keys_, group, keys);
+      key_cache_.AddGroup(group, std::move(keys));
+    } else {
+      auto response(Parse<GetKeyResponse>(binary_input_stream));
+      const Address& node(response.node_address().data);
+      if (node != header.FromGroup()->data)
+        return;
+      // A fob's name is derived from its key, so only the node's own fob can carry its name.
+      if (Address(response.fob().name()->string()) != node) {
+        LOG(kWarning) << "Key response holds a fob for another node.";
+        return;
+      }
+      const Keys keys{std::make_pair(node, response.fob().public_key())};
+      ReleaseParked(pending_node_keys_, response.node_address(), keys);
+      key_cache_.AddNode(node, response.fob().public_key());
+    }
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Invalid key response: " << e.what();
+  }
+}
+
+bool Sentinel::SignedByQuorum(const Parts& parts, const Keys& keys,
+                              const SerialisedMessage& body) const {
+  // Checked here rather than on the verifier's threads: key responses are rare, as keys are
+  // cached, and anything parked on them can't be released until they're known to be good.
+  const asymm::PlainText plain_text(std::string(std::begin(body), std::end(body)));
+  size_t verified(0);
+  for (const auto& part : parts) {
+    const auto key(keys.find(part.first));
+    if (key != std::end(keys) &&
+        asymm::CheckSignature(plain_text, part.second.meta.signature, key->second)) {
+      ++verified;
+    }
   }
-  return boost::none;
+  if (verified < QuorumSize) {
+    LOG(kWarning) << "Only " << verified << " parts of a group key response are signed by the "
+                  << "members it lists.";
+    return false;
+  }
+  return true;
+}
+
+void Sentinel::Verify(const Parts& parts, const Keys& keys, size_t quorum,
+                      ResultHandler handler) {
+  std::vector<SignatureVerifier::Item> items;
+  auto votes(std::make_shared<std::vector<Votes::Vote>>());
+  for (const auto& part : parts) {
+    const auto key(keys.find(part.first));
+    if (key == std::end(keys))
+      continue;  // not a member of the group as far as we know
+    items.push_back(
+        SignatureVerifier::Item{key->second, part.second.payload, part.second.meta.signature});
+    votes->push_back(part.second);
+  }
+
+  verifier_.VerifyQuorum(std::move(items), quorum,
+                         [handler, votes](bool quorum_reached, std::vector<size_t> verified) {
+    if (quorum_reached) {
+      const auto& vote((*votes)[verified.front()]);
+      handler(std::make_tuple(vote.meta.source, vote.meta.tag, *vote.payload));
+    } else {
+      handler(boost::make_unexpected(MakeError(CommonErrors::invalid_parameter)));
+    }
+  });
 }
 
 }  // namespace routing
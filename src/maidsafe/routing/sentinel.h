@@ -20,18 +20,28 @@
 #define MAIDSAFE_ROUTING_SENTINEL_H_
 
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <future>
+#include <map>
+#include <memory>
+#include <tuple>
 #include <vector>
 #include <utility>
 
 #include "asio/io_service.hpp"
+#include "boost/expected/expected.hpp"
 #include "boost/optional/optional.hpp"
 
+#include "maidsafe/common/error.h"
 #include "maidsafe/common/rsa.h"
 
-#include "maidsafe/routing/accumulator.h"
+#include "maidsafe/routing/key_cache.h"
 #include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/signature_verifier.h"
+#include "maidsafe/routing/timing_wheel.h"
 #include "maidsafe/routing/types.h"
+#include "maidsafe/routing/vote_accumulator.h"
 #include "maidsafe/routing/messages/messages_fwd.h"
 
 namespace maidsafe {
@@ -41,26 +51,134 @@ namespace routing {
 class Sentinel {
  public:
   using ResultType = std::tuple<SourceAddress, MessageTypeTag, SerialisedMessage>;
-  explicit Sentinel(asio::io_service& io_service) : io_service_(io_service) {}
+  using Result = boost::expected<ResultType, maidsafe_error>;
+  using ResultHandler = std::function<void(Result)>;
+  static const std::chrono::steady_clock::duration kDefaultKeyRequestTimeout;
+
+  explicit Sentinel(asio::io_service& io_service);
+  // Accumulated parts and key requests are expired by |expiry_wheel|, which must outlive the
+  // sentinel and be driven from the thread calling Add.  Without a wheel they're expired lazily,
+  // by later calls to Add.
+  Sentinel(asio::io_service& io_service, TimingWheel& expiry_wheel);
+  Sentinel(asio::io_service& io_service, uint32_t verifier_threads,
+           std::chrono::steady_clock::duration key_request_timeout = kDefaultKeyRequestTimeout,
+           TimingWheel* expiry_wheel = nullptr);
   Sentinel(const Sentinel&) = delete;
   Sentinel(Sentinel&&) = delete;
-  ~Sentinel() = default;
+  ~Sentinel();
   Sentinel& operator=(const Sentinel&) = delete;
   Sentinel& operator=(Sentinel&&) = delete;
-  // at some stage this will return a valid answer when all data is accumulated
-  // and signatures checked
+  // Returns a future when this part completes a set which can be checked, i.e. the first quorum of
+  // parts of a group message, or any direct message.  The future holds the message once a quorum
+  // of the signatures verify, or throws if that becomes impossible or the senders' keys can't be
+  // fetched in time.  If the keys aren't held, a GetKey/GetGroupKey is sent (unless one is already
+  // in flight for that address) and the check is parked until the keys arrive.  Key responses are
+  // accumulated here to learn those keys and never return a future; only responses to a request
+  // still in flight are taken, and a group's keys only once a quorum of the members listed signed
+  // the response.
   boost::optional<std::future<ResultType>> Add(MessageHeader, MessageTypeTag, SerialisedMessage);
+  // As above, without blocking anyone: returns true if |handler| will be called with the outcome.
+  // It's called on one of the verifier's threads, or on the thread driving the expiry of key
+  // requests if they time out.
+  bool Add(MessageHeader, MessageTypeTag, SerialisedMessage, ResultHandler handler);
+
+  template <class Handler /* void(NodeAddress) */>
+  void SetSendGetKey(Handler handler) {
+    send_get_key_ = std::move(handler);
+  }
+
+  template <class Handler /* void(GroupAddress) */>
+  void SetSendGetGroupKey(Handler handler) {
+    send_get_group_key_ = std::move(handler);
+  }
+
+  // |check| is given the members a group key response lists, closest to the group first, and
+  // should return false if, as far as we know, they aren't the group's closest nodes.  Without it
+  // a response is only checked for being signed by a quorum of the members it lists.
+  template <class Check /* bool(const GroupAddress&, const std::vector<Address>&) */>
+  void SetCheckCloseGroup(Check check) {
+    check_close_group_ = std::move(check);
+  }
+
+  // |node| joined or left, so cached keys for any group it affects can no longer be trusted.
+  void HandleChurn(const Address& node) { key_cache_.HandleChurn(node); }
+  const KeyCache& key_cache() const { return key_cache_; }
+
+  // Number of key requests sent, and number of checks which found the keys they needed already
+  // requested for an earlier check, so avoided sending a request of their own.
+  uint64_t KeyRequestsSent() const { return key_requests_sent_; }
+  uint64_t KeyRequestsSaved() const { return key_requests_saved_; }
   ResultType AccumulateDirectValue(NodeAddress);
   ResultType AccumulateDhtValue(GroupAddress);
   std::vector<std::pair<asymm::PublicKey, Address>> AccumulateKeys(GroupAddress);
 
  private:
+  // A group message's parts share the original request's message id, so parts are accumulated per
+  // (group, message id) rather than per group.
+  using GroupMessage = std::pair<GroupAddress, MessageId>;
+  using Keys = KeyCache::Keys;
+
+  // Each sender's signature and addresses; the message itself is held once per distinct content.
+  struct Entry {
+    SourceAddress source;
+    MessageTypeTag tag;
+    asymm::Signature signature;
+  };
+  using Votes = VoteAccumulator<GroupMessage, Entry>;
+  using Parts = Votes::Map;
+
+  // A check waiting for keys.
+  struct ParkedCheck {
+    Parts parts;
+    size_t quorum;
+    ResultHandler handler;
+  };
+
+  // A key request in flight, shared by every check which needs its keys.  Times out at |deadline|
+  // on the expiry wheel, or without one when the next call to Add finds it older than the timeout.
+  struct PendingKeyRequest {
+    std::chrono::steady_clock::time_point sent;
+    TimingWheel::TimerId deadline;
+    std::vector<ParkedCheck> parked;
+  };
+
+  // Learns the keys in a response agreed on by a quorum of |parts|, once each part's signature
+  // checks against the key the response gives for its sender.
+  void AddKeys(const MessageHeader& header, MessageTypeTag tag, const SerialisedMessage& body,
+               const Parts& parts);
+  bool SignedByQuorum(const Parts& parts, const Keys& keys, const SerialisedMessage& body) const;
+  template <typename Name, typename SendRequest>
+  PendingKeyRequest& RequestKeys(std::map<Name, PendingKeyRequest>& pending, const Name& name,
+                                 const SendRequest& send_request);
+  template <typename Name>
+  void ReleaseParked(std::map<Name, PendingKeyRequest>& pending, const Name& name,
+                     const Keys& keys);
+  template <typename Name>
+  void ExpireKeyRequest(std::map<Name, PendingKeyRequest>& pending, const Name& name);
+  void ExpireKeyRequests();
+  template <typename Name>
+  void ExpireKeyRequests(std::map<Name, PendingKeyRequest>& pending,
+                         std::chrono::steady_clock::time_point expired_before);
+  void FailParked(PendingKeyRequest& request);
+  template <typename Name>
+  void CancelDeadlines(const std::map<Name, PendingKeyRequest>& pending);
+  void Park(PendingKeyRequest& request, Parts parts, size_t quorum, ResultHandler handler);
+  void Verify(const Parts& parts, const Keys& keys, size_t quorum, ResultHandler handler);
+
   asio::io_service& io_service_;
-  Accumulator<NodeAddress, ResultType> node_accumulator_{std::chrono::minutes(20), 1U};
-  Accumulator<GroupAddress, ResultType> group_accumulator_{std::chrono::minutes(20), QuorumSize};
-  Accumulator<GroupAddress, ResultType> group_key_accumulator_{std::chrono::minutes(20),
-                                                               QuorumSize};
-  Accumulator<NodeAddress, ResultType> node_key_accumulator_{std::chrono::minutes(20), QuorumSize};
+  const std::chrono::steady_clock::duration key_request_timeout_;
+  TimingWheel* const expiry_wheel_;
+  SignatureVerifier verifier_;
+  std::function<void(NodeAddress)> send_get_key_;
+  std::function<void(GroupAddress)> send_get_group_key_;
+  std::function<bool(const GroupAddress&, const std::vector<Address>&)> check_close_group_;
+  std::map<GroupAddress, PendingKeyRequest> pending_group_keys_;
+  std::map<NodeAddress, PendingKeyRequest> pending_node_keys_;
+  KeyCache key_cache_;
+  uint64_t key_requests_sent_;
+  uint64_t key_requests_saved_;
+  Votes group_accumulator_;
+  Votes key_accumulator_;
 };
 
 }  // namespace routing
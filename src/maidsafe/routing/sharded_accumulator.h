@@ -0,0 +1,145 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SHARDED_ACCUMULATOR_H_
+#define MAIDSAFE_ROUTING_SHARDED_ACCUMULATOR_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/node_id.h"
+
+#include "maidsafe/routing/accumulator.h"
+#include "maidsafe/routing/hash.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Thread-safe Accumulator.  Names are partitioned across a number of shards, each an Accumulator
+// with its own lock, so workers adding parts for different names rarely contend.  Unlike
+// Accumulator::Add, Add here reports a quorum exactly once per name: only to the call whose part
+// completes it.  The parts are returned as a copy, since a view can't outlive the shard's lock.
+// Expiry is as for an Accumulator without a TimingWheel (the wheel's callbacks wouldn't take the
+// shard locks), and |capacity| is split evenly between the shards.
+template <typename NameType, typename ValueType, typename Hash = detail::Hasher<NameType>>
+class ShardedAccumulator {
+ public:
+  using Map = typename Accumulator<NameType, ValueType, Hash>::Map;
+  using Parts = std::pair<NameType, Map>;
+
+  ShardedAccumulator(std::chrono::steady_clock::duration time_to_live, uint32_t quorum,
+                     size_t shard_count = DefaultShardCount(),
+                     size_t capacity = std::numeric_limits<size_t>::max())
+      : shards_(), hash_() {
+    shard_count = std::max(shard_count, size_t(1));
+    const size_t shard_capacity(std::max(capacity / shard_count, size_t(1)));
+    for (size_t i(0); i < shard_count; ++i)
+      shards_.emplace_back(new Shard(time_to_live, quorum, shard_capacity));
+  }
+
+  ShardedAccumulator(const ShardedAccumulator&) = delete;
+  ShardedAccumulator(ShardedAccumulator&&) = delete;
+  ~ShardedAccumulator() = default;
+  ShardedAccumulator& operator=(const ShardedAccumulator&) = delete;
+  ShardedAccumulator& operator=(ShardedAccumulator&&) = delete;
+
+  // A few shards per hardware thread keeps the chance of two workers colliding low.
+  static size_t DefaultShardCount() {
+    return 4 * std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  bool HaveName(const NameType& name) const {
+    auto& shard(ShardFor(name));
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.accumulator.HaveName(name);
+  }
+
+  bool CheckQuorumReached(const NameType& name) const {
+    auto& shard(ShardFor(name));
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.accumulator.CheckQuorumReached(name);
+  }
+
+  // Returns the parts to the caller whose part brings the name to quorum, and nothing to anyone
+  // else, including later parts or a repeat part from a sender already counted.  (A name which
+  // expires or is evicted and then accumulates again can reach quorum again.)
+  boost::optional<Parts> Add(const NameType& name, ValueType value, NodeId sender) {
+    auto& shard(ShardFor(name));
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const bool reached_before(shard.accumulator.CheckQuorumReached(name));
+    const auto parts(shard.accumulator.Add(name, std::move(value), std::move(sender)));
+    if (!parts || reached_before)
+      return boost::none;
+    return Parts(parts->first, parts->second);
+  }
+
+  boost::optional<Parts> GetAll(const NameType& name) const {
+    auto& shard(ShardFor(name));
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    const auto parts(shard.accumulator.GetAll(name));
+    if (!parts)
+      return boost::none;
+    return Parts(parts->first, parts->second);
+  }
+
+  size_t size() const {
+    size_t total(0);
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      total += shard->accumulator.size();
+    }
+    return total;
+  }
+
+  size_t ShardCount() const { return shards_.size(); }
+
+ private:
+  struct Shard {
+    Shard(std::chrono::steady_clock::duration time_to_live, uint32_t quorum, size_t capacity)
+        : mutex(), accumulator(time_to_live, quorum, capacity, nullptr) {}
+
+    std::mutex mutex;
+    Accumulator<NameType, ValueType, Hash> accumulator;
+  };
+
+  // The accumulator's table indexes by the low bits of the hash, so the shard is chosen from the
+  // high bits of a remixed hash to keep the two independent.
+  Shard& ShardFor(const NameType& name) const {
+    const uint64_t mixed(static_cast<uint64_t>(hash_(name)) * 0x9e3779b97f4a7c15ULL);
+    return *shards_[static_cast<size_t>(mixed >> 32) % shards_.size()];
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  Hash hash_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SHARDED_ACCUMULATOR_H_
@@ -0,0 +1,113 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signature_cache.h"
+
+#include <utility>
+
+#include "maidsafe/common/crypto.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+std::string HashOf(const std::string& input) {
+  return crypto::Hash<crypto::SHA512>(input).string();
+}
+
+}  // unnamed namespace
+
+SignatureCache::SignatureCache(size_t capacity)
+    : capacity_(capacity), mutex_(), usage_(), entries_(), hits_(0), misses_(0) {}
+
+SignatureCache::Key SignatureCache::MakeKey(const asymm::PublicKey& public_key,
+                                            const SerialisedMessage& message,
+                                            const asymm::Signature& signature) {
+  return MakeKey(public_key, MessageDigest(message), signature);
+}
+
+SignatureCache::Key SignatureCache::MakeKey(const asymm::PublicKey& public_key,
+                                            std::string message_digest,
+                                            const asymm::Signature& signature) {
+  return std::make_tuple(HashOf(asymm::EncodeKey(public_key).string()), std::move(message_digest),
+                         HashOf(signature.string()));
+}
+
+std::string SignatureCache::MessageDigest(const SerialisedMessage& message) {
+  std::string digest(crypto::SHA512::DIGESTSIZE, 0);
+  crypto::SHA512().CalculateDigest(reinterpret_cast<byte*>(&digest[0]), message.data(),
+                                   message.size());
+  return digest;
+}
+
+boost::optional<bool> SignatureCache::Get(const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it(entries_.find(key));
+  if (it == std::end(entries_)) {
+    ++misses_;
+    return boost::none;
+  }
+  ++hits_;
+  usage_.splice(std::end(usage_), usage_, it->second.second);
+  return it->second.first;
+}
+
+void SignatureCache::Add(Key key, bool valid) {
+  if (capacity_ == 0)
+    return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it(entries_.find(key));
+  if (it != std::end(entries_)) {
+    it->second.first = valid;
+    usage_.splice(std::end(usage_), usage_, it->second.second);
+    return;
+  }
+  if (entries_.size() >= capacity_) {
+    entries_.erase(usage_.front());
+    usage_.pop_front();
+  }
+  const auto usage_it(usage_.insert(std::end(usage_), key));
+  entries_.insert(std::make_pair(std::move(key), Entry(valid, usage_it)));
+}
+
+size_t SignatureCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+uint64_t SignatureCache::Hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t SignatureCache::Misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+double SignatureCache::HitRate() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto lookups(hits_ + misses_);
+  return lookups == 0 ? 0.0 : static_cast<double>(hits_) / lookups;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
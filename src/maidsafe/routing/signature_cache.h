@@ -0,0 +1,87 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SIGNATURE_CACHE_H_
+#define MAIDSAFE_ROUTING_SIGNATURE_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Bounded LRU cache of signature check results, so that copies of the same signed message arriving
+// along different swarm paths are only checked once.  Entries are keyed by the hashes of the public
+// key, the message and the signature, so any change to any of the three is a miss.  Thread-safe.
+class SignatureCache {
+ public:
+  using Key = std::tuple<std::string, std::string, std::string>;
+
+  explicit SignatureCache(size_t capacity);
+  SignatureCache(const SignatureCache&) = delete;
+  SignatureCache(SignatureCache&&) = delete;
+  ~SignatureCache() = default;
+  SignatureCache& operator=(const SignatureCache&) = delete;
+  SignatureCache& operator=(SignatureCache&&) = delete;
+
+  static Key MakeKey(const asymm::PublicKey& public_key, const SerialisedMessage& message,
+                     const asymm::Signature& signature);
+  // As above, with |message_digest| from MessageDigest, so that a message signed by several keys
+  // (e.g. the parts of a group message) is only hashed once.
+  static Key MakeKey(const asymm::PublicKey& public_key, std::string message_digest,
+                     const asymm::Signature& signature);
+  static std::string MessageDigest(const SerialisedMessage& message);
+
+  // Returns the cached result of checking the signature, if any.
+  boost::optional<bool> Get(const Key& key);
+  void Add(Key key, bool valid);
+
+  size_t size() const;
+  uint64_t Hits() const;
+  uint64_t Misses() const;
+  // Fraction of lookups which were hits, or 0 if there have been none.
+  double HitRate() const;
+
+ private:
+  using Entry = std::pair<bool, std::list<Key>::iterator>;
+
+  const size_t capacity_;
+  mutable std::mutex mutex_;
+  std::list<Key> usage_;
+  std::map<Key, Entry> entries_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SIGNATURE_CACHE_H_
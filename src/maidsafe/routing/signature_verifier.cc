@@ -0,0 +1,147 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signature_verifier.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+struct SignatureVerifier::Batch {
+  Batch(std::vector<Item> items_in, size_t quorum_in, Handler handler_in)
+      : items(std::move(items_in)),
+        quorum(quorum_in),
+        handler(std::move(handler_in)),
+        decided(false),
+        failed(0),
+        mutex(),
+        verified(),
+        cache_keys(),
+        plain_texts() {}
+
+  // Items sharing a message (as the parts of a group message do) share its digest and plain text,
+  // so each distinct message is hashed and copied once per batch rather than once per item.
+  void Prepare() {
+    const SerialisedMessage* previous(nullptr);
+    std::string digest;
+    std::shared_ptr<const asymm::PlainText> plain_text;
+    for (const auto& item : items) {
+      if (item.message.get() != previous) {
+        previous = item.message.get();
+        digest = SignatureCache::MessageDigest(*item.message);
+        plain_text.reset();  // an empty message can't have been signed
+        if (!item.message->empty()) {
+          plain_text = std::make_shared<const asymm::PlainText>(
+              std::string(std::begin(*item.message), std::end(*item.message)));
+        }
+      }
+      cache_keys.push_back(SignatureCache::MakeKey(item.public_key, digest, item.signature));
+      plain_texts.push_back(plain_text);
+    }
+  }
+
+  const std::vector<Item> items;
+  const size_t quorum;
+  const Handler handler;
+  std::atomic<bool> decided;
+  std::atomic<size_t> failed;
+  std::mutex mutex;
+  std::vector<size_t> verified;
+  // Filled by Prepare before any item is verified, then only read.
+  std::vector<SignatureCache::Key> cache_keys;
+  std::vector<std::shared_ptr<const asymm::PlainText>> plain_texts;
+};
+
+SignatureVerifier::SignatureVerifier(uint32_t thread_count, size_t cache_capacity)
+    : thread_count_(thread_count == 0 ? 1 : thread_count),
+      verifications_performed_(0),
+      verifications_skipped_(0),
+      cache_(cache_capacity),
+      asio_service_(thread_count_) {}
+
+SignatureVerifier::~SignatureVerifier() { asio_service_.Stop(); }
+
+void SignatureVerifier::VerifyQuorum(std::vector<Item> items, size_t quorum, Handler handler) {
+  if (quorum == 0 || items.size() < quorum) {
+    LOG(kVerbose) << "Quorum of " << quorum << " impossible from " << items.size() << " items.";
+    asio_service_.service().post(
+        [handler, quorum] { handler(quorum == 0, std::vector<size_t>()); });
+    return;
+  }
+  auto batch(std::make_shared<Batch>(std::move(items), quorum, std::move(handler)));
+  asio_service_.service().post([this, batch] {
+    batch->Prepare();
+    for (size_t index(0); index < batch->items.size(); ++index)
+      asio_service_.service().post([this, batch, index] { Verify(batch, index); });
+  });
+}
+
+void SignatureVerifier::Verify(const std::shared_ptr<Batch>& batch, size_t index) {
+  if (batch->decided) {
+    ++verifications_skipped_;
+    return;
+  }
+
+  const Item& item(batch->items[index]);
+  auto cache_key(batch->cache_keys[index]);
+  const auto cached(cache_.Get(cache_key));
+  bool valid(false);
+  if (cached) {
+    valid = *cached;
+  } else {
+    try {
+      const auto& plain_text(batch->plain_texts[index]);
+      valid = plain_text && asymm::CheckSignature(*plain_text, item.signature, item.public_key);
+      cache_.Add(std::move(cache_key), valid);
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Signature check threw: " << e.what();
+    }
+    ++verifications_performed_;
+  }
+
+  std::vector<size_t> verified;
+  bool quorum_reached(false);
+  if (valid) {
+    std::lock_guard<std::mutex> lock(batch->mutex);
+    batch->verified.push_back(index);
+    if (batch->verified.size() < batch->quorum)
+      return;
+    verified = batch->verified;
+    quorum_reached = true;
+  } else if (++batch->failed <= batch->items.size() - batch->quorum) {
+    return;
+  } else {
+    std::lock_guard<std::mutex> lock(batch->mutex);
+    verified = batch->verified;
+  }
+
+  // Only the first thread to decide the outcome calls the handler.
+  if (!batch->decided.exchange(true))
+    batch->handler(quorum_reached, std::move(verified));
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
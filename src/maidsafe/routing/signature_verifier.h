@@ -0,0 +1,88 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SIGNATURE_VERIFIER_H_
+#define MAIDSAFE_ROUTING_SIGNATURE_VERIFIER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/routing/signature_cache.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Verifies batches of (key, message, signature) triples on a dedicated pool of worker threads.  A
+// batch only needs a quorum of valid signatures, so once the quorum is reached (or can no longer be
+// reached) any of its checks which haven't yet started are skipped.  Results are cached, so a
+// message seen again (e.g. via another swarm path) isn't re-checked.
+class SignatureVerifier {
+ public:
+  static const size_t kDefaultCacheCapacity = 10000;
+
+  struct Item {
+    asymm::PublicKey public_key;
+    std::shared_ptr<const SerialisedMessage> message;
+    asymm::Signature signature;
+  };
+
+  // Called exactly once per batch, on one of the worker threads.  |verified| holds the indices
+  // into the batch of the items which had verified when the outcome was decided.
+  using Handler = std::function<void(bool quorum_reached, std::vector<size_t> verified)>;
+
+  explicit SignatureVerifier(uint32_t thread_count,
+                             size_t cache_capacity = kDefaultCacheCapacity);
+  SignatureVerifier(const SignatureVerifier&) = delete;
+  SignatureVerifier(SignatureVerifier&&) = delete;
+  ~SignatureVerifier();
+  SignatureVerifier& operator=(const SignatureVerifier&) = delete;
+  SignatureVerifier& operator=(SignatureVerifier&&) = delete;
+
+  void VerifyQuorum(std::vector<Item> items, size_t quorum, Handler handler);
+
+  uint32_t ThreadCount() const { return thread_count_; }
+  // Totals across all batches, for diagnostics and benchmarks.
+  uint64_t VerificationsPerformed() const { return verifications_performed_; }
+  uint64_t VerificationsSkipped() const { return verifications_skipped_; }
+  const SignatureCache& Cache() const { return cache_; }
+
+ private:
+  struct Batch;
+
+  void Verify(const std::shared_ptr<Batch>& batch, size_t index);
+
+  const uint32_t thread_count_;
+  std::atomic<uint64_t> verifications_performed_;
+  std::atomic<uint64_t> verifications_skipped_;
+  SignatureCache cache_;
+  AsioService asio_service_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SIGNATURE_VERIFIER_H_
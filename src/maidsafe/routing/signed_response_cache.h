@@ -0,0 +1,98 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SIGNED_RESPONSE_CACHE_H_
+#define MAIDSAFE_ROUTING_SIGNED_RESPONSE_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Caches serialised and signed response bodies which only depend on a target address and our
+// close group (e.g. FindGroupResponse), so repeated requests for the same target cost a lookup
+// rather than a serialisation and an RSA signature.  Every entry is dropped as soon as the close
+// group version moves on.  Not thread-safe; it's used from the routing strand only.
+class SignedResponseCache {
+ public:
+  struct SignedBody {
+    std::shared_ptr<const SerialisedData> body;
+    asymm::Signature signature;
+  };
+
+  explicit SignedResponseCache(size_t capacity)
+      : capacity_(capacity), version_(0), order_(), entries_(), hits_(0), misses_(0) {}
+
+  SignedResponseCache(const SignedResponseCache&) = delete;
+  SignedResponseCache(SignedResponseCache&&) = delete;
+  ~SignedResponseCache() = default;
+  SignedResponseCache& operator=(const SignedResponseCache&) = delete;
+  SignedResponseCache& operator=(SignedResponseCache&&) = delete;
+
+  // Returns the entry for |target| at |close_group_version|, calling |make| to build it if there
+  // isn't one.  |make| must return a SignedBody.
+  template <typename Make>
+  SignedBody Get(const Address& target, uint64_t close_group_version, Make make) {
+    if (close_group_version != version_) {
+      order_.clear();
+      entries_.clear();
+      version_ = close_group_version;
+    }
+    const auto found(entries_.find(target));
+    if (found != std::end(entries_)) {
+      ++hits_;
+      return found->second;
+    }
+    ++misses_;
+    if (capacity_ == 0)
+      return make();
+    if (entries_.size() >= capacity_) {
+      entries_.erase(order_.front());
+      order_.pop_front();
+    }
+    order_.push_back(target);
+    return entries_.insert(std::make_pair(target, make())).first->second;
+  }
+
+  size_t size() const { return entries_.size(); }
+  uint64_t Hits() const { return hits_; }
+  uint64_t Misses() const { return misses_; }
+
+ private:
+  const size_t capacity_;
+  uint64_t version_;
+  std::list<Address> order_;
+  std::map<Address, SignedBody> entries_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SIGNED_RESPONSE_CACHE_H_
@@ -0,0 +1,89 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/swarm_fanout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+const size_t SwarmFanout::kRanges;
+
+SwarmFanout::SwarmFanout(Address our_id, SwarmOptions options)
+    : our_id_(std::move(our_id)), options_(std::move(options)), mutex_(), ranges_() {
+  if (options_.min_fanout == 0 || options_.min_fanout > options_.max_fanout ||
+      options_.sample_size == 0 || options_.target_copies < 1.0) {
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  }
+  for (auto& range : ranges_)
+    range = Range{options_.max_fanout, 0, 0};
+}
+
+void SwarmFanout::Duplicate(const Address& destination) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++ranges_[RangeIndex(destination)].copies;
+}
+
+size_t SwarmFanout::Fanout(const Address& destination) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ranges_[RangeIndex(destination)].fanout;
+}
+
+double SwarmFanout::Copies(const Address& destination) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto& range(ranges_[RangeIndex(destination)]);
+  return range.messages == 0 ? 0.0 : static_cast<double>(range.copies) / range.messages;
+}
+
+size_t SwarmFanout::RangeIndex(const Address& destination) const {
+  if (destination == our_id_)
+    return kRanges - 1;
+  return std::min(static_cast<size_t>(our_id_.CommonLeadingBits(destination)), kRanges - 1);
+}
+
+size_t SwarmFanout::Record(const Address& destination) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& range(ranges_[RangeIndex(destination)]);
+  ++range.copies;
+  if (++range.messages < options_.sample_size)
+    return range.fanout;
+  // The copies we receive are roughly the fan-out of the nodes ranked before us, which are adapting
+  // to the same conditions as we are, so the fan-out is scaled towards the target in one step.
+  // Half a copy either side of the target is tolerated, so that occasional losses don't make the
+  // fan-out oscillate.  Duplicates still in flight for the sample just closed count towards the
+  // next one.
+  const double copies(static_cast<double>(range.copies) / range.messages);
+  if (copies > options_.target_copies + 0.5 || copies < options_.target_copies - 0.5) {
+    const auto scaled(static_cast<size_t>(
+        std::ceil(static_cast<double>(range.fanout) * options_.target_copies / copies)));
+    range.fanout = std::min(std::max(scaled, options_.min_fanout), options_.max_fanout);
+  }
+  range.messages = 0;
+  range.copies = 0;
+  return range.fanout;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
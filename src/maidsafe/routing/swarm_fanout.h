@@ -0,0 +1,115 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SWARM_FANOUT_H_
+#define MAIDSAFE_ROUTING_SWARM_FANOUT_H_
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+struct SwarmOptions {
+  SwarmOptions() : target_copies(2.0), min_fanout(2), max_fanout(GroupSize), sample_size(32) {}
+
+  // Copies of each message (the first included) a node should receive.  Two means any single
+  // lost send or failed peer still leaves every node with a copy.
+  double target_copies;
+  size_t min_fanout;
+  // Also the fan-out a destination range starts at, i.e. the full swarm.
+  size_t max_fanout;
+  // Messages received for a destination range between adjustments of its fan-out.
+  size_t sample_size;
+};
+
+// Adapts how many peers a swarmed message is forwarded to.  Every node forwards to all of its
+// targets for a destination, so each copy of a group message is sent on by every member and
+// crosses the group O(GroupSize^2) times before the filters drop it.  Instead, each destination
+// range (the number of leading bits the destination shares with us) has its own fan-out, scaled
+// down while the messages we receive for that range arrive with more than |target_copies| copies
+// each, and back up when they arrive with fewer.
+//
+// Targets are chosen so that reduced fan-outs still cover the group: the targets are ranked by
+// distance to the destination, and a node forwards to the peers ranked immediately after its own
+// position (wrapping around).  With every node doing the same the group forms a ring in which
+// each member is sent a copy by the |fanout| members ranked before it.  Thread-safe.
+class SwarmFanout {
+ public:
+  static const size_t kRanges = 64;
+
+  explicit SwarmFanout(Address our_id, SwarmOptions options = SwarmOptions());
+  SwarmFanout(const SwarmFanout&) = delete;
+  SwarmFanout(SwarmFanout&&) = delete;
+  ~SwarmFanout() = default;
+  SwarmFanout& operator=(const SwarmFanout&) = delete;
+  SwarmFanout& operator=(SwarmFanout&&) = delete;
+
+  // Records the first copy of a message for |destination| and returns which of |targets| (ordered
+  // closest to |destination| first, as from ConnectionManager::GetTarget) to forward it to.
+  template <typename Targets>
+  std::vector<Address> Received(const Address& destination, const Targets& targets);
+  // Records a further copy of a message, already dropped by the filter.
+  void Duplicate(const Address& destination);
+
+  size_t Fanout(const Address& destination) const;
+  // Copies received per message since the last adjustment for |destination|'s range.
+  double Copies(const Address& destination) const;
+
+ private:
+  struct Range {
+    size_t fanout;
+    uint64_t messages, copies;
+  };
+
+  size_t RangeIndex(const Address& destination) const;
+  size_t Record(const Address& destination);
+
+  const Address our_id_;
+  const SwarmOptions options_;
+  mutable std::mutex mutex_;
+  std::array<Range, kRanges> ranges_;
+};
+
+template <typename Targets>
+std::vector<Address> SwarmFanout::Received(const Address& destination, const Targets& targets) {
+  const size_t fanout(Record(destination));
+  std::vector<Address> all(std::begin(targets), std::end(targets));
+  if (all.size() <= fanout)
+    return all;
+  // Our rank among the targets, i.e. the number of them closer to the destination than us.
+  size_t position(0);
+  while (position < all.size() && Address::CloserToTarget(all[position], our_id_, destination))
+    ++position;
+  std::vector<Address> selected;
+  selected.reserve(fanout);
+  for (size_t i(0); i < fanout; ++i)
+    selected.push_back(all[(position + i) % all.size()]);
+  return selected;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SWARM_FANOUT_H_
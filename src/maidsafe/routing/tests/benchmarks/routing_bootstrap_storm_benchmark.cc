@@ -0,0 +1,169 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Compares the CPU cost of building the outbound Connect messages produced while handling a
+// FindGroupResponse during bootstrap: serialising per target (the old behaviour) versus
+// serialising once per group member and sharing the buffer between targets (OutboundMessage).
+// The socket send is replaced by retaining the buffer, as the real send does until completion.
+// Only the number of serialisations is checked; the times are reported.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/outbound_message.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/connect.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+const size_t kFindGroupResponses = 100;
+const size_t kTargetsPerMember = GroupSize;
+
+struct StormInput {
+  std::vector<std::pair<MessageHeader, Connect>> messages;
+};
+
+StormInput GenerateStorm(const passport::PublicPmid& our_fob) {
+  StormInput input;
+  const Address our_id(our_fob.name()->string());
+  for (size_t i(0); i < GroupSize; ++i) {
+    Address node_id(RandomString(Address::kSize));
+    MessageHeader header(DestinationAddress(std::make_pair(Destination(node_id), boost::none)),
+                         SourceAddress(NodeAddress(our_id), boost::none, boost::none),
+                         RandomUint32(), Authority::nae_manager);
+    EndpointPair endpoints;
+    endpoints.local = GetRandomEndpoint();
+    endpoints.external = GetRandomEndpoint();
+    input.messages.emplace_back(std::move(header), Connect(endpoints, our_id, node_id, our_fob));
+  }
+  return input;
+}
+
+template <typename Function>
+std::chrono::microseconds Time(Function function) {
+  const auto start(std::chrono::steady_clock::now());
+  function();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                start);
+}
+
+// Each distinct buffer retained for sending was serialised separately.
+template <typename Buffers, typename GetBuffer>
+size_t CountSerialisations(const Buffers& buffers, GetBuffer get_buffer) {
+  std::set<const SerialisedMessage*> distinct;
+  for (const auto& buffer : buffers)
+    distinct.insert(get_buffer(buffer));
+  return distinct.size();
+}
+
+}  // anonymous namespace
+
+TEST(BootstrapStormBenchmark, FUNC_SerialisePerTargetVersusOnce) {
+  const passport::PublicPmid our_fob(PublicFob());
+  const auto storm(GenerateStorm(our_fob));
+  std::vector<std::shared_ptr<const SerialisedMessage>> in_flight;
+  in_flight.reserve(GroupSize * kTargetsPerMember);
+
+  const auto per_target(Time([&] {
+    for (size_t response(0); response < kFindGroupResponses; ++response) {
+      in_flight.clear();
+      for (const auto& message : storm.messages) {
+        for (size_t target(0); target < kTargetsPerMember; ++target) {
+          in_flight.push_back(std::make_shared<const SerialisedMessage>(
+              Serialise(message.first, MessageToTag<Connect>::value, message.second)));
+        }
+      }
+    }
+  }));
+  // Serialisations per FindGroupResponse, counted over the buffers retained by the final round.
+  const auto per_target_serialisations(CountSerialisations(
+      in_flight, [](const std::shared_ptr<const SerialisedMessage>& buffer) {
+        return buffer.get();
+      }));
+
+  size_t bytes(0);
+  const auto once(Time([&] {
+    for (size_t response(0); response < kFindGroupResponses; ++response) {
+      in_flight.clear();
+      for (const auto& message : storm.messages) {
+        OutboundMessage outbound(message.first, message.second);
+        bytes = outbound.Serialised().size();
+        for (size_t target(0); target < kTargetsPerMember; ++target)
+          in_flight.push_back(std::make_shared<const SerialisedMessage>(outbound.Serialised()));
+      }
+    }
+  }));
+
+  // Shared buffer as used by OutboundMessage::Send, which retains a copy of the OutboundMessage
+  // (and so its buffer) per target rather than copying any bytes.
+  std::vector<OutboundMessage> sent;
+  sent.reserve(GroupSize * kTargetsPerMember);
+  const auto shared(Time([&] {
+    for (size_t response(0); response < kFindGroupResponses; ++response) {
+      sent.clear();
+      for (const auto& message : storm.messages) {
+        OutboundMessage outbound(message.first, message.second);
+        for (size_t target(0); target < kTargetsPerMember; ++target)
+          sent.push_back(outbound);
+      }
+    }
+  }));
+
+  const auto shared_serialisations(CountSerialisations(
+      sent, [](const OutboundMessage& outbound) { return &outbound.Serialised(); }));
+
+  const auto messages(kFindGroupResponses * GroupSize * kTargetsPerMember);
+  std::cout << "Bootstrap storm: " << kFindGroupResponses << " FindGroupResponses, " << GroupSize
+            << " members, " << kTargetsPerMember << " targets each, " << bytes
+            << " bytes per Connect\n"
+            << "  serialise per target:          " << per_target.count() << " us ("
+            << (per_target.count() * 1000.0 / messages) << " ns/send, "
+            << per_target_serialisations << " serialisations per response)\n"
+            << "  serialise once, copy buffer:   " << once.count() << " us ("
+            << (once.count() * 1000.0 / messages) << " ns/send)\n"
+            << "  serialise once, shared buffer: " << shared.count() << " us ("
+            << (shared.count() * 1000.0 / messages) << " ns/send, " << shared_serialisations
+            << " serialisations per response)\n"
+            << "  CPU saved: "
+            << (100.0 * (per_target.count() - shared.count()) / per_target.count()) << "%\n";
+  EXPECT_EQ(GroupSize * kTargetsPerMember, per_target_serialisations);
+  EXPECT_EQ(GroupSize * kTargetsPerMember, sent.size());
+  EXPECT_EQ(GroupSize, shared_serialisations);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,188 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Compares three ways of writing persona code which issues many concurrent chains of routing
+// requests: chained callbacks, futures (issuing one request per chain and then waiting for them
+// all, step by step) and stackless coroutines.  Requests complete from a multi-threaded
+// io_service, as RoutingNode's do when their responses arrive.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "asio/async_result.hpp"
+#include "asio/io_service.hpp"
+#include "asio/post.hpp"
+#include "asio/use_future.hpp"
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/routing/coroutine.h"
+#include "maidsafe/routing/types.h"
+
+#include "asio/yield.hpp"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+const uint32_t kChains = 1000;
+const uint32_t kRequestsPerChain = 50;
+
+template <typename CompletionToken>
+GetReturn<CompletionToken> AsyncGet(asio::io_service& io_service, uint32_t name,
+                                    CompletionToken&& token) {
+  GetHandler<CompletionToken> handler(std::forward<CompletionToken>(token));
+  asio::async_result<decltype(handler)> result(handler);
+  asio::post(io_service, [handler, name]() mutable {
+    handler(asio::error_code(), SerialisedMessage(4, static_cast<byte>(name)));
+  });
+  return result.get();
+}
+
+// Runs |io_service| on every hardware thread while |workload| runs, returning requests per second.
+template <typename Workload>
+double Measure(const Workload& workload) {
+  asio::io_service io_service;
+  std::unique_ptr<asio::io_service::work> work(new asio::io_service::work(io_service));
+  std::vector<std::thread> threads;
+  for (unsigned i(0); i != std::max(2U, std::thread::hardware_concurrency()); ++i)
+    threads.emplace_back([&] { io_service.run(); });
+  const auto start(std::chrono::steady_clock::now());
+  const auto completed(workload(io_service));
+  const std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - start);
+  work.reset();
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(kChains * kRequestsPerChain, completed);
+  return completed / elapsed.count();
+}
+
+void WaitFor(const std::atomic<uint32_t>& done) {
+  while (done < kChains)
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+}
+
+class CallbackChain : public std::enable_shared_from_this<CallbackChain> {
+ public:
+  CallbackChain(asio::io_service& io_service, std::atomic<uint32_t>& completed,
+                std::atomic<uint32_t>& done)
+      : io_service_(io_service), completed_(completed), done_(done), name_(0) {}
+
+  void Next() {
+    if (name_ == kRequestsPerChain) {
+      ++done_;
+      return;
+    }
+    auto self(shared_from_this());
+    AsyncGet(io_service_, name_++, [self](asio::error_code error, SerialisedMessage) {
+      if (!error)
+        ++self->completed_;
+      self->Next();
+    });
+  }
+
+ private:
+  asio::io_service& io_service_;
+  std::atomic<uint32_t>& completed_;
+  std::atomic<uint32_t>& done_;
+  uint32_t name_;
+};
+
+struct CoroutineChain {
+  template <typename Coroutine>
+  void operator()(Coroutine& coroutine) {
+    reenter(coroutine) {
+      for (name = 0; name != kRequestsPerChain; ++name) {
+        yield AsyncGet(*io_service, name, coroutine.Await(error, data));
+        if (!error)
+          ++*completed;
+      }
+      ++*done;
+    }
+  }
+
+  asio::io_service* io_service;
+  std::atomic<uint32_t>* completed;
+  std::atomic<uint32_t>* done;
+  uint32_t name;
+  asio::error_code error;
+  SerialisedMessage data;
+};
+
+}  // anonymous namespace
+
+TEST(CoroutineBenchmark, FUNC_CallbackFutureCoroutine) {
+  const auto callbacks(Measure([](asio::io_service& io_service) {
+    std::atomic<uint32_t> completed(0), done(0);
+    for (uint32_t i(0); i != kChains; ++i)
+      std::make_shared<CallbackChain>(io_service, completed, done)->Next();
+    WaitFor(done);
+    return completed.load();
+  }));
+
+  const auto futures(Measure([](asio::io_service& io_service) {
+    uint32_t completed(0);
+    std::vector<std::future<SerialisedMessage>> step(kChains);
+    for (uint32_t name(0); name != kRequestsPerChain; ++name) {
+      for (auto& future : step)
+        future = AsyncGet(io_service, name, asio::use_future);
+      for (auto& future : step) {
+        future.get();
+        ++completed;
+      }
+    }
+    return completed;
+  }));
+
+  const auto coroutines(Measure([](asio::io_service& io_service) {
+    std::atomic<uint32_t> completed(0), done(0);
+    for (uint32_t i(0); i != kChains; ++i) {
+      CoroutineChain chain = CoroutineChain();
+      chain.io_service = &io_service;
+      chain.completed = &completed;
+      chain.done = &done;
+      SpawnCoroutine(chain);
+    }
+    WaitFor(done);
+    return completed.load();
+  }));
+
+  std::cout << kChains << " concurrent chains of " << kRequestsPerChain << " requests\n"
+            << "  callbacks:  " << callbacks << " requests/s\n"
+            << "  futures:    " << futures << " requests/s\n"
+            << "  coroutines: " << coroutines << " requests/s\n";
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#include "asio/unyield.hpp"
@@ -0,0 +1,127 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Measures the FindGroup handling rate (build the response, sign it and serialise the reply) with
+// the per-request signature RoutingNode used to do, versus SignedResponseCache which signs once
+// per target per close group version.  Requests are spread over a small set of popular targets,
+// as during a bootstrap storm.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/outbound_message.h"
+#include "maidsafe/routing/signed_response_cache.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/find_group_response.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+const size_t kRequests = 2000;
+const size_t kTargets = 20;
+// The close group changes (churn) every this many requests.
+const size_t kRequestsPerVersion = 500;
+
+MessageHeader ReplyHeader(const Address& target, const asymm::Signature& signature) {
+  return MessageHeader(
+      DestinationAddress(std::make_pair(Destination(Address(RandomString(Address::kSize))),
+                                        boost::none)),
+      SourceAddress(NodeAddress(target), GroupAddress(target), boost::none), RandomUint32(),
+      Authority::nae_manager, signature);
+}
+
+}  // anonymous namespace
+
+TEST(FindGroupBenchmark, FUNC_SignPerRequestVersusCached) {
+  const passport::Pmid our_fob{passport::Anpmid()};
+  const std::vector<passport::PublicPmid> close_group(GroupSize - 1, PublicFob());
+  std::vector<Address> targets;
+  for (size_t i(0); i < kTargets; ++i)
+    targets.emplace_back(RandomString(Address::kSize));
+
+  size_t signatures(0);
+  const auto make_response = [&](const Address& target) {
+    ++signatures;
+    auto group(close_group);
+    group.push_back(passport::PublicPmid(our_fob));
+    auto body(Serialise(FindGroupResponse(target, std::move(group))));
+    auto signature(asymm::Sign(body, our_fob.private_key()));
+    return SignedResponseCache::SignedBody{
+        std::make_shared<const SerialisedData>(std::move(body)), std::move(signature)};
+  };
+
+  size_t bytes(0);
+  auto start(std::chrono::steady_clock::now());
+  for (size_t i(0); i < kRequests; ++i) {
+    const auto& target(targets[i % kTargets]);
+    const auto response(make_response(target));
+    OutboundMessage reply(ReplyHeader(target, response.signature),
+                          MessageTypeTag::FindGroupResponse, *response.body);
+    bytes += reply.Serialised().size();
+  }
+  const auto uncached(std::chrono::duration<double>(std::chrono::steady_clock::now() - start));
+  const auto uncached_signatures(signatures);
+
+  SignedResponseCache cache(1000);
+  signatures = 0;
+  start = std::chrono::steady_clock::now();
+  for (size_t i(0); i < kRequests; ++i) {
+    const auto& target(targets[i % kTargets]);
+    const auto response(
+        cache.Get(target, i / kRequestsPerVersion, [&] { return make_response(target); }));
+    OutboundMessage reply(ReplyHeader(target, response.signature),
+                          MessageTypeTag::FindGroupResponse, *response.body);
+    bytes += reply.Serialised().size();
+  }
+  const auto cached(std::chrono::duration<double>(std::chrono::steady_clock::now() - start));
+
+  std::cout << "FindGroup handling, " << kRequests << " requests over " << kTargets
+            << " targets, close group changing every " << kRequestsPerVersion << " requests\n"
+            << "  sign per request: " << kRequests / uncached.count() << " requests/s\n"
+            << "  cached signature: " << kRequests / cached.count() << " requests/s ("
+            << cache.Misses() << " signatures, " << cache.Hits() << " hits)\n";
+  // The rates are only reported.  The cache must sign once per target per close group version.
+  EXPECT_GT(bytes, 0U);
+  const size_t versions((kRequests + kRequestsPerVersion - 1) / kRequestsPerVersion);
+  EXPECT_EQ(kRequests, uncached_signatures);
+  EXPECT_EQ(kTargets * versions, signatures);
+  EXPECT_EQ(signatures, cache.Misses());
+  EXPECT_EQ(kRequests - signatures, cache.Hits());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,236 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Serialises and parses every routing message type inside the full wire envelope, exactly as
+// 'Serialise(header, tag, body)' produces it, at representative payload sizes.  For each case it
+// reports the encoded size and its overhead over the raw payload, the serialise and parse
+// throughput, and the number of heap allocations per message (counted by replacing the global
+// operator new in this executable).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/messages.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace {
+
+std::atomic<uint64_t> g_allocations(0);
+
+}  // anonymous namespace
+
+void* operator new(std::size_t size) {
+  ++g_allocations;
+  if (void* memory = std::malloc(size == 0 ? 1 : size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) throw() { std::free(memory); }
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+const size_t kTargetBytesPerCase = 64 * 1024 * 1024;
+const size_t kMaxIterations = 20000;
+const size_t kMinIterations = 10;
+
+struct Result {
+  std::string name;
+  size_t payload_size;
+  size_t encoded_size;
+  double serialise_mib_per_second;
+  double parse_mib_per_second;
+  double serialise_allocations;
+  double parse_allocations;
+};
+
+Address RandomAddress() { return Address(RandomString(Address::kSize)); }
+
+Identity RandomIdentity() { return Identity(RandomString(Address::kSize)); }
+
+SerialisedData RandomData(size_t size) {
+  const auto data(RandomString(size));
+  return SerialisedData(std::begin(data), std::end(data));
+}
+
+EndpointPair RandomEndpointPair() {
+  EndpointPair endpoints;
+  endpoints.local = GetRandomEndpoint();
+  endpoints.external = GetRandomEndpoint();
+  return endpoints;
+}
+
+std::vector<passport::PublicPmid> Group(const passport::PublicPmid& fob) {
+  return std::vector<passport::PublicPmid>(GroupSize, fob);
+}
+
+double MibPerSecond(size_t bytes, std::chrono::steady_clock::duration elapsed) {
+  const auto seconds(std::chrono::duration<double>(elapsed).count());
+  return seconds > 0 ? (bytes / (1024.0 * 1024.0)) / seconds : 0.0;
+}
+
+// |payload_size| is the size of the caller-supplied content (data, fobs, endpoints...) which any
+// encoding has to carry; everything else in the encoded message counts as overhead.
+template <typename Message>
+Result Measure(std::string name, const MessageHeader& header, const Message& message,
+               size_t payload_size) {
+  const auto tag(MessageToTag<Message>::value);
+  const auto encoded(Serialise(header, tag, message));
+  const size_t iterations(std::max(kMinIterations,
+                                   std::min(kMaxIterations, kTargetBytesPerCase / encoded.size())));
+
+  auto allocations_before(g_allocations.load());
+  auto start(std::chrono::steady_clock::now());
+  for (size_t i(0); i < iterations; ++i) {
+    auto serialised(Serialise(header, tag, message));
+    EXPECT_EQ(encoded.size(), serialised.size());
+  }
+  const auto serialise_elapsed(std::chrono::steady_clock::now() - start);
+  const auto serialise_allocations(g_allocations.load() - allocations_before);
+
+  allocations_before = g_allocations.load();
+  start = std::chrono::steady_clock::now();
+  for (size_t i(0); i < iterations; ++i) {
+    InputVectorStream binary_input_stream{encoded};
+    MessageHeader parsed_header;
+    MessageTypeTag parsed_tag;
+    Parse(binary_input_stream, parsed_header, parsed_tag);
+    auto parsed(Parse<Message>(binary_input_stream));
+    EXPECT_EQ(tag, parsed_tag);
+  }
+  const auto parse_elapsed(std::chrono::steady_clock::now() - start);
+  const auto parse_allocations(g_allocations.load() - allocations_before);
+
+  return Result{std::move(name),
+                payload_size,
+                encoded.size(),
+                MibPerSecond(encoded.size() * iterations, serialise_elapsed),
+                MibPerSecond(encoded.size() * iterations, parse_elapsed),
+                static_cast<double>(serialise_allocations) / iterations,
+                static_cast<double>(parse_allocations) / iterations};
+}
+
+void Report(const std::vector<Result>& results) {
+  std::cout << std::left << std::setw(26) << "message" << std::right << std::setw(10)
+            << "payload" << std::setw(10) << "encoded" << std::setw(10) << "overhead"
+            << std::setw(12) << "ser MiB/s" << std::setw(12) << "parse MiB/s" << std::setw(10)
+            << "ser allc" << std::setw(12) << "parse allc" << '\n';
+  std::cout << std::fixed << std::setprecision(1);
+  for (const auto& result : results) {
+    std::cout << std::left << std::setw(26) << result.name << std::right << std::setw(10)
+              << result.payload_size << std::setw(10) << result.encoded_size << std::setw(10)
+              << (result.encoded_size - std::min(result.encoded_size, result.payload_size))
+              << std::setw(12) << result.serialise_mib_per_second << std::setw(12)
+              << result.parse_mib_per_second << std::setw(10) << result.serialise_allocations
+              << std::setw(12) << result.parse_allocations << '\n';
+  }
+}
+
+}  // anonymous namespace
+
+TEST(MessageSerialisationBenchmark, FUNC_AllMessageTypes) {
+  const auto header(GetRandomMessageHeader());
+  const passport::PublicPmid fob(PublicFob());
+  const auto fob_size(Serialise(fob).size());
+  const size_t endpoints_size(2 * 18);  // two IPv6 addresses plus ports
+  const std::vector<size_t> data_sizes{1024, 64 * 1024, 1024 * 1024};
+
+  std::vector<Result> results;
+  results.push_back(Measure("Connect", header,
+                            Connect(RandomEndpointPair(), RandomAddress(), RandomAddress(), fob),
+                            endpoints_size + 2 * Address::kSize + fob_size));
+  results.push_back(Measure("ConnectResponse", header,
+                            ConnectResponse(RandomEndpointPair(), RandomEndpointPair(),
+                                            RandomAddress(), RandomAddress(), fob),
+                            2 * endpoints_size + 2 * Address::kSize + fob_size));
+  results.push_back(Measure("FindGroup", header,
+                            FindGroup(NodeAddress(RandomAddress()), RandomAddress()),
+                            2 * Address::kSize));
+  results.push_back(Measure("FindGroupResponse", header,
+                            FindGroupResponse(RandomAddress(), Group(fob)),
+                            Address::kSize + GroupSize * fob_size));
+  results.push_back(Measure("GetData", header,
+                            GetData(DataTagValue::kImmutableDataValue, RandomIdentity(),
+                                    SourceAddress(NodeAddress(RandomAddress()), boost::none,
+                                                  boost::none)),
+                            2 * Address::kSize));
+  results.push_back(Measure("GetKey", header, GetKey(NodeAddress(RandomAddress())),
+                            Address::kSize));
+  results.push_back(Measure("GetKeyResponse", header,
+                            GetKeyResponse(NodeAddress(RandomAddress()), fob),
+                            Address::kSize + fob_size));
+  results.push_back(Measure("GetGroupKey", header, GetGroupKey(GroupAddress(RandomAddress())),
+                            Address::kSize));
+  results.push_back(Measure("GetGroupKeyResponse", header,
+                            GetGroupKeyResponse(GroupAddress(RandomAddress()), Group(fob)),
+                            Address::kSize + GroupSize * fob_size));
+  results.push_back(Measure("PutKey", header, PutKey(fob), fob_size));
+  results.push_back(Measure("PutDataResponse", header,
+                            PutDataResponse(DataTagValue::kImmutableDataValue, RandomData(0),
+                                            MakeError(CommonErrors::success)),
+                            0));
+  for (const auto size : data_sizes) {
+    const auto suffix(" " + std::to_string(size / 1024) + " KiB");
+    results.push_back(Measure("PutData" + suffix, header,
+                              PutData(DataTagValue::kImmutableDataValue, RandomData(size)),
+                              size));
+    results.push_back(Measure("GetDataResponse" + suffix, header,
+                              GetDataResponse(RandomIdentity(), RandomData(size)),
+                              Address::kSize + size));
+    results.push_back(Measure("Post" + suffix, header,
+                              Post(DataTagValue::kImmutableDataValue, RandomIdentity(),
+                                   RandomData(size)),
+                              Address::kSize + size));
+    results.push_back(Measure("PostResponse" + suffix, header,
+                              PostResponse(DataTagValue::kImmutableDataValue,
+                                           RandomIdentity(), RandomData(size)),
+                              Address::kSize + size));
+  }
+
+  std::cout << "Envelope: MessageHeader + MessageTypeTag + body, header with signature is "
+            << Serialise(header, MessageToTag<PutData>::value).size() << " bytes\n";
+  Report(results);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
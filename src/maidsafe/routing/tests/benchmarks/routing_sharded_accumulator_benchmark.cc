@@ -0,0 +1,134 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Compares the throughput of ShardedAccumulator against a single Accumulator behind one lock, with
+// every hardware thread adding group message parts for many concurrent names.  Both report each
+// quorum exactly once and return it as an owned copy, so they do the same work apart from locking.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/node_id.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/accumulator.h"
+#include "maidsafe/routing/sharded_accumulator.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+const size_t kNames = 20000;
+using Name = std::pair<GroupAddress, MessageId>;
+using Value = std::vector<byte>;
+
+class GloballyLockedAccumulator {
+ public:
+  using Parts = std::pair<Name, Accumulator<Name, Value>::Map>;
+
+  GloballyLockedAccumulator() : mutex_(), accumulator_(std::chrono::minutes(20), QuorumSize) {}
+
+  boost::optional<Parts> Add(const Name& name, Value value, NodeId sender) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool reached_before(accumulator_.CheckQuorumReached(name));
+    const auto parts(accumulator_.Add(name, std::move(value), std::move(sender)));
+    if (!parts || reached_before)
+      return boost::none;
+    return Parts(parts->first, parts->second);
+  }
+
+ private:
+  std::mutex mutex_;
+  Accumulator<Name, Value> accumulator_;
+};
+
+template <typename AccumulatorType>
+std::pair<double, size_t> RunWorkload(AccumulatorType& accumulator, size_t thread_count,
+                                      const std::vector<Name>& names,
+                                      const std::vector<NodeId>& senders, const Value& value) {
+  std::atomic<size_t> quorums(0);
+  std::vector<std::thread> threads;
+  const auto start(std::chrono::steady_clock::now());
+  for (size_t t(0); t < thread_count; ++t) {
+    threads.emplace_back([&, t] {
+      // Each thread takes a different slice of the names in every round of senders.
+      for (const auto& sender : senders) {
+        for (size_t i(t); i < names.size(); i += thread_count) {
+          if (accumulator.Add(names[i], value, sender))
+            ++quorums;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  return std::make_pair(
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+      quorums.load());
+}
+
+}  // anonymous namespace
+
+TEST(ShardedAccumulatorBenchmark, FUNC_ShardedVersusGlobalLock) {
+  const size_t thread_count(std::max(2U, std::thread::hardware_concurrency()));
+  std::vector<Name> names;
+  for (size_t i(0); i < kNames; ++i)
+    names.emplace_back(GroupAddress(Address(RandomString(Address::kSize))), RandomUint32());
+  std::vector<NodeId> senders;
+  for (size_t i(0); i < GroupSize; ++i)
+    senders.emplace_back(RandomString(Address::kSize));
+  const auto random_string(RandomString(256));
+  const Value value(std::begin(random_string), std::end(random_string));
+  const auto parts(static_cast<double>(kNames * GroupSize));
+
+  GloballyLockedAccumulator global;
+  const auto global_result(RunWorkload(global, thread_count, names, senders, value));
+
+  ShardedAccumulator<Name, Value> sharded(std::chrono::minutes(20), QuorumSize);
+  const auto sharded_result(RunWorkload(sharded, thread_count, names, senders, value));
+
+  std::cout << "Accumulator, " << thread_count << " threads, " << kNames << " names, "
+            << GroupSize << " parts each\n"
+            << "  global lock: " << parts / global_result.first << " parts/s\n"
+            << "  " << sharded.ShardCount() << " shards:   " << parts / sharded_result.first
+            << " parts/s\n";
+  // The rates are only reported; both must still report every quorum exactly once.
+  EXPECT_EQ(kNames, global_result.second);
+  EXPECT_EQ(kNames, sharded_result.second);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,110 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Measures how many group messages per second SignatureVerifier can accept (a quorum of
+// QuorumSize valid signatures out of GroupSize parts) against the number of worker threads.
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/signature_verifier.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+const size_t kMessages = 200;
+
+std::vector<std::vector<SignatureVerifier::Item>> GroupMessages(
+    const std::vector<asymm::Keys>& members) {
+  std::vector<std::vector<SignatureVerifier::Item>> messages;
+  for (size_t i(0); i < kMessages; ++i) {
+    const auto body(RandomString(1024));
+    auto message(std::make_shared<const SerialisedMessage>(std::begin(body), std::end(body)));
+    std::vector<SignatureVerifier::Item> parts;
+    for (const auto& member : members) {
+      parts.push_back(SignatureVerifier::Item{
+          member.public_key, message, asymm::Sign(asymm::PlainText(body), member.private_key)});
+    }
+    messages.push_back(std::move(parts));
+  }
+  return messages;
+}
+
+}  // anonymous namespace
+
+TEST(SignatureVerificationBenchmark, FUNC_GroupMessagesPerSecond) {
+  std::vector<asymm::Keys> members;
+  for (size_t i(0); i < GroupSize; ++i)
+    members.push_back(asymm::GenerateKeyPair());
+  const auto messages(GroupMessages(members));
+
+  const uint32_t cores(std::max(1U, std::thread::hardware_concurrency()));
+  std::cout << "Verifying " << kMessages << " group messages (quorum " << QuorumSize << " of "
+            << GroupSize << ") on " << cores << " cores\n";
+  std::vector<uint32_t> thread_counts;
+  for (uint32_t threads(1); threads < cores; threads *= 2)
+    thread_counts.push_back(threads);
+  thread_counts.push_back(cores);
+
+  double single_thread_rate(0.0);
+  for (const auto threads : thread_counts) {
+    SignatureVerifier verifier(threads);
+    std::vector<std::future<bool>> results;
+    const auto start(std::chrono::steady_clock::now());
+    for (const auto& parts : messages) {
+      auto promise(std::make_shared<std::promise<bool>>());
+      results.push_back(promise->get_future());
+      verifier.VerifyQuorum(parts, QuorumSize, [promise](bool quorum_reached, std::vector<size_t>) {
+        promise->set_value(quorum_reached);
+      });
+    }
+    for (auto& result : results)
+      EXPECT_TRUE(result.get());
+    const auto seconds(
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    const auto rate(kMessages / seconds);
+    if (threads == 1)
+      single_thread_rate = rate;
+    std::cout << "  " << threads << " thread(s): " << rate << " messages/s (x"
+              << rate / single_thread_rate << "), " << verifier.VerificationsPerformed()
+              << " checks, " << verifier.VerificationsSkipped() << " skipped\n";
+  }
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -24,6 +24,7 @@
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/node_id.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/routing/timing_wheel.h"
 #include "maidsafe/routing/types.h"
 
 
@@ -66,6 +67,33 @@ TEST(RoutingTest, BEH_AccumulatorAdd) {
   EXPECT_FALSE(accumulator.HaveName(2));
 }
 
+TEST(RoutingTest, BEH_AccumulatorExpiredByTimingWheel) {
+  const auto start(std::chrono::steady_clock::now());
+  TimingWheel wheel(std::chrono::milliseconds(1), start);
+  const auto time_to_live(std::chrono::milliseconds(10));
+  const int capacity(100);
+  {
+    Accumulator<int, uint32_t> accumulator(time_to_live, 2U, capacity, &wheel);
+    for (int name(0); name < 3 * capacity; ++name)
+      EXPECT_FALSE(!!accumulator.Add(name, 3UL, Address{RandomString(Address::kSize)}));
+    // Bounded, dropping the least recently used names (and their timers)
+    EXPECT_EQ(capacity, static_cast<int>(accumulator.size()));
+    EXPECT_EQ(capacity, static_cast<int>(wheel.size()));
+    EXPECT_FALSE(accumulator.HaveName(0));
+    EXPECT_TRUE(accumulator.HaveName(3 * capacity - 1));
+
+    // Entries go when their timers fire, without waiting for another Add
+    wheel.Advance(std::chrono::steady_clock::now() + time_to_live + wheel.Tick());
+    EXPECT_EQ(0U, accumulator.size());
+    EXPECT_FALSE(accumulator.HaveName(3 * capacity - 1));
+    EXPECT_EQ(0U, wheel.size());
+
+    EXPECT_FALSE(!!accumulator.Add(1, 3UL, Address{RandomString(Address::kSize)}));
+    EXPECT_EQ(1U, wheel.size());
+  }
+  EXPECT_EQ(0U, wheel.size());
+}
+
 }  // namespace test
 
 }  // namespace routing
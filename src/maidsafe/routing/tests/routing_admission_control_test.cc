@@ -0,0 +1,205 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/admission_control.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = AdmissionControl::Clock;
+
+NodeId RandomNodeId() { return NodeId(RandomString(NodeId::kSize)); }
+
+size_t Index(AdmissionPriority priority) { return static_cast<size_t>(priority); }
+
+}  // anonymous namespace
+
+TEST(AdmissionControlTest, BEH_Prioritise) {
+  EXPECT_EQ(AdmissionPriority::get, Prioritise(MessageTypeTag::GetData));
+  EXPECT_EQ(AdmissionPriority::get, Prioritise(MessageTypeTag::GetDataBatch));
+  EXPECT_EQ(AdmissionPriority::put, Prioritise(MessageTypeTag::PutData));
+  EXPECT_EQ(AdmissionPriority::put, Prioritise(MessageTypeTag::GetDataResponse));
+  EXPECT_EQ(AdmissionPriority::control, Prioritise(MessageTypeTag::Connect));
+  EXPECT_EQ(AdmissionPriority::control, Prioritise(MessageTypeTag::GetGroupKey));
+}
+
+TEST(AdmissionControlTest, BEH_InvalidOptions) {
+  AdmissionOptions options;
+  options.peer_messages_per_second = 0.0;
+  EXPECT_THROW(AdmissionControl{options}, maidsafe_error);
+  options = AdmissionOptions();
+  options.peer_byte_burst = 0.0;
+  EXPECT_THROW(AdmissionControl{options}, maidsafe_error);
+  options = AdmissionOptions();
+  options.inflight_budget = 0;
+  EXPECT_THROW(AdmissionControl{options}, maidsafe_error);
+}
+
+TEST(AdmissionControlTest, BEH_PeerMessageAndByteRates) {
+  AdmissionOptions options;
+  options.peer_messages_per_second = 10.0;
+  options.peer_message_burst = 5.0;
+  options.peer_bytes_per_second = 1000.0;
+  options.peer_byte_burst = 1000.0;
+  AdmissionControl admission(options);
+  const auto peer(RandomNodeId()), other_peer(RandomNodeId());
+  auto now(Clock::now());
+
+  // The message burst is used up, and refills at 10 per second.
+  for (int i(0); i < 5; ++i)
+    EXPECT_TRUE(admission.Admit(peer, AdmissionPriority::put, 1, now));
+  EXPECT_FALSE(admission.Admit(peer, AdmissionPriority::put, 1, now));
+  EXPECT_TRUE(admission.Admit(other_peer, AdmissionPriority::put, 1, now));
+  now += std::chrono::milliseconds(100);
+  EXPECT_TRUE(admission.Admit(peer, AdmissionPriority::put, 1, now));
+  EXPECT_FALSE(admission.Admit(peer, AdmissionPriority::control, 1, now));
+
+  // Bytes are limited separately.
+  now += std::chrono::seconds(1);
+  EXPECT_FALSE(admission.Admit(other_peer, AdmissionPriority::put, 1001, now));
+  EXPECT_TRUE(admission.Admit(other_peer, AdmissionPriority::put, 996, now));
+  EXPECT_FALSE(admission.Admit(other_peer, AdmissionPriority::put, 10, now));
+  now += std::chrono::milliseconds(10);
+  EXPECT_TRUE(admission.Admit(other_peer, AdmissionPriority::put, 10, now));
+
+  const auto counters(admission.Counters());
+  EXPECT_EQ(9U, counters.admitted[Index(AdmissionPriority::put)]);
+  EXPECT_EQ(3U, counters.shed_by_rate[Index(AdmissionPriority::put)]);
+  EXPECT_EQ(1U, counters.shed_by_rate[Index(AdmissionPriority::control)]);
+  EXPECT_EQ(0U, counters.shed_by_budget[Index(AdmissionPriority::put)]);
+}
+
+TEST(AdmissionControlTest, BEH_ShedsLowestPriorityFirst) {
+  AdmissionOptions options;
+  options.inflight_budget = 100;
+  options.budget_shares = {{0.5, 0.8, 1.0}};
+  AdmissionControl admission(options);
+  const auto peer(RandomNodeId());
+
+  EXPECT_TRUE(admission.Admit(peer, AdmissionPriority::get, 50));
+  EXPECT_FALSE(admission.Admit(peer, AdmissionPriority::get, 1));
+  EXPECT_TRUE(admission.Admit(peer, AdmissionPriority::put, 30));
+  EXPECT_FALSE(admission.Admit(peer, AdmissionPriority::put, 1));
+  EXPECT_TRUE(admission.Admit(peer, AdmissionPriority::control, 20));
+  EXPECT_FALSE(admission.Admit(peer, AdmissionPriority::control, 1));
+  EXPECT_EQ(100U, admission.Inflight());
+
+  // Releasing work makes room again, for the highest priorities first.
+  admission.Release(30);
+  EXPECT_FALSE(admission.Admit(peer, AdmissionPriority::get, 1));
+  EXPECT_TRUE(admission.Admit(peer, AdmissionPriority::put, 10));
+  admission.Release(100);
+  EXPECT_EQ(0U, admission.Inflight());
+  EXPECT_TRUE(admission.Admit(peer, AdmissionPriority::get, 50));
+
+  const auto counters(admission.Counters());
+  EXPECT_EQ(2U, counters.shed_by_budget[Index(AdmissionPriority::get)]);
+  EXPECT_EQ(1U, counters.shed_by_budget[Index(AdmissionPriority::put)]);
+  EXPECT_EQ(1U, counters.shed_by_budget[Index(AdmissionPriority::control)]);
+  EXPECT_EQ(2U, counters.admitted[Index(AdmissionPriority::get)]);
+}
+
+TEST(AdmissionControlTest, BEH_AbusivePeer) {
+  // Ten well behaved peers each send 100 x 4 KiB messages per second of mixed traffic, while one
+  // peer floods 4 KiB GetData at 100000 per second.  Admitted work is released after 50 ms, as if
+  // handled at that latency.  Ten simulated seconds in 1 ms steps.
+  const size_t kHonestPeers(10), kSteps(10000), kSize(4096), kHonestPerStep(1);
+  const size_t kAbusivePerStep(100);
+  const auto kStep(std::chrono::milliseconds(1));
+  const size_t kReleaseAfterSteps(50);
+  AdmissionOptions options;
+  options.inflight_budget = 16 * 1024 * 1024;
+  AdmissionControl admission(options);
+
+  std::vector<NodeId> honest;
+  for (size_t i(0); i < kHonestPeers; ++i)
+    honest.push_back(RandomNodeId());
+  const auto abusive(RandomNodeId());
+  std::vector<uint64_t> admitted_at(kSteps, 0);
+  uint64_t honest_sent(0), honest_admitted(0), abusive_sent(0), abusive_admitted(0);
+  const AdmissionPriority priorities[] = {AdmissionPriority::get, AdmissionPriority::put,
+                                          AdmissionPriority::control};
+  auto now(Clock::now());
+  for (size_t step(0); step < kSteps; ++step, now += kStep) {
+    if (step >= kReleaseAfterSteps)
+      admission.Release(admitted_at[step - kReleaseAfterSteps]);
+    for (size_t i(0); i < kHonestPeers; ++i) {
+      for (size_t j(0); j < kHonestPerStep; ++j, ++honest_sent) {
+        if (admission.Admit(honest[i], priorities[(step + i) % 3], kSize, now)) {
+          ++honest_admitted;
+          admitted_at[step] += kSize;
+        }
+      }
+    }
+    for (size_t j(0); j < kAbusivePerStep; ++j, ++abusive_sent) {
+      if (admission.Admit(abusive, AdmissionPriority::get, kSize, now)) {
+        ++abusive_admitted;
+        admitted_at[step] += kSize;
+      }
+    }
+  }
+
+  const auto counters(admission.Counters());
+  const double seconds(kSteps / 1000.0);
+  std::cout << "Abusive peer: sent " << abusive_sent / seconds << " msg/s, admitted "
+            << abusive_admitted / seconds << " msg/s\n"
+            << "Honest peers: sent " << honest_sent << ", admitted " << honest_admitted << "\n"
+            << "Shed by rate (get/put/control):   "
+            << counters.shed_by_rate[Index(AdmissionPriority::get)] << "/"
+            << counters.shed_by_rate[Index(AdmissionPriority::put)] << "/"
+            << counters.shed_by_rate[Index(AdmissionPriority::control)] << "\n"
+            << "Shed by budget (get/put/control): "
+            << counters.shed_by_budget[Index(AdmissionPriority::get)] << "/"
+            << counters.shed_by_budget[Index(AdmissionPriority::put)] << "/"
+            << counters.shed_by_budget[Index(AdmissionPriority::control)] << "\n";
+
+  // The abuser gets no more than the tighter of its two buckets allows.
+  const double abusive_limit(std::min(
+      options.peer_message_burst + options.peer_messages_per_second * seconds,
+      (options.peer_byte_burst + options.peer_bytes_per_second * seconds) / kSize));
+  EXPECT_LE(static_cast<double>(abusive_admitted), abusive_limit + 1);
+  EXPECT_GT(counters.shed_by_rate[Index(AdmissionPriority::get)], abusive_sent / 2);
+  // Whatever budget pressure the abuser causes falls on GetData, never on honest Puts or control.
+  EXPECT_EQ(0U, counters.shed_by_budget[Index(AdmissionPriority::put)]);
+  EXPECT_EQ(0U, counters.shed_by_budget[Index(AdmissionPriority::control)]);
+  EXPECT_EQ(0U, counters.shed_by_rate[Index(AdmissionPriority::put)]);
+  EXPECT_EQ(0U, counters.shed_by_rate[Index(AdmissionPriority::control)]);
+  EXPECT_LE(admission.Inflight(), options.inflight_budget);
+  EXPECT_GE(honest_admitted * 3, honest_sent * 2);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
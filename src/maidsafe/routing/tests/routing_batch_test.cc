@@ -0,0 +1,156 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/batch.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+struct Entry {
+  Identity name;
+};
+
+Address HopFor(const Address& name) {
+  // Three next hops, chosen by the name's first byte.
+  return Address(std::string(Address::kSize, static_cast<char>(name.string()[0] % 3)));
+}
+
+}  // anonymous namespace
+
+TEST(BatchTest, BEH_PlanGroupsByNextHopAndSplits) {
+  const size_t kEntries(1000), kMaxEntries(100);
+  std::vector<Entry> entries;
+  for (size_t i(0); i < kEntries; ++i)
+    entries.push_back(Entry{Identity(RandomString(Address::kSize))});
+  // Names starting with 0 are for our close group, and those starting with 1 have no route.
+  const auto plan(PlanBatch(
+      entries, [](const Address& name) { return name.string()[0] == 0; },
+      [](const Address& name) -> boost::optional<Address> {
+        if (name.string()[0] == 1)
+          return boost::none;
+        return HopFor(name);
+      },
+      kMaxEntries));
+
+  std::vector<int> seen(kEntries, 0);
+  for (const auto index : plan.local) {
+    EXPECT_EQ(0, entries[index].name.string()[0]);
+    ++seen[index];
+  }
+  for (const auto index : plan.unroutable) {
+    EXPECT_EQ(1, entries[index].name.string()[0]);
+    ++seen[index];
+  }
+  std::map<Address, size_t> per_hop;
+  for (const auto& part : plan.remote) {
+    EXPECT_FALSE(part.second.empty());
+    EXPECT_LE(part.second.size(), kMaxEntries);
+    per_hop[part.first] += part.second.size();
+    for (const auto index : part.second) {
+      EXPECT_EQ(part.first, HopFor(Address(entries[index].name.string())));
+      ++seen[index];
+    }
+  }
+  // Every entry is planned exactly once, with at most one partly filled batch per next hop.
+  EXPECT_TRUE(std::all_of(std::begin(seen), std::end(seen), [](int count) { return count == 1; }));
+  size_t batches(0);
+  for (const auto& hop : per_hop)
+    batches += (hop.second + kMaxEntries - 1) / kMaxEntries;
+  EXPECT_EQ(batches, plan.remote.size());
+}
+
+TEST(BatchTest, BEH_CollectorCompletesOnceAllPartsDone) {
+  const size_t kParts(8), kEntriesPerPart(50);
+  std::vector<Identity> names;
+  for (size_t i(0); i < kParts * kEntriesPerPart; ++i)
+    names.push_back(Identity(RandomString(Address::kSize)));
+  std::vector<BatchResult> results;
+  int calls(0);
+  BatchCollector collector(names, [&](std::vector<BatchResult> collected) {
+    results = std::move(collected);
+    ++calls;
+  });
+
+  std::vector<std::thread> threads;
+  for (size_t part(0); part < kParts; ++part) {
+    collector.AddPart();
+    threads.emplace_back([&, part] {
+      std::vector<size_t> indices;
+      for (size_t i(part * kEntriesPerPart); i < (part + 1) * kEntriesPerPart; ++i) {
+        if (part % 2 == 0)
+          collector.Set(i, asio::error_code(), SerialisedMessage(1, static_cast<byte>(i)));
+        else
+          indices.push_back(i);
+      }
+      collector.SetAll(indices, asio::error::timed_out);
+      collector.PartDone();
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(0, calls);
+  collector.PartDone();
+  ASSERT_EQ(1, calls);
+  collector.PartDone();
+  EXPECT_EQ(1, calls);
+
+  ASSERT_EQ(names.size(), results.size());
+  for (size_t i(0); i < results.size(); ++i) {
+    EXPECT_EQ(names[i], results[i].name);
+    if ((i / kEntriesPerPart) % 2 == 0) {
+      EXPECT_FALSE(results[i].error);
+      EXPECT_EQ(SerialisedMessage(1, static_cast<byte>(i)), results[i].data);
+    } else {
+      EXPECT_EQ(asio::error::timed_out, results[i].error);
+    }
+  }
+}
+
+TEST(BatchTest, BEH_CollectorFailsEntriesNeverSet) {
+  std::vector<Identity> names(2, Identity(RandomString(Address::kSize)));
+  std::vector<BatchResult> results;
+  BatchCollector collector(
+      names, [&](std::vector<BatchResult> collected) { results = std::move(collected); });
+  collector.Set(0, asio::error_code());
+  collector.PartDone();
+  ASSERT_EQ(2U, results.size());
+  EXPECT_FALSE(results[0].error);
+  EXPECT_EQ(make_error_code(CommonErrors::unable_to_handle_request), results[1].error);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,418 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/client_connection_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asio/error.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Message = ClientConnectionPool::Message;
+
+Address RandomAddress() { return Address(RandomString(Address::kSize)); }
+
+// A request names the connection it was built for, followed by its message id.
+ClientConnectionPool::Builder Build(MessageId message_id) {
+  return [message_id](const Address& connection) {
+    const auto raw(connection.string());
+    auto message(std::make_shared<SerialisedMessage>(std::begin(raw), std::end(raw)));
+    for (int i(0); i < 4; ++i)
+      message->push_back(static_cast<byte>(message_id >> (8 * i)));
+    return Message(message);
+  };
+}
+
+Address DecodeConnection(const SerialisedMessage& message) {
+  return Address(std::string(std::begin(message), std::begin(message) + Address::kSize));
+}
+
+MessageId DecodeMessageId(const SerialisedMessage& message) {
+  MessageId message_id(0);
+  for (int i(0); i < 4; ++i)
+    message_id |= static_cast<MessageId>(message[Address::kSize + i]) << (8 * i);
+  return message_id;
+}
+
+// Records the messages sent on a connection, completing each send with |error|.
+struct Recorder {
+  explicit Recorder(asio::error_code error_in = asio::error_code()) : error(error_in), sent() {}
+  ClientConnectionPool::Sender Sender() {
+    return [this](Message message, std::function<void(asio::error_code)> on_sent) {
+      sent.push_back(*message);
+      on_sent(error);
+    };
+  }
+  asio::error_code error;
+  std::vector<SerialisedMessage> sent;
+};
+
+struct Outcome {
+  Outcome() : calls(0), error(), response() {}
+  int calls;
+  asio::error_code error;
+  SerialisedMessage response;
+};
+
+ClientConnectionPool::Handler Record(Outcome& outcome) {
+  return [&outcome](asio::error_code error, SerialisedMessage response) {
+    outcome.error = error;
+    outcome.response = std::move(response);
+    ++outcome.calls;
+  };
+}
+
+// A close group node at the far end of a connection whose link carries one message per
+// |service_time|.  Each request is answered, in order, once its turn on the link has passed.
+// Stopping it loses whatever is still queued, as losing the connection would.
+class SimulatedNode {
+ public:
+  SimulatedNode(ClientConnectionPool& pool, Clock::duration service_time)
+      : pool_(pool),
+        service_time_(service_time),
+        mutex_(),
+        condition_(),
+        queue_(),
+        stopped_(false),
+        received_(0),
+        answered_(0),
+        thread_([this] { Run(); }) {}
+  ~SimulatedNode() {
+    Stop();
+    Join();
+  }
+
+  ClientConnectionPool::Sender Sender() {
+    return [this](Message message, std::function<void(asio::error_code)> on_sent) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_)
+          return on_sent(asio::error::connection_reset);
+        queue_.push_back(std::move(message));
+        ++received_;
+      }
+      condition_.notify_one();
+      on_sent(asio::error_code());
+    };
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+      queue_.clear();
+    }
+    condition_.notify_one();
+  }
+
+  void Join() {
+    if (thread_.joinable())
+      thread_.join();
+  }
+
+  // Once joined, the number of requests sent over the link, and the number this node has answered.
+  size_t Received() const { return received_; }
+  size_t Answered() const { return answered_; }
+
+ private:
+  void Run() {
+    auto link_free(Clock::now());
+    for (;;) {
+      Message message;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+        if (stopped_)
+          return;
+        message = queue_.front();
+        queue_.pop_front();
+      }
+      link_free = std::max(link_free, Clock::now()) + service_time_;
+      std::this_thread::sleep_until(link_free);
+      if (pool_.Complete(DecodeMessageId(*message), asio::error_code(), SerialisedMessage(64, 1)))
+        ++answered_;
+    }
+  }
+
+  ClientConnectionPool& pool_;
+  const Clock::duration service_time_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<Message> queue_;
+  bool stopped_;
+  std::atomic<size_t> received_, answered_;
+  std::thread thread_;
+};
+
+struct ThroughputResult {
+  size_t succeeded;
+  uint64_t failed_over;
+  Clock::duration elapsed;
+  // Per connection, in the order added.
+  std::vector<size_t> received, answered;
+};
+
+// Starts |count| Gets at once over |connections| simulated nodes and waits for them all.  If
+// |lose_one| is set, the first connection is lost once a quarter of the Gets have completed.
+ThroughputResult MeasureGets(size_t count, size_t connections, bool lose_one) {
+  TimingWheel wheel;
+  ClientConnectionPool pool(wheel, RandomAddress(), connections);
+  std::vector<Address> addresses;
+  std::vector<std::unique_ptr<SimulatedNode>> nodes;
+  for (size_t i(0); i < connections; ++i) {
+    addresses.push_back(RandomAddress());
+    nodes.emplace_back(new SimulatedNode(pool, std::chrono::microseconds(50)));
+    EXPECT_TRUE(pool.Add(addresses.back(), nodes.back()->Sender()));
+  }
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t completed(0);
+  std::atomic<size_t> succeeded(0);
+  const auto start(Clock::now());
+  for (size_t i(0); i < count; ++i) {
+    pool.Send(static_cast<MessageId>(i), Build(static_cast<MessageId>(i)),
+              [&](asio::error_code error, SerialisedMessage) {
+                if (!error)
+                  ++succeeded;
+                {
+                  std::lock_guard<std::mutex> lock(mutex);
+                  ++completed;
+                }
+                condition.notify_all();
+              },
+              std::chrono::minutes(1));
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  if (lose_one) {
+    condition.wait(lock, [&] { return completed >= count / 4; });
+    lock.unlock();
+    nodes.front()->Stop();
+    pool.Remove(addresses.front());
+    lock.lock();
+  }
+  condition.wait(lock, [&] { return completed == count; });
+  lock.unlock();
+  ThroughputResult result{succeeded, pool.FailedOver(), Clock::now() - start,
+                          std::vector<size_t>(), std::vector<size_t>()};
+  for (const auto& node : nodes) {
+    node->Stop();
+    node->Join();
+    result.received.push_back(node->Received());
+    result.answered.push_back(node->Answered());
+  }
+  return result;
+}
+
+double PerSecond(size_t count, Clock::duration elapsed) {
+  return count / std::chrono::duration<double>(elapsed).count();
+}
+
+std::ostream& operator<<(std::ostream& stream, const std::vector<size_t>& counts) {
+  for (size_t i(0); i < counts.size(); ++i)
+    stream << (i == 0 ? "" : " ") << counts[i];
+  return stream;
+}
+
+}  // anonymous namespace
+
+TEST(ClientConnectionPoolTest, BEH_InvalidParameters) {
+  TimingWheel wheel;
+  EXPECT_THROW(ClientConnectionPool(wheel, RandomAddress(), 0), maidsafe_error);
+
+  ClientConnectionPool pool(wheel, RandomAddress(), 2);
+  Recorder recorder;
+  const auto node(RandomAddress());
+  EXPECT_TRUE(pool.Add(node, recorder.Sender()));
+  EXPECT_FALSE(pool.Add(node, recorder.Sender()));
+  EXPECT_TRUE(pool.Add(RandomAddress(), recorder.Sender()));
+  EXPECT_FALSE(pool.Add(RandomAddress(), recorder.Sender()));
+  EXPECT_EQ(2U, pool.Connections().size());
+  EXPECT_FALSE(pool.Remove(RandomAddress()));
+
+  // A message id already outstanding is refused.
+  Outcome first, duplicate;
+  pool.Send(1, Build(1), Record(first));
+  pool.Send(1, Build(1), Record(duplicate));
+  EXPECT_EQ(0, first.calls);
+  EXPECT_EQ(1, duplicate.calls);
+  EXPECT_EQ(asio::error::already_started, duplicate.error);
+  EXPECT_EQ(1U, pool.Outstanding());
+}
+
+TEST(ClientConnectionPoolTest, BEH_SendsOnLeastLoadedConnection) {
+  TimingWheel wheel;
+  ClientConnectionPool pool(wheel, RandomAddress());
+  std::vector<Recorder> recorders(3);
+  std::vector<Address> nodes;
+  for (auto& recorder : recorders) {
+    nodes.push_back(RandomAddress());
+    EXPECT_TRUE(pool.Add(nodes.back(), recorder.Sender()));
+  }
+
+  std::vector<Outcome> outcomes(8);
+  for (MessageId i(0); i < 6; ++i)
+    pool.Send(i, Build(i), Record(outcomes[i]));
+  for (size_t i(0); i < nodes.size(); ++i) {
+    EXPECT_EQ(2U, pool.Outstanding(nodes[i]));
+    ASSERT_EQ(2U, recorders[i].sent.size());
+    // Each request is built for the connection which relays it.
+    for (const auto& message : recorders[i].sent)
+      EXPECT_EQ(nodes[i], DecodeConnection(message));
+  }
+
+  // Answering both requests on the second connection makes it the least loaded.
+  for (const auto& message : recorders[1].sent)
+    EXPECT_TRUE(pool.Complete(DecodeMessageId(message), asio::error_code(), SerialisedMessage()));
+  EXPECT_EQ(0U, pool.Outstanding(nodes[1]));
+  pool.Send(6, Build(6), Record(outcomes[6]));
+  pool.Send(7, Build(7), Record(outcomes[7]));
+  EXPECT_EQ(4U, recorders[1].sent.size());
+  EXPECT_EQ(2U, pool.Outstanding(nodes[1]));
+
+  const SerialisedMessage response{1, 2, 3};
+  EXPECT_TRUE(pool.Complete(6, asio::error_code(), response));
+  EXPECT_FALSE(pool.Complete(6, asio::error_code(), response));
+  EXPECT_EQ(1, outcomes[6].calls);
+  EXPECT_FALSE(outcomes[6].error);
+  EXPECT_EQ(response, outcomes[6].response);
+  EXPECT_EQ(5U, pool.Outstanding());
+}
+
+TEST(ClientConnectionPoolTest, BEH_FailsOverOnLoss) {
+  const auto start(TimingWheel::Clock::now());
+  TimingWheel wheel(std::chrono::milliseconds(100), start);
+  ClientConnectionPool pool(wheel, RandomAddress());
+  Recorder lost, failing(asio::error::connection_reset), remaining;
+  const auto lost_node(RandomAddress()), failing_node(RandomAddress()),
+      remaining_node(RandomAddress());
+  EXPECT_TRUE(pool.Add(lost_node, lost.Sender()));
+  EXPECT_TRUE(pool.Add(remaining_node, remaining.Sender()));
+
+  std::vector<Outcome> outcomes(6);
+  for (MessageId i(0); i < 4; ++i)
+    pool.Send(i, Build(i), Record(outcomes[i]));
+  EXPECT_EQ(2U, lost.sent.size());
+  EXPECT_EQ(2U, remaining.sent.size());
+
+  // The requests outstanding on the lost connection are rebuilt for and sent on the other.
+  EXPECT_TRUE(pool.Remove(lost_node));
+  EXPECT_EQ(2U, pool.FailedOver());
+  ASSERT_EQ(4U, remaining.sent.size());
+  EXPECT_EQ(remaining_node, DecodeConnection(remaining.sent[2]));
+  EXPECT_EQ(std::set<MessageId>({DecodeMessageId(lost.sent[0]), DecodeMessageId(lost.sent[1])}),
+            std::set<MessageId>({DecodeMessageId(remaining.sent[2]),
+                                 DecodeMessageId(remaining.sent[3])}));
+  EXPECT_EQ(4U, pool.Outstanding(remaining_node));
+
+  // A failed send drops its connection, and the request goes out on the next least loaded.
+  EXPECT_TRUE(pool.Add(failing_node, failing.Sender()));
+  pool.Send(4, Build(4), Record(outcomes[4]));
+  EXPECT_EQ(1U, failing.sent.size());
+  EXPECT_EQ(1U, pool.Connections().size());
+  ASSERT_EQ(5U, remaining.sent.size());
+  EXPECT_EQ(4U, DecodeMessageId(remaining.sent[4]));
+
+  for (MessageId i(0); i < 2; ++i)
+    EXPECT_TRUE(pool.Complete(i, asio::error_code(), SerialisedMessage()));
+  wheel.Advance(start + 2 * ResponseTable::kDefaultTimeout);
+  for (MessageId i(0); i < 5; ++i) {
+    EXPECT_EQ(1, outcomes[i].calls) << i;
+    EXPECT_EQ(i < 2 ? asio::error_code() : asio::error::timed_out, outcomes[i].error) << i;
+  }
+  EXPECT_EQ(0U, pool.Outstanding(remaining_node));
+
+  // Once the last connection is lost its requests fail, as do any sent after.
+  pool.Send(5, Build(5), Record(outcomes[5]));
+  Outcome unconnected;
+  EXPECT_TRUE(pool.Remove(remaining_node));
+  pool.Send(6, Build(6), Record(unconnected));
+  EXPECT_EQ(1, outcomes[5].calls);
+  EXPECT_EQ(asio::error::network_unreachable, outcomes[5].error);
+  EXPECT_EQ(1, unconnected.calls);
+  EXPECT_EQ(asio::error::network_unreachable, unconnected.error);
+  EXPECT_EQ(0U, pool.Outstanding());
+}
+
+TEST(ClientConnectionPoolTest, FUNC_ConcurrentGetThroughput) {
+  // Measures the pool alone over simulated links, each carrying at most 20000 messages/s; it says
+  // nothing about Client, which has no connections until it can bootstrap.
+  const size_t kGets(10000), kConnections(4);
+  const auto single(MeasureGets(kGets, 1, false));
+  const auto pooled(MeasureGets(kGets, kConnections, false));
+  const auto failed_over(MeasureGets(kGets, kConnections, true));
+
+  std::cout << kGets << " concurrent Gets over simulated links\n"
+            << "  1 connection:  " << PerSecond(kGets, single.elapsed) << " Gets/s\n"
+            << "  " << kConnections << " connections: " << PerSecond(kGets, pooled.elapsed)
+            << " Gets/s, answered per connection: " << pooled.answered << "\n"
+            << "  " << kConnections << " connections, one lost: "
+            << PerSecond(kGets, failed_over.elapsed) << " Gets/s (" << failed_over.failed_over
+            << " requests failed over), answered per connection: " << failed_over.answered
+            << "\n";
+
+  // Rates depend on the machine, so only where the requests went is checked.
+  EXPECT_EQ(kGets, single.succeeded);
+  EXPECT_EQ(kGets, single.answered.front());
+  EXPECT_EQ(kGets, pooled.succeeded);
+  EXPECT_EQ(0U, pooled.failed_over);
+  // Sending on the least loaded connection spreads the Gets over every link.
+  for (size_t i(0); i < kConnections; ++i) {
+    EXPECT_EQ(pooled.received[i], pooled.answered[i]) << i;
+    EXPECT_GT(pooled.answered[i], kGets / (2 * kConnections)) << i;
+  }
+
+  // Whatever the lost connection hadn't answered is answered by the others.
+  EXPECT_EQ(kGets, failed_over.succeeded);
+  EXPECT_GT(failed_over.failed_over, 0U);
+  EXPECT_LT(failed_over.answered.front(), failed_over.received.front());
+  size_t answered_by_others(0);
+  for (size_t i(1); i < kConnections; ++i) {
+    EXPECT_GT(failed_over.answered[i], failed_over.answered.front()) << i;
+    answered_by_others += failed_over.answered[i];
+  }
+  EXPECT_EQ(kGets - failed_over.answered.front(), answered_by_others);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
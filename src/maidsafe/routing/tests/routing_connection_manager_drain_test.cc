@@ -0,0 +1,190 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "asio/ip/udp.hpp"
+#include "boost/asio/io_service.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/routing/connection_manager.h"
+#include "maidsafe/routing/endpoint_pair.h"
+#include "maidsafe/routing/outbound_message.h"
+#include "maidsafe/routing/peer_node.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t kNodes(4), kMessagesPerPeer(200), kMessageSize(64 * 1024);
+
+// Runs |functor| on |io_service|'s thread and waits for its result.
+template <typename Functor>
+auto RunOn(boost::asio::io_service& io_service, Functor functor) -> decltype(functor()) {
+  std::packaged_task<decltype(functor())()> task(functor);
+  auto result(task.get_future());
+  io_service.post([&task] { task(); });
+  return result.get();
+}
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate, Clock::duration timeout) {
+  const auto deadline(Clock::now() + timeout);
+  while (!predicate()) {
+    if (Clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+// Nodes on the loopback interface, all driven by one io_service thread (as ConnectionManager
+// expects).  Node 0, the one restarted, connects to all the others.
+class LocalNetwork {
+ public:
+  LocalNetwork()
+      : io_service_(),
+        work_(new boost::asio::io_service::work(io_service_)),
+        nodes_(),
+        received_(0),
+        thread_([this] { io_service_.run(); }) {
+    const auto first_port(static_cast<unsigned short>(40000 + RandomUint32() % 20000));
+    for (size_t i(0); i < kNodes; ++i) {
+      nodes_.emplace_back(new ConnectionManager(
+          io_service_, passport::PublicPmid(passport::CreatePmidAndSigner().first)));
+    }
+    RunOn(io_service_, [&] {
+      for (size_t i(1); i < kNodes; ++i) {
+        nodes_[i]->SetOnReceive([this](NodeId, const SerialisedMessage&) { ++received_; });
+        nodes_[i]->StartAccepting(static_cast<unsigned short>(first_port + i));
+      }
+      for (size_t i(1); i < kNodes; ++i) {
+        nodes_[0]->AddNode(boost::none,
+                           EndpointPair(asio::ip::udp::endpoint(
+                               asio::ip::address_v4::loopback(),
+                               static_cast<unsigned short>(first_port + i))));
+      }
+    });
+  }
+
+  ~LocalNetwork() {
+    work_.reset();
+    io_service_.stop();
+    thread_.join();
+  }
+
+  bool Connected() {
+    return RunOn(io_service_, [this] {
+      if (nodes_[0]->Size() != kNodes - 1)
+        return false;
+      for (size_t i(1); i < kNodes; ++i) {
+        if (nodes_[i]->Size() != 1)
+          return false;
+      }
+      return true;
+    });
+  }
+
+  // Starts |kMessagesPerPeer| sends from node 0 to each other node, then at once calls |stop| on
+  // node 0.  Returns the number of sends started.
+  template <typename Stop>
+  size_t SendThenStop(Stop stop) {
+    return RunOn(io_service_, [&] {
+      size_t sent(0);
+      for (size_t i(1); i < kNodes; ++i) {
+        PeerNode* peer(nodes_[0]->FindPeer(nodes_[i]->OurId()));
+        if (!peer)
+          continue;
+        for (size_t j(0); j < kMessagesPerPeer; ++j, ++sent) {
+          OutboundMessage(SerialisedMessage(kMessageSize, static_cast<byte>(j)))
+              .Send(*peer, [](asio::error_code) {});
+        }
+      }
+      stop(*nodes_[0]);
+      return sent;
+    });
+  }
+
+  size_t Received() const { return received_; }
+
+ private:
+  boost::asio::io_service io_service_;
+  std::unique_ptr<boost::asio::io_service::work> work_;
+  std::vector<std::unique_ptr<ConnectionManager>> nodes_;
+  std::atomic<size_t> received_;
+  std::thread thread_;
+};
+
+}  // anonymous namespace
+
+TEST(ConnectionManagerTest, FUNC_DrainOnRestart) {
+  size_t shutdown_sent(0), shutdown_dropped(0);
+  {
+    LocalNetwork network;
+    ASSERT_TRUE(WaitFor([&] { return network.Connected(); }, std::chrono::seconds(10)));
+    shutdown_sent = network.SendThenStop([](ConnectionManager& node) { node.Shutdown(); });
+    WaitFor([&] { return network.Received() == shutdown_sent; }, std::chrono::seconds(5));
+    shutdown_dropped = shutdown_sent - network.Received();
+  }
+
+  size_t drain_sent(0), drain_dropped(0), unsent(0);
+  {
+    LocalNetwork network;
+    ASSERT_TRUE(WaitFor([&] { return network.Connected(); }, std::chrono::seconds(10)));
+    std::promise<size_t> drained;
+    drain_sent = network.SendThenStop([&](ConnectionManager& node) {
+      node.Drain(std::chrono::seconds(10), [&](size_t left) { drained.set_value(left); });
+    });
+    unsent = drained.get_future().get();
+    WaitFor([&] { return network.Received() == drain_sent; }, std::chrono::seconds(5));
+    drain_dropped = drain_sent - network.Received();
+  }
+
+  std::cout << "Restart of a node with " << kNodes - 1 << " peers, " << kMessagesPerPeer << " x "
+            << kMessageSize / 1024 << " KiB sends in flight to each:\n"
+            << "  shut down: " << shutdown_dropped << " of " << shutdown_sent << " dropped\n"
+            << "  drained:   " << drain_dropped << " of " << drain_sent << " dropped ("
+            << unsent << " sends unfinished at the deadline)\n";
+  EXPECT_EQ(0U, unsent);
+  EXPECT_EQ(0U, drain_dropped);
+  EXPECT_LE(drain_dropped, shutdown_dropped);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,190 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/coroutine.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "asio/async_result.hpp"
+#include "asio/io_service.hpp"
+#include "asio/post.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/routing/types.h"
+
+#include "asio/yield.hpp"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+SerialisedMessage Data(uint32_t name) {
+  return SerialisedMessage{static_cast<byte>(name >> 24), static_cast<byte>(name >> 16),
+                           static_cast<byte>(name >> 8), static_cast<byte>(name)};
+}
+
+// Stand-ins for RoutingNode::Get and Put, completing from |io_service| as a request does when its
+// response arrives.
+template <typename CompletionToken>
+GetReturn<CompletionToken> AsyncGet(asio::io_service& io_service, uint32_t name,
+                                    CompletionToken&& token) {
+  GetHandler<CompletionToken> handler(std::forward<CompletionToken>(token));
+  asio::async_result<decltype(handler)> result(handler);
+  asio::post(io_service, [handler, name]() mutable { handler(asio::error_code(), Data(name)); });
+  return result.get();
+}
+
+template <typename CompletionToken>
+PutReturn<CompletionToken> AsyncPut(asio::io_service& io_service, asio::error_code outcome,
+                                    CompletionToken&& token) {
+  PutHandler<CompletionToken> handler(std::forward<CompletionToken>(token));
+  asio::async_result<decltype(handler)> result(handler);
+  asio::post(io_service, [handler, outcome]() mutable { handler(outcome); });
+  return result.get();
+}
+
+// Completes before returning, as an operation failing immediately does.
+template <typename CompletionToken>
+PutReturn<CompletionToken> FailNow(CompletionToken&& token) {
+  PutHandler<CompletionToken> handler(std::forward<CompletionToken>(token));
+  asio::async_result<decltype(handler)> result(handler);
+  handler(make_error_code(CommonErrors::unknown));
+  return result.get();
+}
+
+struct GetThenPutTwice {
+  template <typename Coroutine>
+  void operator()(Coroutine& coroutine) {
+    reenter(coroutine) {
+      yield AsyncGet(*io_service, 7, coroutine.Await(get_error, data));
+      ++resumes;
+      yield {
+        AsyncPut(*io_service, asio::error_code(), coroutine.Await(put_errors[0]));
+        AsyncPut(*io_service, make_error_code(CommonErrors::unknown),
+                 coroutine.Await(put_errors[1]));
+        FailNow(coroutine.Await(put_errors[2]));
+      }
+      ++resumes;
+      yield FailNow(coroutine.Await(put_errors[3]));
+      ++resumes;
+    }
+  }
+
+  asio::io_service* io_service;
+  asio::error_code get_error, put_errors[4];
+  SerialisedMessage data;
+  int resumes;
+};
+
+struct SequentialGets {
+  template <typename Coroutine>
+  void operator()(Coroutine& coroutine) {
+    // Fails if the body is ever resumed while already running.
+    EXPECT_EQ(0, running->fetch_add(1));
+    reenter(coroutine) {
+      for (name = 0; name != kGets; ++name) {
+        yield AsyncGet(*io_service, name, coroutine.Await(error, data));
+        if (error || data != Data(name))
+          ++*failures;
+      }
+      ++*done;
+    }
+    --*running;
+  }
+
+  static const uint32_t kGets = 20;
+  asio::io_service* io_service;
+  std::shared_ptr<std::atomic<int>> running;
+  std::atomic<int>* failures;
+  std::atomic<int>* done;
+  uint32_t name;
+  asio::error_code error;
+  SerialisedMessage data;
+};
+
+}  // anonymous namespace
+
+TEST(CoroutineTest, BEH_ResumesOnceAllAwaitedOperationsComplete) {
+  asio::io_service io_service;
+  GetThenPutTwice body = GetThenPutTwice();
+  body.io_service = &io_service;
+  const auto coroutine(SpawnCoroutine(body));
+  // Nothing completes until the io_service runs.
+  EXPECT_FALSE(coroutine->is_complete());
+  EXPECT_EQ(0, coroutine->body().resumes);
+
+  io_service.run();
+  ASSERT_TRUE(coroutine->is_complete());
+  const auto& result(coroutine->body());
+  EXPECT_EQ(3, result.resumes);
+  EXPECT_FALSE(result.get_error);
+  EXPECT_EQ(Data(7), result.data);
+  EXPECT_FALSE(result.put_errors[0]);
+  EXPECT_EQ(make_error_code(CommonErrors::unknown), result.put_errors[1]);
+  // Completing before the yield resumes the coroutine after it rather than from within it.
+  EXPECT_EQ(make_error_code(CommonErrors::unknown), result.put_errors[2]);
+  EXPECT_EQ(make_error_code(CommonErrors::unknown), result.put_errors[3]);
+  // Only the caller's reference remains once nothing is outstanding.
+  EXPECT_EQ(1, coroutine.use_count());
+}
+
+TEST(CoroutineTest, FUNC_ManyConcurrentCoroutines) {
+  const int kCoroutines(1000);
+  asio::io_service io_service;
+  std::unique_ptr<asio::io_service::work> work(new asio::io_service::work(io_service));
+  std::vector<std::thread> threads;
+  for (int i(0); i != 4; ++i)
+    threads.emplace_back([&] { io_service.run(); });
+
+  std::atomic<int> failures(0), done(0);
+  for (int i(0); i != kCoroutines; ++i) {
+    SequentialGets body = SequentialGets();
+    body.io_service = &io_service;
+    body.running = std::make_shared<std::atomic<int>>(0);
+    body.failures = &failures;
+    body.done = &done;
+    SpawnCoroutine(body);
+  }
+  const auto deadline(std::chrono::steady_clock::now() + std::chrono::seconds(30));
+  while (done < kCoroutines && std::chrono::steady_clock::now() < deadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  work.reset();
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(kCoroutines, done);
+  EXPECT_EQ(0, failures);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#include "asio/unyield.hpp"
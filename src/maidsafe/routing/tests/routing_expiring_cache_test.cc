@@ -0,0 +1,158 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/expiring_cache.h"
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/timing_wheel.h"
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = TimingWheel::Clock;
+
+const Clock::duration kTimeToLive(std::chrono::minutes(1));
+
+}  // anonymous namespace
+
+TEST(ExpiringCacheTest, BEH_ExpiredByWheel) {
+  TimingWheel wheel;
+  ExpiringCache<Address, std::string> cache(wheel, kTimeToLive, 100);
+  const Address key(RandomString(Address::kSize));
+  cache.Add(key, "value");
+  ASSERT_TRUE(cache.Check(key));
+  EXPECT_EQ("value", *cache.Get(key));
+  EXPECT_EQ(1U, wheel.size());
+
+  wheel.Advance(Clock::now() + kTimeToLive / 2);
+  EXPECT_TRUE(cache.Check(key));
+  wheel.Advance(Clock::now() + kTimeToLive + wheel.Tick());
+  EXPECT_FALSE(cache.Check(key));
+  EXPECT_FALSE(cache.Get(key));
+  EXPECT_EQ(0U, cache.size());
+  EXPECT_EQ(1U, cache.Expired());
+  EXPECT_EQ(0U, wheel.size());
+}
+
+TEST(ExpiringCacheTest, BEH_ReAddRestartsTimeToLive) {
+  const auto start(Clock::now());
+  TimingWheel wheel(TimingWheel::kDefaultTick, start);
+  ExpiringCache<Address, std::string> cache(wheel, kTimeToLive, 100);
+  const Address key(RandomString(Address::kSize));
+  cache.Add(key, "first");
+  cache.Add(key, "second");
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_EQ(1U, wheel.size());
+  EXPECT_EQ("second", *cache.Get(key));
+}
+
+TEST(ExpiringCacheTest, BEH_BoundedByCapacity) {
+  TimingWheel wheel;
+  const size_t kCapacity(10);
+  ExpiringCache<std::pair<Address, MessageId>> filter(wheel, kTimeToLive, kCapacity);
+  const Address sender(RandomString(Address::kSize));
+  for (MessageId id(0); id < 3 * kCapacity; ++id)
+    filter.Add(std::make_pair(sender, id));
+  EXPECT_EQ(kCapacity, filter.size());
+  EXPECT_EQ(2 * kCapacity, filter.Evicted());
+  // Evicted entries' timers are cancelled too.
+  EXPECT_EQ(kCapacity, wheel.size());
+  EXPECT_FALSE(filter.Check(std::make_pair(sender, MessageId(0))));
+  EXPECT_TRUE(filter.Check(std::make_pair(sender, MessageId(3 * kCapacity - 1))));
+}
+
+TEST(ExpiringCacheTest, BEH_LeastRecentlyUsedEvicted) {
+  TimingWheel wheel;
+  ExpiringCache<Address, std::string> cache(wheel, kTimeToLive, 2);
+  const Address first(RandomString(Address::kSize)), second(RandomString(Address::kSize)),
+      third(RandomString(Address::kSize));
+  cache.Add(first, "1");
+  cache.Add(second, "2");
+  EXPECT_TRUE(!!cache.Get(first));
+  cache.Add(third, "3");
+  EXPECT_TRUE(cache.Check(first));
+  EXPECT_FALSE(cache.Check(second));
+  EXPECT_TRUE(cache.Check(third));
+}
+
+TEST(ExpiringCacheTest, BEH_BoundedByCost) {
+  TimingWheel wheel;
+  const uint64_t kMaxBytes(100);
+  ExpiringCache<Address, std::string> cache(
+      wheel, kTimeToLive, 100, kMaxBytes,
+      [](const std::string& value) { return static_cast<uint64_t>(value.size()); });
+  std::vector<Address> keys;
+  for (int i(0); i < 5; ++i) {
+    keys.emplace_back(RandomString(Address::kSize));
+    cache.Add(keys.back(), std::string(40, 'a'));
+    EXPECT_LE(cache.TotalCost(), kMaxBytes);
+  }
+  // Only the two most recent 40 byte values fit.
+  EXPECT_EQ(2U, cache.size());
+  EXPECT_EQ(80U, cache.TotalCost());
+  EXPECT_EQ(3U, cache.Evicted());
+  EXPECT_TRUE(cache.Check(keys[3]));
+  EXPECT_TRUE(cache.Check(keys[4]));
+
+  // Growing a value evicts older entries rather than the one replaced.
+  cache.Add(keys[4], std::string(90, 'b'));
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_EQ(90U, cache.TotalCost());
+  EXPECT_TRUE(cache.Check(keys[4]));
+
+  // A value too costly on its own isn't held, and replaces nothing.
+  const Address too_big(RandomString(Address::kSize));
+  cache.Add(too_big, std::string(kMaxBytes + 1, 'c'));
+  EXPECT_FALSE(cache.Check(too_big));
+  EXPECT_TRUE(cache.Check(keys[4]));
+
+  // Expiry releases the cost.
+  wheel.Advance(Clock::now() + kTimeToLive + wheel.Tick());
+  EXPECT_EQ(0U, cache.size());
+  EXPECT_EQ(0U, cache.TotalCost());
+}
+
+TEST(ExpiringCacheTest, BEH_DestructionCancelsTimers) {
+  TimingWheel wheel;
+  {
+    ExpiringCache<Address, std::string> cache(wheel, kTimeToLive, 100);
+    for (int i(0); i < 10; ++i)
+      cache.Add(Address(RandomString(Address::kSize)), "value");
+    EXPECT_EQ(10U, wheel.size());
+  }
+  EXPECT_EQ(0U, wheel.size());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
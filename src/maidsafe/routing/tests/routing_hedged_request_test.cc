@@ -0,0 +1,270 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/hedged_request.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "boost/asio/io_service.hpp"
+#include "boost/asio/steady_timer.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/latency_tracker.h"
+#include "maidsafe/routing/timing_wheel.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Timer = boost::asio::steady_timer;
+
+Address RandomAddress() { return Address(RandomString(Address::kSize)); }
+
+// A request whose targets each answer after an injected delay.
+struct SimulatedRequest {
+  SimulatedRequest()
+      : key(RandomAddress(), RandomUint32()),
+        targets(),
+        delays(),
+        latency(),
+        calls(0),
+        sent(0),
+        winner(-1) {}
+  ResponseTable::Key key;
+  std::vector<Address> targets;
+  std::vector<Clock::duration> delays;
+  Clock::duration latency;
+  int calls;
+  // How many targets were sent the request, and the index of the one whose response completed it.
+  int sent;
+  std::ptrdiff_t winner;
+};
+
+// Most hops answer within a few milliseconds, but one in |slow_one_in| takes |slow|.
+std::vector<SimulatedRequest> MakeRequests(size_t count, uint32_t slow_one_in,
+                                           Clock::duration slow) {
+  std::vector<SimulatedRequest> requests(count);
+  for (auto& request : requests) {
+    for (int i(0); i != 3; ++i) {
+      request.targets.push_back(RandomAddress());
+      request.delays.push_back(RandomUint32() % slow_one_in == 0
+                                   ? slow
+                                   : std::chrono::milliseconds(1 + RandomUint32() % 4));
+    }
+  }
+  return requests;
+}
+
+// Runs every request at once, single threaded, and returns each one's latency.
+std::vector<Clock::duration> RunRequests(std::vector<SimulatedRequest>& requests,
+                                         Clock::duration delay, size_t max_attempts) {
+  boost::asio::io_service io_service;
+  TimingWheel wheel;
+  ResponseTable responses(wheel);
+  for (auto& request : requests) {
+    io_service.post([&] {
+      const auto sent(Clock::now());
+      EXPECT_TRUE(responses.Add(request.key, [&request, sent](asio::error_code error,
+                                                              SerialisedMessage) {
+        EXPECT_FALSE(error);
+        request.latency = Clock::now() - sent;
+        ++request.calls;
+      }));
+      HedgedRequest<Timer>::Start(
+          io_service, responses, request.key, request.targets, delay, max_attempts,
+          [&](const Address& target) {
+            const auto index(std::find(std::begin(request.targets), std::end(request.targets),
+                                       target) - std::begin(request.targets));
+            ++request.sent;
+            auto timer(std::make_shared<Timer>(io_service, request.delays[index]));
+            timer->async_wait([&, index, timer](const boost::system::error_code&) {
+              if (responses.Complete(request.key, asio::error_code(), SerialisedMessage(1, 1)))
+                request.winner = index;
+            });
+            return true;
+          });
+    });
+  }
+  io_service.run();
+  EXPECT_EQ(0U, responses.size());
+  EXPECT_EQ(requests.size(), responses.Completed());
+
+  std::vector<Clock::duration> latencies;
+  for (const auto& request : requests) {
+    EXPECT_EQ(1, request.calls);
+    latencies.push_back(request.latency);
+  }
+  std::sort(std::begin(latencies), std::end(latencies));
+  return latencies;
+}
+
+Clock::duration P99(const std::vector<Clock::duration>& sorted) {
+  return sorted[(sorted.size() - 1) * 99 / 100];
+}
+
+// The number of requests sent to more than one target, and the number completed by a backup.
+std::pair<size_t, size_t> CountBackups(const std::vector<SimulatedRequest>& requests) {
+  std::pair<size_t, size_t> result(0, 0);
+  for (const auto& request : requests) {
+    if (request.sent > 1)
+      ++result.first;
+    if (request.winner > 0)
+      ++result.second;
+  }
+  return result;
+}
+
+}  // anonymous namespace
+
+TEST(LatencyTrackerTest, BEH_PercentileOfRecentSamples) {
+  LatencyTracker tracker(100);
+  for (int i(0); i != static_cast<int>(LatencyTracker::kMinimumSamples) - 1; ++i)
+    tracker.Add(std::chrono::milliseconds(1));
+  EXPECT_FALSE(tracker.Percentile(0.5));
+  // Only the most recent 100 samples count: 1ms to 100ms.
+  for (int i(1000); i != 0; --i)
+    tracker.Add(std::chrono::milliseconds(i % 100 + 1));
+  EXPECT_EQ(100U, tracker.size());
+  EXPECT_EQ(std::chrono::milliseconds(1), *tracker.Percentile(0.0));
+  EXPECT_EQ(std::chrono::milliseconds(50), *tracker.Percentile(0.5));
+  EXPECT_EQ(std::chrono::milliseconds(95), *tracker.Percentile(0.95));
+  EXPECT_EQ(std::chrono::milliseconds(100), *tracker.Percentile(1.0));
+}
+
+TEST(HedgedRequestTest, BEH_BackupsOnlyWhileOutstanding) {
+  boost::asio::io_service io_service;
+  TimingWheel wheel;
+  ResponseTable responses(wheel);
+  const ResponseTable::Key key(RandomAddress(), RandomUint32());
+  const std::vector<Address> targets{RandomAddress(), RandomAddress(), RandomAddress()};
+  std::vector<Address> sent_to;
+  asio::error_code result;
+  int calls(0);
+  ASSERT_TRUE(responses.Add(key, [&](asio::error_code error, SerialisedMessage) {
+    result = error;
+    ++calls;
+  }));
+
+  // The first target doesn't answer in time and the second is unreachable, so the third is sent
+  // the backup.  An error from one target doesn't complete the request while the other may still
+  // answer.
+  HedgedRequest<Timer>::Start(io_service, responses, key, targets, std::chrono::milliseconds(1),
+                              3, [&](const Address& target) {
+                                if (target == targets[1])
+                                  return false;
+                                sent_to.push_back(target);
+                                if (target == targets[2]) {
+                                  responses.Fail(key, asio::error::connection_refused);
+                                  EXPECT_EQ(0, calls);
+                                  responses.Fail(key, asio::error::connection_refused);
+                                }
+                                return true;
+                              });
+  EXPECT_EQ(0, calls);
+  io_service.run();
+  EXPECT_EQ((std::vector<Address>{targets[0], targets[2]}), sent_to);
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(asio::error::connection_refused, result);
+
+  // Answered before the backup delay, so no backup is sent.
+  sent_to.clear();
+  calls = 0;
+  io_service.reset();
+  ASSERT_TRUE(responses.Add(key, [&](asio::error_code, SerialisedMessage) { ++calls; }));
+  HedgedRequest<Timer>::Start(io_service, responses, key, targets, std::chrono::milliseconds(1),
+                              3, [&](const Address& target) {
+                                sent_to.push_back(target);
+                                return true;
+                              });
+  responses.Complete(key, asio::error_code(), SerialisedMessage());
+  io_service.run();
+  EXPECT_EQ(std::vector<Address>(1, targets[0]), sent_to);
+  EXPECT_EQ(1, calls);
+
+  // No reachable target.
+  calls = 0;
+  io_service.reset();
+  ASSERT_TRUE(responses.Add(key, [&](asio::error_code error, SerialisedMessage) {
+    result = error;
+    ++calls;
+  }));
+  HedgedRequest<Timer>::Start(io_service, responses, key, targets, std::chrono::milliseconds(1),
+                              3, [](const Address&) { return false; });
+  io_service.run();
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(asio::error::network_unreachable, result);
+}
+
+TEST(HedgedRequestTest, FUNC_HedgingCutsTailLatency) {
+  const size_t kRequests(400);
+  const Clock::duration kSlow(std::chrono::milliseconds(200));
+
+  // Baseline: each request is only sent to its best target.
+  auto single(MakeRequests(kRequests, 33, kSlow));
+  const auto single_latencies(RunRequests(single, Clock::duration(), 1));
+  LatencyTracker tracker;
+  for (const auto& latency : single_latencies)
+    tracker.Add(latency);
+  const auto delay(tracker.Percentile(HedgeOptions().percentile));
+  ASSERT_TRUE(delay);
+
+  auto hedged(MakeRequests(kRequests, 33, kSlow));
+  const auto hedged_latencies(RunRequests(hedged, *delay, HedgeOptions().max_attempts));
+
+  const auto to_ms([](Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+  });
+  const auto single_backups(CountBackups(single)), hedged_backups(CountBackups(hedged));
+  size_t slow_first(0);
+  for (const auto& request : hedged) {
+    if (request.delays[0] == kSlow)
+      ++slow_first;
+  }
+  GTEST_LOG_(INFO) << "p99 latency: " << to_ms(P99(single_latencies)) << " ms single, "
+                   << to_ms(P99(hedged_latencies)) << " ms hedged after " << to_ms(*delay)
+                   << " ms; " << hedged_backups.first << " of " << kRequests
+                   << " requests hedged, " << hedged_backups.second << " won by a backup, "
+                   << slow_first << " with a slow first target";
+
+  // Latencies depend on the machine, so only the hedging decisions are checked.
+  EXPECT_EQ(0U, single_backups.first);
+  EXPECT_EQ(0U, single_backups.second);
+  ASSERT_LT(*delay, kSlow);
+  // Every request whose first target is slow is sent a backup.
+  EXPECT_GE(hedged_backups.first, slow_first);
+  EXPECT_LE(hedged_backups.second, hedged_backups.first);
+  EXPECT_GT(hedged_backups.second, 0U);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
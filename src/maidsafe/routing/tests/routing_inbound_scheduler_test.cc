@@ -0,0 +1,327 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/inbound_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "asio/io_service.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const InboundClass kClasses[] = {InboundClass::control, InboundClass::key,
+                                 InboundClass::data_forward, InboundClass::data_local};
+
+SerialisedMessage Encode(InboundClass inbound_class, uint32_t sequence) {
+  SerialisedMessage message(5);
+  message[0] = static_cast<byte>(inbound_class);
+  for (int i(0); i < 4; ++i)
+    message[i + 1] = static_cast<byte>(sequence >> (8 * i));
+  return message;
+}
+
+InboundClass DecodeClass(const SerialisedMessage& message) {
+  return static_cast<InboundClass>(message[0]);
+}
+
+uint32_t DecodeSequence(const SerialisedMessage& message) {
+  uint32_t sequence(0);
+  for (int i(0); i < 4; ++i)
+    sequence |= static_cast<uint32_t>(message[i + 1]) << (8 * i);
+  return sequence;
+}
+
+void BusyFor(Clock::duration duration) {
+  const auto end(Clock::now() + duration);
+  while (Clock::now() < end) {
+  }
+}
+
+// Runs an io_service on |thread_count| threads until destroyed.
+class Workers {
+ public:
+  explicit Workers(size_t thread_count)
+      : io_service_(), work_(new asio::io_service::work(io_service_)), threads_() {
+    for (size_t i(0); i < thread_count; ++i)
+      threads_.emplace_back([this] { io_service_.run(); });
+  }
+  ~Workers() {
+    work_.reset();
+    io_service_.stop();
+    for (auto& thread : threads_)
+      thread.join();
+  }
+  asio::io_service& service() { return io_service_; }
+
+ private:
+  asio::io_service io_service_;
+  std::unique_ptr<asio::io_service::work> work_;
+  std::vector<std::thread> threads_;
+};
+
+struct LatencyResult {
+  Clock::duration early, late, worst;
+};
+
+// Every millisecond pushes |data_per_ms| data messages, each costing |data_cost| to handle, and one
+// control message.  Returns the control latencies over the first and last quarters of the run, and
+// the worst.
+template <typename PushFunctor>
+LatencyResult MeasureControlLatency(size_t iterations, size_t data_per_ms, PushFunctor push,
+                                    std::vector<Clock::time_point>& pushed,
+                                    std::vector<Clock::time_point>& handled,
+                                    std::atomic<size_t>& controls_handled) {
+  pushed.assign(iterations, Clock::time_point());
+  handled.assign(iterations, Clock::time_point());
+  auto next(Clock::now());
+  uint32_t data_sequence(0);
+  for (uint32_t i(0); i < iterations; ++i) {
+    next += std::chrono::milliseconds(1);
+    for (size_t j(0); j < data_per_ms; ++j)
+      push(InboundClass::data_forward, data_sequence++);
+    pushed[i] = Clock::now();
+    push(InboundClass::control, i);
+    std::this_thread::sleep_until(next);
+  }
+  while (controls_handled < iterations)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  const auto mean([&](size_t begin, size_t end) {
+    Clock::duration total(0);
+    for (size_t i(begin); i < end; ++i)
+      total += handled[i] - pushed[i];
+    return total / static_cast<int>(end - begin);
+  });
+  LatencyResult result;
+  result.early = mean(0, iterations / 4);
+  result.late = mean(iterations - iterations / 4, iterations);
+  result.worst = Clock::duration(0);
+  for (size_t i(0); i < iterations; ++i)
+    result.worst = std::max(result.worst, handled[i] - pushed[i]);
+  return result;
+}
+
+double Milliseconds(Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // anonymous namespace
+
+TEST(InboundSchedulerTest, BEH_Classify) {
+  EXPECT_EQ(InboundClass::control, Classify(MessageTypeTag::Connect, true));
+  EXPECT_EQ(InboundClass::control, Classify(MessageTypeTag::FindGroupResponse, false));
+  EXPECT_EQ(InboundClass::key, Classify(MessageTypeTag::GetKey, false));
+  EXPECT_EQ(InboundClass::key, Classify(MessageTypeTag::GetGroupKeyResponse, true));
+  EXPECT_EQ(InboundClass::data_local, Classify(MessageTypeTag::PutData, true));
+  EXPECT_EQ(InboundClass::data_forward, Classify(MessageTypeTag::PutData, false));
+  EXPECT_EQ(InboundClass::data_forward, Classify(MessageTypeTag::GetDataResponse, false));
+}
+
+TEST(InboundSchedulerTest, BEH_InvalidParameters) {
+  asio::io_service io_service;
+  EXPECT_THROW(InboundScheduler(io_service, 0), maidsafe_error);
+  InboundOptions options;
+  options.weights[2] = 0;
+  EXPECT_THROW(InboundScheduler(io_service, 1, options), maidsafe_error);
+  options = InboundOptions();
+  options.capacities[0] = 0;
+  EXPECT_THROW(InboundScheduler(io_service, 1, options), maidsafe_error);
+  InboundScheduler scheduler(io_service, 1);
+  EXPECT_THROW(scheduler.Push(InboundClass::control, InboundScheduler::Task()), maidsafe_error);
+}
+
+TEST(InboundSchedulerTest, BEH_WeightedRoundRobin) {
+  asio::io_service io_service;
+  std::vector<InboundClass> order;
+  InboundScheduler scheduler(io_service, 1);
+  for (uint32_t i(0); i < 10; ++i) {
+    for (const auto inbound_class : kClasses) {
+      EXPECT_TRUE(scheduler.Push(inbound_class,
+                                 [&order, inbound_class] { order.push_back(inbound_class); }));
+    }
+  }
+  io_service.run();
+  ASSERT_EQ(40U, order.size());
+
+  // Default weights are 8 control, 4 key, 1 data forward, 2 data local.
+  std::vector<InboundClass> expected;
+  const auto append([&](InboundClass inbound_class, size_t count) {
+    expected.insert(std::end(expected), count, inbound_class);
+  });
+  append(InboundClass::control, 8);
+  append(InboundClass::key, 4);
+  append(InboundClass::data_forward, 1);
+  append(InboundClass::data_local, 2);
+  append(InboundClass::control, 2);
+  append(InboundClass::key, 4);
+  append(InboundClass::data_forward, 1);
+  append(InboundClass::data_local, 2);
+  append(InboundClass::key, 2);
+  append(InboundClass::data_forward, 1);
+  append(InboundClass::data_local, 2);
+  EXPECT_TRUE(std::equal(std::begin(expected), std::end(expected), std::begin(order)));
+  for (const auto inbound_class : kClasses) {
+    EXPECT_EQ(10U, scheduler.Handled(inbound_class));
+    EXPECT_EQ(0U, scheduler.Queued(inbound_class));
+  }
+}
+
+TEST(InboundSchedulerTest, BEH_DropsWhenFullOrStopped) {
+  asio::io_service io_service;
+  InboundOptions options;
+  options.capacities[static_cast<size_t>(InboundClass::data_forward)] = 2;
+  size_t handled(0);
+  const InboundScheduler::Task task([&handled] { ++handled; });
+  InboundScheduler scheduler(io_service, 1, options);
+  EXPECT_TRUE(scheduler.Push(InboundClass::data_forward, task));
+  EXPECT_TRUE(scheduler.Push(InboundClass::data_forward, task));
+  EXPECT_FALSE(scheduler.Push(InboundClass::data_forward, task));
+  EXPECT_TRUE(scheduler.Push(InboundClass::control, task));
+  EXPECT_EQ(2U, scheduler.Queued(InboundClass::data_forward));
+  EXPECT_EQ(1U, scheduler.Dropped(InboundClass::data_forward));
+  EXPECT_EQ(0U, scheduler.Dropped(InboundClass::control));
+
+  scheduler.Stop();
+  EXPECT_FALSE(scheduler.Push(InboundClass::control, task));
+  io_service.run();
+  EXPECT_EQ(0U, handled);
+  EXPECT_EQ(3U, scheduler.Dropped(InboundClass::data_forward));
+  EXPECT_EQ(2U, scheduler.Dropped(InboundClass::control));
+}
+
+TEST(InboundSchedulerTest, FUNC_ControlLatencyUnderSaturation) {
+  // Two handler threads each taking 100us per data message can handle 20 per millisecond; 40 are
+  // pushed, so the data backlog grows for the whole run.
+  const size_t kThreads(2), kIterations(500), kDataPerMs(40);
+  const auto kDataCost(std::chrono::microseconds(100));
+  std::vector<Clock::time_point> pushed, handled;
+  // For control message i, the number of data messages accepted before it was pushed and the
+  // number which had been handled by the time it was.
+  std::vector<size_t> accepted_before(kIterations), handled_before(kIterations);
+  std::atomic<size_t> controls_handled(0), data_handled(0);
+  size_t data_accepted(0);
+  const auto handle([&](const SerialisedMessage& message) {
+    if (DecodeClass(message) == InboundClass::control) {
+      handled[DecodeSequence(message)] = Clock::now();
+      handled_before[DecodeSequence(message)] = data_handled;
+      ++controls_handled;
+    } else {
+      BusyFor(kDataCost);
+      ++data_handled;
+    }
+  });
+  // Counts the control messages handled ahead of data messages accepted before them.  At most
+  // |kThreads| - 1 earlier data messages can still be in a handler when a control message starts.
+  const auto count_overtaking([&] {
+    size_t overtaking(0);
+    for (size_t i(0); i < kIterations; ++i) {
+      if (handled_before[i] + kThreads - 1 < accepted_before[i])
+        ++overtaking;
+    }
+    return overtaking;
+  });
+
+  LatencyResult fifo;
+  size_t fifo_overtaking(0);
+  {
+    // Every message posted straight to the handler threads in arrival order.
+    Workers workers(kThreads);
+    fifo = MeasureControlLatency(kIterations, kDataPerMs, [&](InboundClass inbound_class,
+                                                              uint32_t sequence) {
+      const auto message(std::make_shared<SerialisedMessage>(Encode(inbound_class, sequence)));
+      if (inbound_class == InboundClass::control)
+        accepted_before[sequence] = data_accepted;
+      else
+        ++data_accepted;
+      workers.service().post([&handle, message] { handle(*message); });
+    }, pushed, handled, controls_handled);
+    workers.service().stop();
+    fifo_overtaking = count_overtaking();
+  }
+
+  controls_handled = 0;
+  data_handled = 0;
+  data_accepted = 0;
+  LatencyResult scheduled;
+  size_t scheduled_overtaking(0);
+  uint64_t dropped(0);
+  {
+    Workers workers(kThreads);
+    InboundScheduler scheduler(workers.service(), kThreads);
+    scheduled = MeasureControlLatency(kIterations, kDataPerMs, [&](InboundClass inbound_class,
+                                                                   uint32_t sequence) {
+      const auto message(std::make_shared<SerialisedMessage>(Encode(inbound_class, sequence)));
+      if (inbound_class == InboundClass::control)
+        accepted_before[sequence] = data_accepted;
+      if (scheduler.Push(inbound_class, [&handle, message] { handle(*message); }) &&
+          inbound_class != InboundClass::control) {
+        ++data_accepted;
+      }
+    }, pushed, handled, controls_handled);
+    scheduler.Stop();
+    scheduled_overtaking = count_overtaking();
+    dropped = scheduler.Dropped(InboundClass::data_forward);
+    EXPECT_EQ(0U, scheduler.Dropped(InboundClass::control));
+    EXPECT_EQ(kIterations, scheduler.Handled(InboundClass::control));
+  }
+
+  std::cout << "Control latency with " << kDataPerMs << " data messages/ms offered to capacity for "
+            << (kThreads * 1000 / 100) << "/ms, over " << kIterations << " ms\n"
+            << "  arrival order: first quarter " << Milliseconds(fifo.early)
+            << " ms, last quarter " << Milliseconds(fifo.late) << " ms, worst "
+            << Milliseconds(fifo.worst) << " ms, " << fifo_overtaking << " of " << kIterations
+            << " handled ahead of earlier data\n"
+            << "  scheduled:     first quarter " << Milliseconds(scheduled.early)
+            << " ms, last quarter " << Milliseconds(scheduled.late) << " ms, worst "
+            << Milliseconds(scheduled.worst) << " ms, " << scheduled_overtaking << " of "
+            << kIterations << " handled ahead of earlier data (" << dropped
+            << " data messages dropped)\n";
+
+  // The latencies above depend on the machine, so only the order of handling is checked.  In
+  // arrival order a control message always waits for the data backlog ahead of it; the scheduler
+  // lets control messages past queued data.
+  EXPECT_EQ(0U, fifo_overtaking);
+  EXPECT_GT(scheduled_overtaking, 0U);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,143 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/key_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+Address RandomAddress() { return Address(RandomString(Address::kSize)); }
+
+class KeyCacheTest : public testing::Test {
+ protected:
+  KeyCacheTest()
+      : cache_(std::chrono::minutes(20), 100),
+        public_key_(asymm::GenerateKeyPair().public_key),
+        group_(RandomAddress()),
+        keys_() {
+    for (size_t i(0); i < GroupSize; ++i)
+      keys_.insert(std::make_pair(RandomAddress(), public_key_));
+  }
+
+  // A node further from the group's address than all of its members.
+  Address DistantNode() const {
+    for (;;) {
+      const auto node(RandomAddress());
+      const auto closer_than = [&](const KeyCache::Keys::value_type& key) {
+        return Address::CloserToTarget(node, key.first, group_.data);
+      };
+      if (std::none_of(std::begin(keys_), std::end(keys_), closer_than))
+        return node;
+    }
+  }
+
+  // A node closer to the group's address than any of its members.
+  Address CloseNode() const {
+    auto name(group_->string());
+    name.back() ^= 1;
+    return Address(name);
+  }
+
+  KeyCache cache_;
+  asymm::PublicKey public_key_;
+  GroupAddress group_;
+  KeyCache::Keys keys_;
+};
+
+}  // anonymous namespace
+
+TEST_F(KeyCacheTest, BEH_HitsAndMisses) {
+  EXPECT_FALSE(cache_.GetGroup(group_));
+  cache_.AddGroup(group_, keys_);
+  const auto keys(cache_.GetGroup(group_));
+  ASSERT_TRUE(static_cast<bool>(keys));
+  EXPECT_EQ(GroupSize, keys->size());
+
+  const auto node(RandomAddress());
+  EXPECT_FALSE(cache_.GetNode(node));
+  cache_.AddNode(node, public_key_);
+  EXPECT_TRUE(static_cast<bool>(cache_.GetNode(node)));
+
+  EXPECT_EQ(1U, cache_.GroupCount());
+  EXPECT_EQ(1U, cache_.NodeCount());
+  EXPECT_EQ(2U, cache_.Hits());
+  EXPECT_EQ(2U, cache_.Misses());
+}
+
+TEST_F(KeyCacheTest, BEH_Expiry) {
+  KeyCache cache(std::chrono::milliseconds(20), 100);
+  cache.AddGroup(group_, keys_);
+  const auto node(RandomAddress());
+  cache.AddNode(node, public_key_);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(cache.GetGroup(group_));
+  EXPECT_FALSE(cache.GetNode(node));
+  EXPECT_EQ(0U, cache.GroupCount());
+  EXPECT_EQ(0U, cache.NodeCount());
+}
+
+TEST_F(KeyCacheTest, BEH_ChurnInvalidation) {
+  cache_.AddGroup(group_, keys_);
+  // Churn elsewhere in the network leaves the group alone
+  cache_.HandleChurn(DistantNode());
+  EXPECT_TRUE(static_cast<bool>(cache_.GetGroup(group_)));
+  EXPECT_EQ(0U, cache_.Invalidations());
+
+  // A member leaving
+  cache_.HandleChurn(std::begin(keys_)->first);
+  EXPECT_FALSE(cache_.GetGroup(group_));
+  EXPECT_EQ(1U, cache_.Invalidations());
+
+  // A node joining close enough to become a member
+  cache_.AddGroup(group_, keys_);
+  cache_.HandleChurn(CloseNode());
+  EXPECT_FALSE(cache_.GetGroup(group_));
+  EXPECT_EQ(2U, cache_.Invalidations());
+}
+
+TEST_F(KeyCacheTest, BEH_Bounded) {
+  const size_t capacity(5);
+  KeyCache cache(std::chrono::minutes(20), capacity);
+  for (size_t i(0); i < capacity * 2; ++i) {
+    cache.AddGroup(GroupAddress(RandomAddress()), keys_);
+    cache.AddNode(RandomAddress(), public_key_);
+    EXPECT_LE(cache.GroupCount(), capacity);
+    EXPECT_LE(cache.NodeCount(), capacity);
+  }
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,88 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/message_dispatch.h"
+
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/messages/messages.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+struct RecordingHandler {
+  template <typename Message>
+  void HandleMessage(Message&& /*message*/, MessageHeader&& header) {
+    tags.push_back(MessageToTag<typename std::decay<Message>::type>::value);
+    headers.push_back(std::move(header));
+  }
+
+  std::vector<MessageTypeTag> tags;
+  std::vector<MessageHeader> headers;
+};
+
+}  // anonymous namespace
+
+TEST(MessageDispatchTest, BEH_DispatchKnownTag) {
+  const auto header(GetRandomMessageHeader());
+  const GetGroupKey message{GroupAddress(Address{RandomString(Address::kSize)})};
+  const auto serialised(Serialise(header, MessageToTag<GetGroupKey>::value, message));
+
+  InputVectorStream binary_input_stream{serialised};
+  MessageHeader parsed_header;
+  MessageTypeTag tag;
+  Parse(binary_input_stream, parsed_header, tag);
+
+  RecordingHandler handler;
+  EXPECT_TRUE(MessageDispatcher<RecordingHandler>::Dispatch(handler, tag, binary_input_stream,
+                                                            std::move(parsed_header)));
+  ASSERT_EQ(1U, handler.tags.size());
+  EXPECT_EQ(MessageTypeTag::GetGroupKey, handler.tags.front());
+  EXPECT_EQ(header, handler.headers.front());
+}
+
+TEST(MessageDispatchTest, BEH_RejectUnknownTag) {
+  const auto serialised(Serialise(GetRandomMessageHeader()));
+  InputVectorStream binary_input_stream{serialised};
+  MessageHeader parsed_header;
+  Parse(binary_input_stream, parsed_header);
+
+  RecordingHandler handler;
+  EXPECT_FALSE(MessageDispatcher<RecordingHandler>::Dispatch(
+      handler, static_cast<MessageTypeTag>(kMessageTypeTagCount), binary_input_stream,
+      std::move(parsed_header)));
+  EXPECT_TRUE(handler.tags.empty());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,147 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/message_header_view.h"
+
+#include <string>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/binary_archive.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/messages/messages_fwd.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+Address RandomAddress() { return Address(RandomString(Address::kSize)); }
+
+std::string ToString(ByteRange range) { return std::string(range.begin(), range.end()); }
+
+MessageHeader GetRelayedGroupMessageHeader() {
+  return MessageHeader(
+      DestinationAddress(std::make_pair(Destination(RandomAddress()),
+                                        ReplyToAddress(RandomAddress()))),
+      SourceAddress(NodeAddress(RandomAddress()), GroupAddress(RandomAddress()),
+                    ReplyToAddress(RandomAddress())),
+      MessageId(RandomUint32()), Authority::nae_manager);
+}
+
+void CheckViewMatchesHeader(const MessageHeaderView& view, const MessageHeader& header) {
+  EXPECT_EQ(MessageHeaderView::kVersion, view.Version());
+  EXPECT_EQ(header.MessageId(), view.MessageId());
+  EXPECT_EQ(header.FromAuthority(), view.FromAuthority());
+  EXPECT_EQ(header.Destination().first->string(), ToString(view.Destination()));
+  EXPECT_EQ(static_cast<bool>(header.Destination().second),
+            static_cast<bool>(view.DestinationReplyTo()));
+  if (header.Destination().second)
+    EXPECT_EQ(header.Destination().second->data.string(), ToString(*view.DestinationReplyTo()));
+  EXPECT_EQ(header.FromNode()->string(), ToString(view.FromNode()));
+  EXPECT_EQ(static_cast<bool>(header.FromGroup()), static_cast<bool>(view.FromGroup()));
+  if (header.FromGroup())
+    EXPECT_EQ(header.FromGroup()->data.string(), ToString(*view.FromGroup()));
+  EXPECT_EQ(header.RelayedMessage(), view.RelayedMessage());
+  if (header.RelayedMessage())
+    EXPECT_EQ(header.ReplyToAddress()->data.string(), ToString(*view.ReplyToAddress()));
+  EXPECT_EQ(static_cast<bool>(header.Signature()), static_cast<bool>(view.Signature()));
+  if (header.Signature())
+    EXPECT_EQ(header.Signature()->string(), ToString(*view.Signature()));
+}
+
+}  // anonymous namespace
+
+TEST(MessageHeaderViewTest, BEH_SignedHeaderRoundTrip) {
+  const auto header(GetRandomMessageHeader());
+  const auto tag(MessageToTag<PutData>::value);
+  const std::string body(RandomString(100));
+
+  auto serialised(MessageHeaderView::Write(header, tag));
+  serialised.insert(std::end(serialised), std::begin(body), std::end(body));
+
+  MessageHeaderView view(serialised);
+  EXPECT_EQ(tag, view.Tag());
+  CheckViewMatchesHeader(view, header);
+  EXPECT_EQ(MessageHeaderView::kFixedSize + header.Signature()->string().size(), view.Size());
+  EXPECT_EQ(body, ToString(view.Body()));
+
+  // Owning header rebuilt from the view must be identical to the original
+  EXPECT_EQ(header, view.ToMessageHeader());
+}
+
+TEST(MessageHeaderViewTest, BEH_UnsignedRelayedGroupHeaderRoundTrip) {
+  const auto header(GetRelayedGroupMessageHeader());
+  const auto tag(MessageToTag<FindGroupResponse>::value);
+
+  const auto serialised(MessageHeaderView::Write(header, tag));
+  EXPECT_EQ(MessageHeaderView::kFixedSize, serialised.size());
+
+  MessageHeaderView view(serialised);
+  EXPECT_EQ(tag, view.Tag());
+  CheckViewMatchesHeader(view, header);
+  EXPECT_TRUE(view.Body().empty());
+  EXPECT_EQ(header, view.ToMessageHeader());
+}
+
+TEST(MessageHeaderViewTest, BEH_CerealAndFixedLayoutAgree) {
+  // Both encodings of the same owning header must decode to equal owning headers.
+  const auto header(GetRandomMessageHeader());
+  const auto tag(MessageToTag<GetData>::value);
+
+  const auto cereal_serialised(Serialise(header, tag));
+  InputVectorStream binary_input_stream{cereal_serialised};
+  MessageHeader cereal_header;
+  MessageTypeTag cereal_tag;
+  Parse(binary_input_stream, cereal_header, cereal_tag);
+
+  const auto fixed_serialised(MessageHeaderView::Write(header, tag));
+  MessageHeaderView view(fixed_serialised);
+
+  EXPECT_EQ(cereal_tag, view.Tag());
+  EXPECT_EQ(cereal_header, view.ToMessageHeader());
+  CheckViewMatchesHeader(view, cereal_header);
+}
+
+TEST(MessageHeaderViewTest, BEH_InvalidBuffers) {
+  const auto header(GetRandomMessageHeader());
+  auto serialised(MessageHeaderView::Write(header, MessageToTag<Connect>::value));
+
+  // Too short for the fixed part
+  EXPECT_THROW(MessageHeaderView(serialised.data(), MessageHeaderView::kFixedSize - 1),
+               maidsafe_error);
+  // Fixed part present but signature truncated
+  EXPECT_THROW(MessageHeaderView(serialised.data(), serialised.size() - 1), maidsafe_error);
+  EXPECT_THROW(MessageHeaderView(nullptr, 0), maidsafe_error);
+  // Unknown version
+  ++serialised[0];
+  EXPECT_THROW(MessageHeaderView{serialised}, maidsafe_error);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -45,6 +45,11 @@ namespace test {
 TEST(NetworkInitTest, FUNC_TwoNodes) {
   struct Node : public RoutingNode<Node> {
     void HandleMessage(GetData, MessageHeader) {}
+    HandleGetReturn HandleGet(SourceAddress, Authority, DataTagValue, Identity) {
+      return boost::make_unexpected(MakeError(CommonErrors::no_such_element));
+    }
+    bool HandlePut(Address, SerialisedMessage) { return false; }
+    bool HandlePost(const SerialisedMessage&) { return false; }
     void HandleConnectionAdded(NodeId) {
       Shutdown();
     }
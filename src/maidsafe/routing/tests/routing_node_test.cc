@@ -0,0 +1,473 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "asio/error.hpp"
+#include "asio/ip/udp.hpp"
+#include "boost/asio/io_service.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/routing/connection_manager.h"
+#include "maidsafe/routing/endpoint_pair.h"
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/outbound_message.h"
+#include "maidsafe/routing/routing_node.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/get_data.h"
+#include "maidsafe/routing/messages/get_data_response.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate, Clock::duration timeout) {
+  const auto deadline(Clock::now() + timeout);
+  while (!predicate()) {
+    if (Clock::now() > deadline)
+      return false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+// Put needs only the data's tag and serialised form.
+struct Chunk {
+  struct Tag {
+    static const DataTagValue kValue = DataTagValue::kImmutableDataValue;
+  };
+  SerialisedData serialise() const { return content; }
+  SerialisedData content;
+};
+
+const DataTagValue Chunk::Tag::kValue;
+
+// Stores whatever is Put to it and serves it to Gets.
+class StoringNode : public RoutingNode<StoringNode> {
+ public:
+  StoringNode()
+      : mutex_(), store_(), connections_(0), posts_(0), refuse_puts_(false), refuse_posts_(false) {}
+
+  HandleGetReturn HandleGet(SourceAddress /*from*/, Authority /*authority*/,
+                            DataTagValue /*data_type*/, Identity data_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto found(store_.find(data_name.string()));
+    if (found == std::end(store_))
+      return boost::make_unexpected(MakeError(CommonErrors::no_such_element));
+    return HandleGetReturn(
+        boost::variant<std::vector<DestinationAddress>, std::vector<byte>>(found->second));
+  }
+
+  bool HandlePut(Address name, SerialisedMessage data) {
+    if (refuse_puts_)
+      return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    store_[name.string()] = std::move(data);
+    return true;
+  }
+
+  bool HandlePost(const SerialisedMessage&) {
+    ++posts_;
+    return !refuse_posts_;
+  }
+
+  void HandleConnectionAdded(NodeId) { ++connections_; }
+
+  void RefusePuts(bool refuse) { refuse_puts_ = refuse; }
+  void RefusePosts(bool refuse) { refuse_posts_ = refuse; }
+
+  size_t Connections() const { return connections_; }
+  size_t Posts() const { return posts_; }
+  size_t Stored() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return store_.size();
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, SerialisedMessage> store_;
+  std::atomic<size_t> connections_, posts_;
+  std::atomic<bool> refuse_puts_, refuse_posts_;
+};
+
+// Two nodes connected over the loopback interface.
+class TwoNodes {
+ public:
+  TwoNodes() : server_(), client_() {
+    const auto port(static_cast<unsigned short>(40000 + RandomUint32() % 20000));
+    server_.StartAccepting(port);
+    client_.AddContact(asio::ip::udp::endpoint(asio::ip::address_v4::loopback(), port));
+  }
+
+  bool Connected() const { return server_.Connections() == 1 && client_.Connections() == 1; }
+  StoringNode& server() { return server_; }
+  StoringNode& client() { return client_; }
+
+ private:
+  StoringNode server_, client_;
+};
+
+// Counts completions, remembering whether any failed.
+class Completions {
+ public:
+  Completions() : mutex_(), completed_(0), failed_(0) {}
+
+  void Add(asio::error_code error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++completed_;
+    if (error)
+      ++failed_;
+  }
+  size_t Completed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return completed_;
+  }
+  size_t Failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  size_t completed_, failed_;
+};
+
+double Seconds(Clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+// Runs |functor| on |io_service|'s thread and waits for its result.
+template <typename Functor>
+auto RunOn(boost::asio::io_service& io_service, Functor functor) -> decltype(functor()) {
+  std::packaged_task<decltype(functor())()> task(functor);
+  auto result(task.get_future());
+  io_service.post([&task] { task(); });
+  return result.get();
+}
+
+// A node with two bare connection managers connected to it, driven by one io_service thread (as
+// ConnectionManager expects), which record every message they receive.  The first stands in for
+// a client relaying through the node, the second for any other peer.
+class RelayNetwork {
+ public:
+  enum Peer { kClientSide = 0, kOther = 1 };
+
+  RelayNetwork()
+      : node_(),
+        node_id_(),
+        io_service_(),
+        work_(new boost::asio::io_service::work(io_service_)),
+        peers_(),
+        mutex_(),
+        received_(2),
+        thread_([this] { io_service_.run(); }) {
+    const auto port(static_cast<unsigned short>(40000 + RandomUint32() % 20000));
+    node_.StartAccepting(port);
+    for (size_t i(0); i < 2; ++i) {
+      peers_.emplace_back(new ConnectionManager(
+          io_service_, passport::PublicPmid(passport::CreatePmidAndSigner().first)));
+    }
+    RunOn(io_service_, [&] {
+      for (size_t i(0); i < 2; ++i) {
+        peers_[i]->SetOnConnectionAdded([this](NodeId id) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          node_id_ = id;
+        });
+        peers_[i]->SetOnReceive([this, i](NodeId, const SerialisedMessage& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          received_[i].push_back(message);
+        });
+        peers_[i]->AddNode(boost::none, EndpointPair(asio::ip::udp::endpoint(
+                                            asio::ip::address_v4::loopback(), port)));
+      }
+    });
+  }
+
+  ~RelayNetwork() {
+    work_.reset();
+    io_service_.stop();
+    thread_.join();
+  }
+
+  bool Connected() {
+    return node_.Connections() == 2 &&
+           RunOn(io_service_, [this] { return peers_[0]->Size() == 1 && peers_[1]->Size() == 1; });
+  }
+
+  Address RoutingNodeId() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return node_id_;
+  }
+
+  Address PeerId(Peer peer) { return peers_[peer]->OurId(); }
+
+  // Sends |message| from |peer| to the node, returning the bytes sent.
+  template <typename Message>
+  SerialisedMessage Send(Peer peer, const MessageHeader& header, const Message& message) {
+    const auto node_id(RoutingNodeId());
+    RunOn(io_service_, [&] {
+      OutboundMessage(header, message).Send(*peers_[peer], std::vector<Address>(1, node_id));
+    });
+    return Serialise(header, MessageToTag<Message>::value, message);
+  }
+
+  size_t Received(Peer peer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return received_[peer].size();
+  }
+
+  size_t Received(Peer peer, const SerialisedMessage& message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(
+        std::count(std::begin(received_[peer]), std::end(received_[peer]), message));
+  }
+
+ private:
+  StoringNode node_;
+  Address node_id_;
+  boost::asio::io_service io_service_;
+  std::unique_ptr<boost::asio::io_service::work> work_;
+  std::vector<std::unique_ptr<ConnectionManager>> peers_;
+  std::mutex mutex_;
+  std::vector<std::vector<SerialisedMessage>> received_;
+  std::thread thread_;
+};
+
+using BatchDone = std::function<void(asio::error_code, std::vector<BatchResult>)>;
+
+// Calls |send| with a handler for a PutBatch or GetBatch and waits for the results.
+template <typename Send>
+std::vector<BatchResult> RunBatch(Send send) {
+  std::promise<std::vector<BatchResult>> promise;
+  send(BatchDone([&promise](asio::error_code error, std::vector<BatchResult> results) {
+    EXPECT_FALSE(error);
+    promise.set_value(std::move(results));
+  }));
+  auto future(promise.get_future());
+  if (future.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+    ADD_FAILURE() << "batch not completed";
+    return std::vector<BatchResult>();
+  }
+  return future.get();
+}
+
+}  // anonymous namespace
+
+TEST(RoutingNodeTest, FUNC_PipelinedPutsAndGets) {
+  const size_t kRequests(1000), kChunkSize(1024);
+  TwoNodes nodes;
+  ASSERT_TRUE(WaitFor([&] { return nodes.Connected(); }, std::chrono::seconds(10)));
+
+  std::vector<Identity> names;
+  std::vector<SerialisedData> contents;
+  for (size_t i(0); i < kRequests; ++i) {
+    names.emplace_back(RandomString(Address::kSize));
+    const auto content(RandomString(kChunkSize));
+    contents.emplace_back(std::begin(content), std::end(content));
+  }
+
+  // Every request is sent before any response is awaited, so all are outstanding at once.
+  Completions puts;
+  const auto put_start(Clock::now());
+  for (size_t i(0); i < kRequests; ++i) {
+    nodes.client().Put(Address(names[i].string()), Chunk{contents[i]},
+                       [&puts](asio::error_code error) { puts.Add(error); });
+  }
+  EXPECT_TRUE(WaitFor([&] { return puts.Completed() == kRequests; }, std::chrono::seconds(60)));
+  const auto put_time(Clock::now() - put_start);
+  EXPECT_EQ(0U, puts.Failed());
+  EXPECT_TRUE(
+      WaitFor([&] { return nodes.server().Stored() == kRequests; }, std::chrono::seconds(10)));
+
+  Completions gets;
+  std::mutex mutex;
+  size_t mismatched(0);
+  const auto get_start(Clock::now());
+  for (size_t i(0); i < kRequests; ++i) {
+    const auto& expected(contents[i]);
+    nodes.client().Get<Chunk>(names[i], [&, expected](asio::error_code error,
+                                                      SerialisedMessage data) {
+      if (!error && data != expected) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++mismatched;
+      }
+      gets.Add(error);
+    });
+  }
+  EXPECT_TRUE(WaitFor([&] { return gets.Completed() == kRequests; }, std::chrono::seconds(60)));
+  const auto get_time(Clock::now() - get_start);
+  EXPECT_EQ(0U, gets.Failed());
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(0U, mismatched);
+  }
+
+  // Get for a name never Put is answered with an error rather than left to time out.
+  std::promise<asio::error_code> missing;
+  nodes.client().Get<Chunk>(Identity(RandomString(Address::kSize)),
+                            [&missing](asio::error_code error, SerialisedMessage) {
+                              missing.set_value(error);
+                            });
+  auto missing_result(missing.get_future());
+  ASSERT_EQ(std::future_status::ready, missing_result.wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(make_error_code(CommonErrors::no_such_element), missing_result.get());
+
+  std::cout << kRequests << " pipelined " << kChunkSize / 1024 << " KiB requests between two "
+            << "nodes: Puts in " << Seconds(put_time) << " s (" << kRequests / Seconds(put_time)
+            << "/s), Gets in " << Seconds(get_time) << " s (" << kRequests / Seconds(get_time)
+            << "/s)\n";
+}
+
+TEST(RoutingNodeTest, FUNC_PostAnswered) {
+  TwoNodes nodes;
+  ASSERT_TRUE(WaitFor([&] { return nodes.Connected(); }, std::chrono::seconds(10)));
+  const auto post([&]() -> asio::error_code {
+    const auto content(RandomString(64));
+    std::promise<asio::error_code> done;
+    nodes.client().Post(Address(RandomString(Address::kSize)),
+                        Chunk{SerialisedData(std::begin(content), std::end(content))},
+                        [&done](asio::error_code error) { done.set_value(error); });
+    auto result(done.get_future());
+    if (result.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+      return asio::error::timed_out;
+    return result.get();
+  });
+
+  // Answered as soon as the Child has handled it, rather than left to time out.
+  EXPECT_EQ(asio::error_code(), post());
+  EXPECT_NE(0U, nodes.server().Posts());
+
+  nodes.server().RefusePosts(true);
+  nodes.client().RefusePosts(true);
+  EXPECT_EQ(make_error_code(CommonErrors::unable_to_handle_request), post());
+}
+
+TEST(RoutingNodeTest, BEH_PutAndGetBatch) {
+  const size_t kEntries(20);
+  // With no peers this node is in the close group of every name, so each entry is handled here.
+  StoringNode node;
+  std::vector<PutDataBatch::Entry> puts;
+  std::vector<GetDataBatch::Entry> gets;
+  for (size_t i(0); i < kEntries; ++i) {
+    const Identity name(RandomString(Address::kSize));
+    const auto content(RandomString(1024));
+    puts.push_back(PutDataBatch::Entry{DataTagValue::kImmutableDataValue, name,
+                                       SerialisedData(std::begin(content), std::end(content))});
+    gets.push_back(GetDataBatch::Entry{DataTagValue::kImmutableDataValue, name});
+  }
+
+  // Entries the node fails to store are reported as failed, not as stored.
+  node.RefusePuts(true);
+  auto results(RunBatch([&](BatchDone done) { node.PutBatch(puts, done); }));
+  ASSERT_EQ(kEntries, results.size());
+  for (const auto& result : results)
+    EXPECT_EQ(make_error_code(CommonErrors::unable_to_handle_request), result.error);
+  EXPECT_EQ(0U, node.Stored());
+
+  node.RefusePuts(false);
+  results = RunBatch([&](BatchDone done) { node.PutBatch(puts, done); });
+  ASSERT_EQ(kEntries, results.size());
+  for (size_t i(0); i < kEntries; ++i) {
+    EXPECT_EQ(puts[i].name, results[i].name);
+    EXPECT_FALSE(results[i].error);
+  }
+  EXPECT_EQ(kEntries, node.Stored());
+
+  // A Get for a name never Put fails alone, without failing the rest of the batch.
+  gets.push_back(GetDataBatch::Entry{DataTagValue::kImmutableDataValue,
+                                     Identity(RandomString(Address::kSize))});
+  results = RunBatch([&](BatchDone done) { node.GetBatch(gets, done); });
+  ASSERT_EQ(kEntries + 1, results.size());
+  for (size_t i(0); i < kEntries; ++i) {
+    EXPECT_FALSE(results[i].error);
+    EXPECT_EQ(puts[i].data, results[i].data);
+  }
+  EXPECT_EQ(make_error_code(CommonErrors::no_such_element), results.back().error);
+}
+
+TEST(RoutingNodeTest, FUNC_RelaysResponsesToClients) {
+  RelayNetwork network;
+  ASSERT_TRUE(WaitFor([&] { return network.Connected(); }, std::chrono::seconds(10)));
+  const Address node_id(network.RoutingNodeId());
+  const ReplyToAddress client(Address(RandomString(Address::kSize)));
+  const ReplyToAddress stranger(Address(RandomString(Address::kSize)));
+  const Identity name(RandomString(Address::kSize));
+  const auto other(network.PeerId(RelayNetwork::kOther));
+  auto message_id(RandomUint32());
+  auto send_response([&](const ReplyToAddress& to) {
+    return network.Send(
+        RelayNetwork::kOther,
+        MessageHeader(std::make_pair(Destination(node_id), to),
+                      SourceAddress(NodeAddress(other), GroupAddress(Address(name.string())),
+                                    boost::none),
+                      ++message_id, Authority::nae_manager),
+        GetDataResponse(Identity(name), MakeError(CommonErrors::no_such_element)));
+  });
+
+  // A response for a client which hasn't relayed through the node is dropped.
+  const auto unrelayed(send_response(stranger));
+
+  // A request relayed by a client names the node as its source, and so records the relay.
+  const SourceAddress relayed_source(NodeAddress(node_id), boost::none, client);
+  const auto received_before(network.Received(RelayNetwork::kOther));
+  network.Send(RelayNetwork::kClientSide,
+               MessageHeader(std::make_pair(Destination(Address(name.string())), boost::none),
+                             relayed_source, ++message_id, Authority::client),
+               GetData(DataTagValue::kImmutableDataValue, name, relayed_source));
+  // The node answers (and forwards) the request to its other peer once it has handled it.
+  ASSERT_TRUE(WaitFor([&] { return network.Received(RelayNetwork::kOther) > received_before; },
+                      std::chrono::seconds(10)));
+
+  // A response for the client now goes to the peer it relayed through, and to no other.
+  const auto relayed(send_response(client));
+  EXPECT_TRUE(WaitFor([&] { return network.Received(RelayNetwork::kClientSide, relayed) == 1; },
+                      std::chrono::seconds(10)));
+  EXPECT_EQ(0U, network.Received(RelayNetwork::kOther, relayed));
+  EXPECT_EQ(0U, network.Received(RelayNetwork::kClientSide, unrelayed));
+  EXPECT_EQ(0U, network.Received(RelayNetwork::kOther, unrelayed));
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,195 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/response_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = TimingWheel::Clock;
+
+ResponseTable::Key RandomKey() {
+  return ResponseTable::Key(Address(RandomString(Address::kSize)), RandomUint32());
+}
+
+// Records every completion of one request's handler.
+struct Outcome {
+  Outcome() : calls(0), error(), response() {}
+  std::atomic<int> calls;
+  asio::error_code error;
+  SerialisedMessage response;
+};
+
+ResponseTable::Handler Record(Outcome& outcome) {
+  return [&outcome](asio::error_code error, SerialisedMessage response) {
+    outcome.error = error;
+    outcome.response = std::move(response);
+    ++outcome.calls;
+  };
+}
+
+}  // anonymous namespace
+
+TEST(ResponseTableTest, BEH_CompletesOnceAndTimesOut) {
+  const auto start(Clock::now());
+  TimingWheel wheel(std::chrono::milliseconds(100), start);
+  ResponseTable table(wheel);
+  Outcome answered, duplicate, unanswered;
+  const auto answered_key(RandomKey()), unanswered_key(RandomKey());
+  const SerialisedMessage response{1, 2, 3};
+
+  EXPECT_TRUE(table.Add(answered_key, Record(answered)));
+  EXPECT_TRUE(table.Add(unanswered_key, Record(unanswered), std::chrono::seconds(1)));
+  EXPECT_FALSE(table.Add(answered_key, Record(duplicate)));
+  EXPECT_EQ(1, duplicate.calls);
+  EXPECT_EQ(asio::error::already_started, duplicate.error);
+  EXPECT_EQ(2U, table.size());
+
+  // The first response completes the request, further copies from the group are ignored.
+  EXPECT_TRUE(table.Complete(answered_key, asio::error_code(), response));
+  EXPECT_FALSE(table.Complete(answered_key, asio::error_code(), response));
+  EXPECT_EQ(1, answered.calls);
+  EXPECT_FALSE(answered.error);
+  EXPECT_EQ(response, answered.response);
+
+  wheel.Advance(start + std::chrono::seconds(3));
+  EXPECT_EQ(1, unanswered.calls);
+  EXPECT_EQ(asio::error::timed_out, unanswered.error);
+  EXPECT_FALSE(table.Complete(unanswered_key, asio::error_code(), response));
+  EXPECT_EQ(1U, table.Completed());
+  EXPECT_EQ(1U, table.TimedOut());
+  EXPECT_EQ(0U, table.size());
+  EXPECT_EQ(0U, wheel.size());
+}
+
+TEST(ResponseTableTest, BEH_DestructionAbortsOutstanding) {
+  TimingWheel wheel;
+  Outcome outcome;
+  {
+    ResponseTable table(wheel);
+    EXPECT_TRUE(table.Add(RandomKey(), Record(outcome)));
+  }
+  EXPECT_EQ(1, outcome.calls);
+  EXPECT_EQ(asio::error::operation_aborted, outcome.error);
+  EXPECT_EQ(0U, wheel.size());
+}
+
+TEST(ResponseTableTest, BEH_StopAcceptingRefusesNewRequests) {
+  TimingWheel wheel;
+  ResponseTable table(wheel);
+  Outcome outstanding, refused, cancelled;
+  const auto outstanding_key(RandomKey()), cancelled_key(RandomKey());
+  EXPECT_TRUE(table.Add(outstanding_key, Record(outstanding)));
+  EXPECT_TRUE(table.Add(cancelled_key, Record(cancelled)));
+
+  table.StopAccepting(asio::error::shut_down);
+  EXPECT_FALSE(table.Add(RandomKey(), Record(refused)));
+  EXPECT_EQ(1, refused.calls);
+  EXPECT_EQ(asio::error::shut_down, refused.error);
+
+  // Requests already outstanding still complete normally, or with the error given on cancel.
+  EXPECT_TRUE(table.Complete(outstanding_key, asio::error_code(), SerialisedMessage()));
+  EXPECT_EQ(1, outstanding.calls);
+  EXPECT_FALSE(outstanding.error);
+  table.CancelAll(asio::error::shut_down);
+  EXPECT_EQ(1, cancelled.calls);
+  EXPECT_EQ(asio::error::shut_down, cancelled.error);
+  EXPECT_EQ(0U, table.size());
+}
+
+TEST(ResponseTableTest, FUNC_ConcurrentRequestsEachCompleteOnce) {
+  const size_t kThreads(4), kRequestsPerThread(5000);
+  const auto start(Clock::now());
+  TimingWheel wheel(std::chrono::milliseconds(100), start);
+  ResponseTable table(wheel);
+  std::vector<ResponseTable::Key> keys;
+  for (size_t i(0); i < kThreads * kRequestsPerThread; ++i)
+    keys.push_back(RandomKey());
+  std::vector<Outcome> outcomes(keys.size());
+
+  std::vector<std::thread> threads;
+  for (size_t t(0); t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i(t * kRequestsPerThread); i < (t + 1) * kRequestsPerThread; ++i)
+        EXPECT_TRUE(table.Add(keys[i], Record(outcomes[i])));
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  threads.clear();
+  EXPECT_EQ(keys.size(), table.size());
+
+  // Every fifth request goes unanswered; the rest are answered several times over (as each
+  // member of a group responds), in random order and from several threads at once.
+  std::vector<size_t> responses;
+  for (size_t i(0); i < keys.size(); ++i) {
+    if (i % 5 != 0)
+      responses.insert(std::end(responses), 1 + i % 3, i);
+  }
+  std::shuffle(std::begin(responses), std::end(responses), std::mt19937(RandomUint32()));
+  std::atomic<size_t> next(0);
+  for (size_t t(0); t < kThreads; ++t) {
+    threads.emplace_back([&] {
+      for (size_t i(next++); i < responses.size(); i = next++) {
+        const auto index(responses[i]);
+        table.Complete(keys[index], asio::error_code(),
+                       SerialisedMessage(1, static_cast<byte>(index)));
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  const size_t unanswered((keys.size() + 4) / 5);
+  EXPECT_EQ(keys.size() - unanswered, table.Completed());
+  EXPECT_EQ(unanswered, table.size());
+  wheel.Advance(start + 2 * ResponseTable::kDefaultTimeout);
+  EXPECT_EQ(unanswered, table.TimedOut());
+  EXPECT_EQ(0U, table.size());
+
+  for (size_t i(0); i < keys.size(); ++i) {
+    ASSERT_EQ(1, outcomes[i].calls) << i;
+    if (i % 5 == 0) {
+      EXPECT_EQ(asio::error::timed_out, outcomes[i].error);
+    } else {
+      EXPECT_FALSE(outcomes[i].error);
+      EXPECT_EQ(SerialisedMessage(1, static_cast<byte>(i)), outcomes[i].response);
+    }
+  }
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,404 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/sentinel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "asio/io_service.hpp"
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/timing_wheel.h"
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/messages.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+class SentinelTest : public testing::Test {
+ protected:
+  SentinelTest()
+      : io_service_(),
+        sentinel_(io_service_, 4),
+        group_address_(Address(RandomString(Address::kSize))),
+        members_() {
+    for (size_t i(0); i < GroupSize; ++i)
+      members_.emplace_back(passport::Anpmid());
+  }
+
+  MessageHeader Header(const passport::Pmid& member, MessageId message_id,
+                       const SerialisedMessage& body) {
+    return Header(member, message_id, body, member.private_key());
+  }
+
+  MessageHeader Header(const passport::Pmid& member, MessageId message_id,
+                       const SerialisedMessage& body, const asymm::PrivateKey& signing_key) {
+    return MessageHeader(
+        DestinationAddress(
+            std::make_pair(Destination(Address(RandomString(Address::kSize))), boost::none)),
+        SourceAddress(NodeAddress(Address(member.name()->string())), group_address_, boost::none),
+        message_id, Authority::nae_manager,
+        asymm::Sign(asymm::PlainText(std::string(std::begin(body), std::end(body))),
+                    signing_key));
+  }
+
+  // Each member answers from its own view of the group, in whatever order it learned of the
+  // others, but sorted by closeness to the group address as ConnectionManager::CloseGroupOf does.
+  SerialisedMessage GroupKeyResponse() const {
+    std::vector<size_t> view;
+    for (size_t i(0); i < members_.size(); ++i)
+      view.push_back(i);
+    std::shuffle(std::begin(view), std::end(view), std::mt19937(RandomUint32()));
+    std::sort(std::begin(view), std::end(view), [&](size_t lhs, size_t rhs) {
+      return Address::CloserToTarget(Address(members_[lhs].name()->string()),
+                                     Address(members_[rhs].name()->string()), group_address_.data);
+    });
+    std::vector<passport::PublicPmid> fobs;
+    for (const auto index : view)
+      fobs.emplace_back(members_[index]);
+    return Serialise(GetGroupKeyResponse(group_address_, std::move(fobs)));
+  }
+
+  // The sentinel only takes keys it asked for, which it does on first hearing from a group whose
+  // keys it doesn't hold.
+  void RequestGroupKeys() {
+    const auto body(Serialise(GetKey(NodeAddress(Address(RandomString(Address::kSize))))));
+    EXPECT_FALSE(
+        sentinel_.Add(Header(members_[0], RandomUint32(), body), MessageTypeTag::GetKey, body));
+  }
+
+  void LearnGroupKeys() {
+    RequestGroupKeys();
+    const MessageId message_id(RandomUint32());
+    for (size_t i(0); i < QuorumSize; ++i) {
+      const auto body(GroupKeyResponse());
+      EXPECT_FALSE(sentinel_.Add(Header(members_[i], message_id, body),
+                                 MessageTypeTag::GetGroupKeyResponse, body));
+    }
+    EXPECT_NE(0U, sentinel_.key_cache().GroupCount());
+  }
+
+  asio::io_service io_service_;
+  Sentinel sentinel_;
+  GroupAddress group_address_;
+  std::vector<passport::Pmid> members_;
+};
+
+}  // anonymous namespace
+
+TEST_F(SentinelTest, BEH_GroupMessageVerified) {
+  LearnGroupKeys();
+  const auto data(RandomString(1024));
+  const auto body(Serialise(PutData(DataTagValue::kImmutableDataValue,
+                                    SerialisedData(std::begin(data), std::end(data)))));
+  const MessageId message_id(RandomUint32());
+
+  for (size_t i(0); i < QuorumSize - 1; ++i) {
+    EXPECT_FALSE(
+        sentinel_.Add(Header(members_[i], message_id, body), MessageTypeTag::PutData, body));
+  }
+  auto result(sentinel_.Add(Header(members_[QuorumSize - 1], message_id, body),
+                            MessageTypeTag::PutData, body));
+  ASSERT_TRUE(static_cast<bool>(result));
+  ASSERT_EQ(std::future_status::ready, result->wait_for(std::chrono::seconds(10)));
+  const auto verified(result->get());
+  EXPECT_EQ(MessageTypeTag::PutData, std::get<1>(verified));
+  EXPECT_EQ(body, std::get<2>(verified));
+  EXPECT_EQ(group_address_, *std::get<0>(verified).group_address);
+
+  // Surplus parts don't start another verification
+  EXPECT_FALSE(sentinel_.Add(Header(members_[QuorumSize], message_id, body),
+                             MessageTypeTag::PutData, body));
+}
+
+TEST_F(SentinelTest, BEH_ForgedGroupMessageRejected) {
+  LearnGroupKeys();
+  const auto body(Serialise(FindGroup(NodeAddress(Address(RandomString(Address::kSize))),
+                                      Address(RandomString(Address::kSize)))));
+  const MessageId message_id(RandomUint32());
+  const passport::Pmid impostor{passport::Anpmid()};
+
+  boost::optional<std::future<Sentinel::ResultType>> result;
+  for (size_t i(0); i < QuorumSize; ++i) {
+    // The first member's part is signed with someone else's key
+    const auto& signing_key(i == 0 ? impostor.private_key() : members_[i].private_key());
+    result = sentinel_.Add(Header(members_[i], message_id, body, signing_key),
+                           MessageTypeTag::FindGroup, body);
+  }
+  ASSERT_TRUE(static_cast<bool>(result));
+  EXPECT_THROW(result->get(), maidsafe_error);
+}
+
+TEST_F(SentinelTest, BEH_DisagreeingGroupKeysNotLearned) {
+  RequestGroupKeys();
+  // Members answering with their own close groups rather than the group at the address disagree,
+  // so no quorum of identical responses is ever reached.
+  const MessageId message_id(RandomUint32());
+  for (size_t i(0); i < GroupSize; ++i) {
+    std::vector<passport::PublicPmid> fobs;
+    for (size_t j(0); j < GroupSize; ++j) {
+      if (j != (i + 1) % GroupSize)
+        fobs.emplace_back(members_[j]);
+    }
+    const auto body(Serialise(GetGroupKeyResponse(group_address_, std::move(fobs))));
+    EXPECT_FALSE(sentinel_.Add(Header(members_[i], message_id, body),
+                               MessageTypeTag::GetGroupKeyResponse, body));
+  }
+  EXPECT_EQ(0U, sentinel_.key_cache().GroupCount());
+}
+
+TEST_F(SentinelTest, BEH_UnrequestedGroupKeysIgnored) {
+  const MessageId message_id(RandomUint32());
+  for (size_t i(0); i < QuorumSize; ++i) {
+    const auto body(GroupKeyResponse());
+    EXPECT_FALSE(sentinel_.Add(Header(members_[i], message_id, body),
+                               MessageTypeTag::GetGroupKeyResponse, body));
+  }
+  EXPECT_EQ(0U, sentinel_.key_cache().GroupCount());
+
+  LearnGroupKeys();
+  EXPECT_EQ(1U, sentinel_.key_cache().GroupCount());
+}
+
+TEST_F(SentinelTest, BEH_ForgedGroupKeysRejected) {
+  // As RoutingNode does with the nodes it knows, reject a listing which leaves out a member
+  // closer to the group than the furthest listed.
+  sentinel_.SetCheckCloseGroup([&](const GroupAddress& group, const std::vector<Address>& listed) {
+    EXPECT_EQ(group_address_, group);
+    return std::none_of(std::begin(members_), std::end(members_), [&](const passport::Pmid& pmid) {
+      const Address member(pmid.name()->string());
+      return Address::CloserToTarget(member, listed.back(), group.data) &&
+             std::find(std::begin(listed), std::end(listed), member) == std::end(listed);
+    });
+  });
+  RequestGroupKeys();
+  const passport::Pmid impostor{passport::Anpmid()};
+
+  // One peer sends a quorum of copies of the real response under the members' addresses, but
+  // can only sign them with its own key.
+  const MessageId copied_id(RandomUint32());
+  const auto copied(GroupKeyResponse());
+  for (size_t i(0); i < QuorumSize; ++i) {
+    EXPECT_FALSE(sentinel_.Add(Header(members_[i], copied_id, copied, impostor.private_key()),
+                               MessageTypeTag::GetGroupKeyResponse, copied));
+  }
+  EXPECT_EQ(0U, sentinel_.key_cache().GroupCount());
+
+  // Impostors list themselves as the group and sign with their own keys, but aren't the nodes
+  // closest to it.
+  std::vector<passport::Pmid> impostors;
+  std::vector<size_t> order;
+  for (size_t i(0); i < QuorumSize; ++i) {
+    impostors.emplace_back(passport::Anpmid());
+    order.push_back(i);
+  }
+  std::sort(std::begin(order), std::end(order), [&](size_t lhs, size_t rhs) {
+    return Address::CloserToTarget(Address(impostors[lhs].name()->string()),
+                                   Address(impostors[rhs].name()->string()), group_address_.data);
+  });
+  std::vector<passport::PublicPmid> fobs;
+  for (const auto index : order)
+    fobs.emplace_back(impostors[index]);
+  const MessageId listed_id(RandomUint32());
+  const auto listed(Serialise(GetGroupKeyResponse(group_address_, std::move(fobs))));
+  for (const auto& pmid : impostors) {
+    EXPECT_FALSE(sentinel_.Add(Header(pmid, listed_id, listed),
+                               MessageTypeTag::GetGroupKeyResponse, listed));
+  }
+  EXPECT_EQ(0U, sentinel_.key_cache().GroupCount());
+
+  // The real group is still learned from.
+  LearnGroupKeys();
+  EXPECT_EQ(1U, sentinel_.key_cache().GroupCount());
+}
+
+TEST_F(SentinelTest, BEH_ForgedNodeKeyNotCached) {
+  const NodeAddress node(Address(members_[0].name()->string()));
+  const auto body(Serialise(GetKey(NodeAddress(Address(RandomString(Address::kSize))))));
+  auto parked(sentinel_.Add(
+      MessageHeader(DestinationAddress(std::make_pair(
+                        Destination(Address(RandomString(Address::kSize))), boost::none)),
+                    SourceAddress(node, boost::none, boost::none), RandomUint32(),
+                    Authority::node,
+                    asymm::Sign(asymm::PlainText(std::string(std::begin(body), std::end(body))),
+                                members_[0].private_key())),
+      MessageTypeTag::GetKey, body));
+  ASSERT_TRUE(static_cast<bool>(parked));
+
+  // The node's group answers, each part signed by its sender.
+  const auto answer([&](const passport::PublicPmid& fob) {
+    const auto response(Serialise(GetKeyResponse(node, fob)));
+    const MessageId message_id(RandomUint32());
+    for (size_t i(1); i <= QuorumSize; ++i) {
+      EXPECT_FALSE(sentinel_.Add(
+          MessageHeader(DestinationAddress(std::make_pair(
+                            Destination(Address(RandomString(Address::kSize))), boost::none)),
+                        SourceAddress(NodeAddress(Address(members_[i].name()->string())),
+                                      GroupAddress(node.data), boost::none),
+                        message_id, Authority::nae_manager,
+                        asymm::Sign(asymm::PlainText(std::string(std::begin(response),
+                                                                 std::end(response))),
+                                    members_[i].private_key())),
+          MessageTypeTag::GetKeyResponse, response));
+    }
+  });
+
+  // A fob named for another node can't hold this node's key, however many agree on it.
+  answer(passport::PublicPmid(passport::Pmid(passport::Anpmid())));
+  EXPECT_EQ(0U, sentinel_.key_cache().NodeCount());
+  EXPECT_NE(std::future_status::ready, parked->wait_for(std::chrono::milliseconds(0)));
+
+  answer(passport::PublicPmid(members_[0]));
+  EXPECT_EQ(1U, sentinel_.key_cache().NodeCount());
+  ASSERT_EQ(std::future_status::ready, parked->wait_for(std::chrono::seconds(10)));
+  EXPECT_EQ(MessageTypeTag::GetKey, std::get<1>(parked->get()));
+}
+
+TEST_F(SentinelTest, BEH_KeyRequestsCoalesced) {
+  size_t group_key_requests(0);
+  sentinel_.SetSendGetGroupKey([&](GroupAddress group) {
+    EXPECT_EQ(group_address_, group);
+    ++group_key_requests;
+  });
+
+  // Several messages from the same group arrive before its keys are known
+  const size_t message_count(3);
+  std::vector<std::future<Sentinel::ResultType>> parked;
+  for (size_t message(0); message < message_count; ++message) {
+    const auto body(Serialise(GetKey(NodeAddress(Address(RandomString(Address::kSize))))));
+    const MessageId message_id(RandomUint32());
+    for (size_t i(0); i < QuorumSize; ++i) {
+      auto result(
+          sentinel_.Add(Header(members_[i], message_id, body), MessageTypeTag::GetKey, body));
+      if (i < QuorumSize - 1) {
+        EXPECT_FALSE(result);
+      } else {
+        ASSERT_TRUE(static_cast<bool>(result));
+        parked.push_back(std::move(*result));
+      }
+    }
+  }
+  EXPECT_EQ(1U, group_key_requests);
+  EXPECT_EQ(1U, sentinel_.KeyRequestsSent());
+  // Only the later messages avoided sending a request of their own.
+  EXPECT_EQ(message_count - 1, sentinel_.KeyRequestsSaved());
+  for (auto& result : parked)
+    EXPECT_NE(std::future_status::ready, result.wait_for(std::chrono::milliseconds(0)));
+
+  // All parked messages are released once the keys arrive
+  LearnGroupKeys();
+  for (auto& result : parked) {
+    ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds(10)));
+    EXPECT_EQ(MessageTypeTag::GetKey, std::get<1>(result.get()));
+  }
+}
+
+TEST_F(SentinelTest, BEH_KeyRequestTimesOut) {
+  const std::chrono::steady_clock::duration timeout(std::chrono::seconds(30));
+  const auto start(TimingWheel::Clock::now());
+  TimingWheel wheel(TimingWheel::kDefaultTick, start);
+  Sentinel sentinel(io_service_, 1, timeout, &wheel);
+  size_t node_key_requests(0);
+  sentinel.SetSendGetKey([&](NodeAddress) { ++node_key_requests; });
+  const auto body(Serialise(GetKey(NodeAddress(Address(RandomString(Address::kSize))))));
+  const auto direct_header = [&] {
+    return MessageHeader(
+        DestinationAddress(
+            std::make_pair(Destination(Address(RandomString(Address::kSize))), boost::none)),
+        SourceAddress(NodeAddress(Address(members_[0].name()->string())), boost::none,
+                      boost::none),
+        RandomUint32(), Authority::node,
+        asymm::Sign(asymm::PlainText(std::string(std::begin(body), std::end(body))),
+                    members_[0].private_key()));
+  };
+
+  auto first(sentinel.Add(direct_header(), MessageTypeTag::GetKey, body));
+  auto second(sentinel.Add(direct_header(), MessageTypeTag::GetKey, body));
+  ASSERT_TRUE(first && second);
+  EXPECT_EQ(1U, node_key_requests);
+  EXPECT_EQ(1U, sentinel.KeyRequestsSaved());
+
+  // Nothing fails before the deadline
+  wheel.Advance(start + timeout / 2);
+  EXPECT_NE(std::future_status::ready, first->wait_for(std::chrono::milliseconds(0)));
+  EXPECT_NE(std::future_status::ready, second->wait_for(std::chrono::milliseconds(0)));
+
+  // The deadline fails the parked checks without waiting for another Add, and the next check
+  // sends a fresh request
+  wheel.Advance(TimingWheel::Clock::now() + timeout + wheel.Tick());
+  ASSERT_EQ(std::future_status::ready, first->wait_for(std::chrono::milliseconds(0)));
+  EXPECT_THROW(first->get(), maidsafe_error);
+  EXPECT_THROW(second->get(), maidsafe_error);
+  auto third(sentinel.Add(direct_header(), MessageTypeTag::GetKey, body));
+  EXPECT_TRUE(static_cast<bool>(third));
+  EXPECT_EQ(2U, node_key_requests);
+}
+
+TEST_F(SentinelTest, BEH_CachedKeysAvoidRoundTrip) {
+  size_t group_key_requests(0);
+  sentinel_.SetSendGetGroupKey([&](GroupAddress) { ++group_key_requests; });
+  LearnGroupKeys();
+
+  const auto send_message = [&]() -> std::future<Sentinel::ResultType> {
+    const auto body(Serialise(GetKey(NodeAddress(Address(RandomString(Address::kSize))))));
+    const MessageId message_id(RandomUint32());
+    boost::optional<std::future<Sentinel::ResultType>> result;
+    for (size_t i(0); i < QuorumSize; ++i) {
+      result =
+          sentinel_.Add(Header(members_[i], message_id, body), MessageTypeTag::GetKey, body);
+    }
+    return std::move(*result);
+  };
+
+  // Only the request the keys were learned from is sent.
+  for (int i(0); i < 3; ++i)
+    EXPECT_EQ(MessageTypeTag::GetKey, std::get<1>(send_message().get()));
+  EXPECT_EQ(1U, group_key_requests);
+  EXPECT_GE(sentinel_.key_cache().Hits(), 3U * QuorumSize);
+
+  // A member leaving invalidates the group's keys, so they're fetched again
+  sentinel_.HandleChurn(Address(members_.front().name()->string()));
+  EXPECT_EQ(1U, sentinel_.key_cache().Invalidations());
+  auto parked(send_message());
+  EXPECT_EQ(2U, group_key_requests);
+  LearnGroupKeys();
+  EXPECT_EQ(MessageTypeTag::GetKey, std::get<1>(parked.get()));
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,114 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/sharded_accumulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/types.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(ShardedAccumulatorTest, BEH_QuorumReportedOnce) {
+  ShardedAccumulator<int, uint32_t> accumulator(std::chrono::minutes(1), 2U, 4);
+  EXPECT_EQ(4U, accumulator.ShardCount());
+  const Address first(RandomString(Address::kSize)), second(RandomString(Address::kSize));
+  EXPECT_FALSE(!!accumulator.Add(1, 1U, first));
+  EXPECT_FALSE(accumulator.CheckQuorumReached(1));
+  // A repeat from the same sender doesn't count
+  EXPECT_FALSE(!!accumulator.Add(1, 1U, first));
+  const auto parts(accumulator.Add(1, 2U, second));
+  ASSERT_TRUE(!!parts);
+  EXPECT_EQ(1, parts->first);
+  EXPECT_EQ(2U, parts->second.size());
+  EXPECT_TRUE(accumulator.CheckQuorumReached(1));
+  // Neither later parts nor repeats report it again
+  EXPECT_FALSE(!!accumulator.Add(1, 3U, Address(RandomString(Address::kSize))));
+  EXPECT_FALSE(!!accumulator.Add(1, 2U, second));
+  EXPECT_EQ(3U, accumulator.GetAll(1)->second.size());
+  EXPECT_TRUE(accumulator.HaveName(1));
+  EXPECT_FALSE(accumulator.HaveName(2));
+  EXPECT_EQ(1U, accumulator.size());
+}
+
+TEST(ShardedAccumulatorTest, FUNC_ConcurrentAddsReachQuorumExactlyOnce) {
+  const size_t kNames(2000);
+  const size_t kThreads(std::max(4U, std::thread::hardware_concurrency()));
+  ShardedAccumulator<uint32_t, uint32_t> accumulator(std::chrono::minutes(1), QuorumSize);
+
+  std::vector<Address> senders;
+  for (size_t i(0); i < GroupSize; ++i)
+    senders.emplace_back(RandomString(Address::kSize));
+  // Every (name, sender) part, sent twice to also exercise repeats, in a random order which the
+  // threads share out.
+  std::vector<std::pair<uint32_t, uint32_t>> parts;
+  for (uint32_t name(0); name < kNames; ++name) {
+    for (uint32_t sender(0); sender < GroupSize; ++sender) {
+      parts.emplace_back(name, sender);
+      parts.emplace_back(name, sender);
+    }
+  }
+  std::shuffle(std::begin(parts), std::end(parts), std::mt19937(RandomUint32()));
+
+  std::vector<std::atomic<uint32_t>> quorums(kNames);
+  for (auto& quorum : quorums)
+    quorum = 0;
+  std::atomic<size_t> wrong_size(0);
+  std::vector<std::thread> threads;
+  for (size_t t(0); t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i(t); i < parts.size(); i += kThreads) {
+        const auto result(
+            accumulator.Add(parts[i].first, parts[i].second, senders[parts[i].second]));
+        if (!result)
+          continue;
+        ++quorums[result->first];
+        if (result->second.size() != QuorumSize)
+          ++wrong_size;
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(0U, wrong_size);
+  for (uint32_t name(0); name < kNames; ++name) {
+    EXPECT_EQ(1U, quorums[name]) << "name " << name;
+    EXPECT_EQ(GroupSize, accumulator.GetAll(name)->second.size());
+  }
+  EXPECT_EQ(kNames, accumulator.size());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
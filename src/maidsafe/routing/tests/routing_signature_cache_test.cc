@@ -0,0 +1,126 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signature_cache.h"
+
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/signature_verifier.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+SerialisedMessage RandomMessage() {
+  const auto message(RandomString(256));
+  return SerialisedMessage(std::begin(message), std::end(message));
+}
+
+asymm::Signature SignMessage(const SerialisedMessage& message,
+                             const asymm::PrivateKey& private_key) {
+  return asymm::Sign(asymm::PlainText(std::string(std::begin(message), std::end(message))),
+                     private_key);
+}
+
+}  // anonymous namespace
+
+TEST(SignatureCacheTest, BEH_ForgedVariantsNeverHit) {
+  SignatureCache cache(100);
+  const auto keys(asymm::GenerateKeyPair());
+  const auto other_keys(asymm::GenerateKeyPair());
+  const auto message(RandomMessage());
+  const auto signature(SignMessage(message, keys.private_key));
+  cache.Add(SignatureCache::MakeKey(keys.public_key, message, signature), true);
+
+  auto genuine(cache.Get(SignatureCache::MakeKey(keys.public_key, message, signature)));
+  ASSERT_TRUE(static_cast<bool>(genuine));
+  EXPECT_TRUE(*genuine);
+
+  // Tampered message (a single flipped bit)
+  auto tampered(message);
+  tampered.back() ^= 1;
+  EXPECT_FALSE(cache.Get(SignatureCache::MakeKey(keys.public_key, tampered, signature)));
+  // Signature from another key over the same message
+  EXPECT_FALSE(cache.Get(SignatureCache::MakeKey(
+      keys.public_key, message, SignMessage(message, other_keys.private_key))));
+  // Genuine signature and message presented with another key
+  EXPECT_FALSE(cache.Get(SignatureCache::MakeKey(other_keys.public_key, message, signature)));
+  // Truncated signature
+  const auto signature_string(signature.string());
+  EXPECT_FALSE(cache.Get(SignatureCache::MakeKey(
+      keys.public_key, message,
+      asymm::Signature(signature_string.substr(0, signature_string.size() - 1)))));
+
+  EXPECT_EQ(1U, cache.Hits());
+  EXPECT_EQ(4U, cache.Misses());
+  EXPECT_DOUBLE_EQ(0.2, cache.HitRate());
+}
+
+TEST(SignatureCacheTest, BEH_Bounded) {
+  const size_t capacity(10);
+  SignatureCache cache(capacity);
+  const auto keys(asymm::GenerateKeyPair());
+  const asymm::Signature signature(SignMessage(RandomMessage(), keys.private_key));
+  std::vector<SignatureCache::Key> cache_keys;
+  for (size_t i(0); i < capacity * 2; ++i) {
+    cache_keys.push_back(SignatureCache::MakeKey(keys.public_key, RandomMessage(), signature));
+    cache.Add(cache_keys.back(), false);
+    EXPECT_LE(cache.size(), capacity);
+  }
+  // Oldest entries evicted, newest retained
+  EXPECT_FALSE(cache.Get(cache_keys.front()));
+  auto newest(cache.Get(cache_keys.back()));
+  ASSERT_TRUE(static_cast<bool>(newest));
+  EXPECT_FALSE(*newest);
+}
+
+TEST(SignatureCacheTest, BEH_VerifierSkipsRepeatedChecks) {
+  SignatureVerifier verifier(2);
+  const auto keys(asymm::GenerateKeyPair());
+  auto message(std::make_shared<const SerialisedMessage>(RandomMessage()));
+  const auto signature(SignMessage(*message, keys.private_key));
+  const std::vector<SignatureVerifier::Item> items(
+      1, SignatureVerifier::Item{keys.public_key, message, signature});
+
+  for (int i(0); i < 3; ++i) {
+    std::promise<bool> promise;
+    verifier.VerifyQuorum(items, 1, [&promise](bool quorum_reached, std::vector<size_t>) {
+      promise.set_value(quorum_reached);
+    });
+    EXPECT_TRUE(promise.get_future().get());
+  }
+  EXPECT_EQ(1U, verifier.VerificationsPerformed());
+  EXPECT_EQ(2U, verifier.Cache().Hits());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,115 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signature_verifier.h"
+
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+struct Outcome {
+  bool quorum_reached;
+  std::vector<size_t> verified;
+};
+
+std::vector<SignatureVerifier::Item> SignedItems(size_t count) {
+  const auto message_string(RandomString(1024));
+  auto message(std::make_shared<const SerialisedMessage>(std::begin(message_string),
+                                                         std::end(message_string)));
+  std::vector<SignatureVerifier::Item> items;
+  for (size_t i(0); i < count; ++i) {
+    const auto keys(asymm::GenerateKeyPair());
+    items.push_back(SignatureVerifier::Item{
+        keys.public_key, message,
+        asymm::Sign(asymm::PlainText(message_string), keys.private_key)});
+  }
+  return items;
+}
+
+void Forge(SignatureVerifier::Item& item) { item.public_key = asymm::GenerateKeyPair().public_key; }
+
+Outcome Verify(SignatureVerifier& verifier, std::vector<SignatureVerifier::Item> items,
+               size_t quorum) {
+  auto promise(std::make_shared<std::promise<Outcome>>());
+  auto future(promise->get_future());
+  verifier.VerifyQuorum(std::move(items), quorum,
+                        [promise](bool quorum_reached, std::vector<size_t> verified) {
+    promise->set_value(Outcome{quorum_reached, std::move(verified)});
+  });
+  return future.get();
+}
+
+}  // anonymous namespace
+
+TEST(SignatureVerifierTest, BEH_QuorumReached) {
+  SignatureVerifier verifier(4);
+  auto items(SignedItems(GroupSize));
+  // Forge as many as can be tolerated
+  for (size_t i(0); i < GroupSize - QuorumSize; ++i)
+    Forge(items[i]);
+
+  const auto outcome(Verify(verifier, std::move(items), QuorumSize));
+  EXPECT_TRUE(outcome.quorum_reached);
+  ASSERT_EQ(QuorumSize, outcome.verified.size());
+  for (const auto index : outcome.verified)
+    EXPECT_GE(index, GroupSize - QuorumSize);
+}
+
+TEST(SignatureVerifierTest, BEH_QuorumImpossible) {
+  SignatureVerifier verifier(4);
+  auto items(SignedItems(GroupSize));
+  for (size_t i(0); i <= GroupSize - QuorumSize; ++i)
+    Forge(items[i]);
+
+  const auto outcome(Verify(verifier, std::move(items), QuorumSize));
+  EXPECT_FALSE(outcome.quorum_reached);
+  EXPECT_LT(outcome.verified.size(), QuorumSize);
+
+  EXPECT_FALSE(Verify(verifier, SignedItems(QuorumSize - 1), QuorumSize).quorum_reached);
+}
+
+TEST(SignatureVerifierTest, BEH_StopsOnceDecided) {
+  // With a single worker the checks run in order, so all checks after the quorum are skipped.
+  SignatureVerifier verifier(1);
+  const auto outcome(Verify(verifier, SignedItems(GroupSize), QuorumSize));
+  EXPECT_TRUE(outcome.quorum_reached);
+  // The skipped checks run after the handler has been called, so wait for them to drain.
+  Verify(verifier, SignedItems(1), 1);
+  EXPECT_EQ(QuorumSize + 1, verifier.VerificationsPerformed());
+  EXPECT_EQ(GroupSize - QuorumSize, verifier.VerificationsSkipped());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
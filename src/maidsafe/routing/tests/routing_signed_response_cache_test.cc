@@ -0,0 +1,105 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signed_response_cache.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/routing/message_header.h"
+#include "maidsafe/routing/outbound_message.h"
+#include "maidsafe/routing/messages/find_group_response.h"
+#include "maidsafe/routing/tests/utils/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+Address RandomAddress() { return Address(RandomString(Address::kSize)); }
+
+}  // anonymous namespace
+
+TEST(SignedResponseCacheTest, BEH_CachedPerTargetUntilGroupChanges) {
+  const passport::Pmid our_fob{passport::Anpmid()};
+  SignedResponseCache cache(10);
+  size_t built(0);
+  const auto make = [&] {
+    ++built;
+    auto body(Serialise(FindGroupResponse(
+        RandomAddress(), std::vector<passport::PublicPmid>(1, passport::PublicPmid(our_fob)))));
+    auto signature(asymm::Sign(body, our_fob.private_key()));
+    return SignedResponseCache::SignedBody{
+        std::make_shared<const SerialisedData>(std::move(body)), std::move(signature)};
+  };
+  const auto target(RandomAddress());
+  const auto other_target(RandomAddress());
+
+  const auto first(cache.Get(target, 0, make));
+  EXPECT_EQ(first.body, cache.Get(target, 0, make).body);
+  EXPECT_EQ(1U, built);
+  cache.Get(other_target, 0, make);
+  EXPECT_EQ(2U, built);
+  EXPECT_EQ(2U, cache.size());
+
+  // Close group changed: everything is rebuilt
+  const auto second(cache.Get(target, 1, make));
+  EXPECT_EQ(3U, built);
+  EXPECT_NE(first.body, second.body);
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_EQ(1U, cache.Hits());
+  EXPECT_EQ(3U, cache.Misses());
+}
+
+TEST(SignedResponseCacheTest, BEH_Bounded) {
+  const size_t capacity(5);
+  SignedResponseCache cache(capacity);
+  const auto make = [] {
+    return SignedResponseCache::SignedBody{std::make_shared<const SerialisedData>(),
+                                           asymm::Signature(RandomString(256))};
+  };
+  for (size_t i(0); i < capacity * 3; ++i) {
+    cache.Get(RandomAddress(), 0, make);
+    EXPECT_LE(cache.size(), capacity);
+  }
+}
+
+TEST(SignedResponseCacheTest, BEH_PreSerialisedBodyMatchesWholeMessage) {
+  const auto header(GetRandomMessageHeader());
+  const FindGroupResponse response(RandomAddress(),
+                                   std::vector<passport::PublicPmid>(3, PublicFob()));
+  const auto body(Serialise(response));
+  EXPECT_EQ(Serialise(header, MessageTypeTag::FindGroupResponse, response),
+            OutboundMessage(header, MessageTypeTag::FindGroupResponse, body).Serialised());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,237 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/swarm_fanout.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+Address RandomAddress() { return Address(RandomString(Address::kSize)); }
+
+std::vector<Address> ClosestFirst(std::vector<Address> addresses, const Address& target) {
+  std::sort(std::begin(addresses), std::end(addresses),
+            [&target](const Address& lhs, const Address& rhs) {
+              return Address::CloserToTarget(lhs, rhs, target);
+            });
+  return addresses;
+}
+
+// Records |count| messages for |destination|, each preceded by |duplicates| further copies of an
+// earlier message, so that a sample of |count| messages sees |duplicates| + 1 copies each.
+void Receive(SwarmFanout& fanout, const Address& destination, size_t count, size_t duplicates) {
+  const std::vector<Address> targets(1, RandomAddress());
+  for (size_t i(0); i < count; ++i) {
+    for (size_t j(0); j < duplicates; ++j)
+      fanout.Duplicate(destination);
+    fanout.Received(destination, targets);
+  }
+}
+
+// Every node knows every other and, as ConnectionManager::GetTarget does for a close group, is
+// given the GroupSize peers closest to a message's destination as targets.  Each group message
+// starts at a random node and is swarmed on by every node receiving its first copy.  Sends are
+// lost at random.
+class Simulation {
+ public:
+  struct Result {
+    Result() : messages(0), sends(0), delivered(0) {}
+    uint64_t messages, sends, delivered;
+  };
+
+  Simulation(size_t node_count, SwarmOptions options, uint32_t loss_per_million)
+      : loss_per_million_(loss_per_million), ids_(), nodes_(), indices_() {
+    for (size_t i(0); i < node_count; ++i) {
+      ids_.push_back(RandomAddress());
+      nodes_.emplace_back(new SwarmFanout(ids_.back(), options));
+      indices_.insert(std::make_pair(ids_.back(), i));
+    }
+  }
+
+  void Send(Result& result) {
+    const auto destination(RandomAddress());
+    const auto ranked(ClosestFirst(ids_, destination));
+    std::vector<bool> seen(nodes_.size(), false);
+    std::deque<size_t> arrivals(1, RandomUint32() % nodes_.size());
+    while (!arrivals.empty()) {
+      const auto node(arrivals.front());
+      arrivals.pop_front();
+      if (seen[node]) {
+        nodes_[node]->Duplicate(destination);
+        continue;
+      }
+      seen[node] = true;
+      std::vector<Address> targets;
+      for (size_t i(0); i < ranked.size() && targets.size() < GroupSize; ++i) {
+        if (ranked[i] != ids_[node])
+          targets.push_back(ranked[i]);
+      }
+      for (const auto& target : nodes_[node]->Received(destination, targets)) {
+        ++result.sends;
+        if (RandomUint32() % 1000000 >= loss_per_million_)
+          arrivals.push_back(indices_.at(target));
+      }
+    }
+    ++result.messages;
+    for (size_t i(0); i < GroupSize; ++i)
+      result.delivered += seen[indices_.at(ranked[i])] ? 1 : 0;
+  }
+
+ private:
+  const uint32_t loss_per_million_;
+  std::vector<Address> ids_;
+  std::vector<std::unique_ptr<SwarmFanout>> nodes_;
+  std::map<Address, size_t> indices_;
+};
+
+}  // anonymous namespace
+
+TEST(SwarmFanoutTest, BEH_InvalidOptions) {
+  SwarmOptions options;
+  options.min_fanout = 0;
+  EXPECT_THROW(SwarmFanout(RandomAddress(), options), maidsafe_error);
+  options = SwarmOptions();
+  options.min_fanout = options.max_fanout + 1;
+  EXPECT_THROW(SwarmFanout(RandomAddress(), options), maidsafe_error);
+  options = SwarmOptions();
+  options.sample_size = 0;
+  EXPECT_THROW(SwarmFanout(RandomAddress(), options), maidsafe_error);
+  options = SwarmOptions();
+  options.target_copies = 0.5;
+  EXPECT_THROW(SwarmFanout(RandomAddress(), options), maidsafe_error);
+}
+
+TEST(SwarmFanoutTest, BEH_SelectsTargetsRankedAfterUs) {
+  SwarmOptions options;
+  options.min_fanout = 1;
+  options.max_fanout = 3;
+  const auto our_id(RandomAddress());
+  SwarmFanout fanout(our_id, options);
+  const auto destination(RandomAddress());
+  std::vector<Address> targets;
+  for (size_t i(0); i < 8; ++i)
+    targets.push_back(RandomAddress());
+  targets = ClosestFirst(targets, destination);
+
+  const auto position(static_cast<size_t>(std::count_if(
+      std::begin(targets), std::end(targets), [&](const Address& target) {
+        return Address::CloserToTarget(target, our_id, destination);
+      })));
+  const auto selected(fanout.Received(destination, targets));
+  ASSERT_EQ(3U, selected.size());
+  for (size_t i(0); i < selected.size(); ++i)
+    EXPECT_EQ(targets[(position + i) % targets.size()], selected[i]);
+
+  // All targets are used when there are no more than the fan-out.
+  targets.resize(2);
+  EXPECT_EQ(targets, fanout.Received(destination, targets));
+}
+
+TEST(SwarmFanoutTest, BEH_FanoutFollowsCopiesReceived) {
+  SwarmOptions options;
+  options.min_fanout = 1;
+  options.max_fanout = 8;
+  options.sample_size = 4;
+  const auto our_id(RandomAddress());
+  SwarmFanout fanout(our_id, options);
+  const auto destination(RandomAddress());
+  EXPECT_EQ(8U, fanout.Fanout(destination));
+
+  // Nine copies of each message: scaled down to 8 * 2 / 9, rounded up.
+  Receive(fanout, destination, options.sample_size, 8);
+  EXPECT_EQ(2U, fanout.Fanout(destination));
+  // Destinations in other ranges are unaffected.
+  Address other_range(destination);
+  do {
+    other_range = RandomAddress();
+  } while (our_id.CommonLeadingBits(other_range) == our_id.CommonLeadingBits(destination));
+  EXPECT_EQ(8U, fanout.Fanout(other_range));
+
+  // Within half a copy of the target the fan-out is left alone.
+  Receive(fanout, destination, options.sample_size, 1);
+  EXPECT_EQ(2U, fanout.Fanout(destination));
+
+  // Single copies, e.g. after losses: scaled back up.
+  Receive(fanout, destination, options.sample_size, 0);
+  EXPECT_EQ(4U, fanout.Fanout(destination));
+
+  // Never below min_fanout.
+  Receive(fanout, destination, options.sample_size, 1000);
+  EXPECT_EQ(1U, fanout.Fanout(destination));
+}
+
+TEST(SwarmFanoutTest, FUNC_SimulatedGroupMessageCount) {
+  const size_t kNodes(200), kWarmUpMessages(1000), kMessages(2000);
+  const uint32_t kLossPerMillion(10000);  // 1%
+
+  SwarmOptions full;
+  full.min_fanout = full.max_fanout;
+  SwarmOptions adaptive;
+  adaptive.sample_size = 8;
+
+  Simulation::Result results[2];
+  const SwarmOptions* modes[2] = {&full, &adaptive};
+  for (size_t mode(0); mode < 2; ++mode) {
+    Simulation simulation(kNodes, *modes[mode], kLossPerMillion);
+    Simulation::Result warm_up;
+    for (size_t i(0); i < kWarmUpMessages; ++i)
+      simulation.Send(warm_up);
+    for (size_t i(0); i < kMessages; ++i)
+      simulation.Send(results[mode]);
+  }
+
+  const auto report([](const char* mode, const Simulation::Result& result) {
+    std::cout << "  " << mode << static_cast<double>(result.sends) / result.messages
+              << " sends per message, "
+              << 100.0 * result.delivered / (result.messages * GroupSize)
+              << "% of group members reached\n";
+  });
+  std::cout << kNodes << " nodes, group size " << GroupSize << ", " << kLossPerMillion / 10000.0
+            << "% loss, " << kMessages << " group messages\n";
+  report("full swarm:     ", results[0]);
+  report("adaptive swarm: ", results[1]);
+  std::cout << "  message count reduced by "
+            << 100.0 * (1.0 - static_cast<double>(results[1].sends) / results[0].sends) << "%\n";
+
+  EXPECT_LT(results[1].sends * 4, results[0].sends);
+  // Every group member must still get every message.
+  EXPECT_EQ(results[0].messages * GroupSize, results[0].delivered);
+  EXPECT_EQ(results[1].messages * GroupSize, results[1].delivered);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,138 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/timing_wheel.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "boost/asio/io_service.hpp"
+#include "boost/asio/steady_timer.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = TimingWheel::Clock;
+
+const Clock::duration kTick(std::chrono::milliseconds(1));
+
+}  // anonymous namespace
+
+TEST(TimingWheelTest, BEH_FiresOnTickNeverEarly) {
+  const auto start(Clock::now());
+  TimingWheel wheel(kTick, start);
+  // Delays covering every wheel, including beyond the outermost one.
+  const std::vector<int64_t> delays{1, 2, 63, 64, 65, 4095, 4096, 4097, 262143, 262144,
+                                    16777215, 16777216, 16777217, 17000000};
+  std::vector<int64_t> fired(delays.size(), -1);
+  int64_t now(0);
+  for (size_t i(0); i < delays.size(); ++i)
+    wheel.Schedule(start + delays[i] * kTick, [&fired, &now, i] { fired[i] = now; });
+  EXPECT_EQ(delays.size(), wheel.size());
+
+  // Advance in uneven steps; every timer must fire at the first Advance at or after its expiry.
+  while (wheel.size() != 0) {
+    const auto previous(now);
+    now += 1 + static_cast<int64_t>(RandomUint32() % 100000);
+    wheel.Advance(start + now * kTick);
+    for (size_t i(0); i < delays.size(); ++i) {
+      if (delays[i] > previous && delays[i] <= now) {
+        EXPECT_EQ(now, fired[i]) << "delay " << delays[i];
+      } else if (delays[i] > now) {
+        EXPECT_EQ(-1, fired[i]) << "delay " << delays[i];
+      }
+    }
+  }
+}
+
+TEST(TimingWheelTest, BEH_ExactWhenAdvancedEveryTick) {
+  const auto start(Clock::now());
+  TimingWheel wheel(kTick, start);
+  const size_t kTimers(1000);
+  std::vector<int64_t> delays, fired(kTimers, -1);
+  int64_t now(0);
+  for (size_t i(0); i < kTimers; ++i) {
+    delays.push_back(1 + RandomUint32() % 20000);
+    wheel.Schedule(start + delays.back() * kTick, [&fired, &now, i] { fired[i] = now; });
+  }
+  for (now = 1; now <= 20000; ++now)
+    wheel.Advance(start + now * kTick);
+  EXPECT_EQ(0U, wheel.size());
+  EXPECT_EQ(delays, fired);
+}
+
+TEST(TimingWheelTest, BEH_Cancel) {
+  const auto start(Clock::now());
+  TimingWheel wheel(kTick, start);
+  size_t fired(0);
+  const auto first(wheel.Schedule(start + 10 * kTick, [&] { ++fired; }));
+  wheel.Schedule(start + 100000 * kTick, [&] { ++fired; });
+  EXPECT_TRUE(wheel.Cancel(first));
+  EXPECT_FALSE(wheel.Cancel(first));
+  EXPECT_EQ(1U, wheel.size());
+  EXPECT_EQ(0U, wheel.Advance(start + 99999 * kTick));
+  EXPECT_EQ(1U, wheel.Advance(start + 100000 * kTick));
+  EXPECT_EQ(1U, fired);
+  EXPECT_EQ(0U, wheel.size());
+}
+
+TEST(TimingWheelTest, BEH_CallbacksMayReschedule) {
+  const auto start(Clock::now());
+  TimingWheel wheel(kTick, start);
+  size_t fired(0);
+  std::function<void()> callback;
+  callback = [&] {
+    if (++fired < 3)
+      wheel.Schedule(start, callback);  // already due, so fires on the next tick
+  };
+  wheel.Schedule(start + kTick, callback);
+  for (int64_t now(1); now <= 3; ++now)
+    wheel.Advance(start + now * kTick);
+  EXPECT_EQ(3U, fired);
+}
+
+TEST(TimingWheelTest, BEH_DriverAdvancesWheel) {
+  boost::asio::io_service io_service;
+  TimingWheel wheel(kTick);
+  size_t fired(0);
+  for (int i(0); i < 10; ++i)
+    wheel.Schedule(std::chrono::milliseconds(5 * i), [&] { ++fired; });
+  {
+    TimingWheelDriver<boost::asio::steady_timer> driver(io_service, wheel);
+    while (fired != 10)
+      io_service.run_one();
+  }
+  // The driver has stopped, so its outstanding wait completes without rescheduling.
+  io_service.run();
+  EXPECT_EQ(0U, wheel.size());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
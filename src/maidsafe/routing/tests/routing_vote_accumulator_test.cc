@@ -0,0 +1,138 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/vote_accumulator.h"
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+
+#include "maidsafe/routing/types.h"
+#include "maidsafe/routing/messages/get_data_response.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Votes = VoteAccumulator<int, int>;
+
+Address RandomAddress() { return Address(RandomString(Address::kSize)); }
+
+SerialisedMessage RandomPayload(size_t size) {
+  const auto data(RandomString(size));
+  return SerialisedMessage(std::begin(data), std::end(data));
+}
+
+}  // anonymous namespace
+
+TEST(VoteAccumulatorTest, BEH_QuorumOnAgreement) {
+  Votes votes(std::chrono::minutes(1), 3U);
+  const auto agreed(RandomPayload(100)), dissent(RandomPayload(100));
+  const Address dissenter(RandomAddress());
+
+  EXPECT_FALSE(!!votes.Add(1, agreed, 0, RandomAddress()));
+  EXPECT_FALSE(!!votes.Add(1, dissent, 1, dissenter));
+  EXPECT_FALSE(!!votes.Add(1, agreed, 2, RandomAddress()));
+  const auto agreement(votes.Add(1, agreed, 3, RandomAddress()));
+  ASSERT_TRUE(!!agreement);
+  EXPECT_EQ(agreed, *agreement->payload);
+  EXPECT_EQ(4U, agreement->votes.second.size());
+  size_t agreeing(0);
+  for (const auto& vote : agreement->votes.second) {
+    if (vote.second.payload == agreement->payload)
+      ++agreeing;
+  }
+  EXPECT_EQ(3U, agreeing);
+
+  // Later agreeing votes don't report the quorum again
+  EXPECT_FALSE(!!votes.Add(1, agreed, 4, RandomAddress()));
+
+  // The dissenting vote is still visible
+  const auto all(votes.GetAll(1));
+  ASSERT_TRUE(!!all);
+  EXPECT_EQ(5U, all->second.size());
+  EXPECT_EQ(dissent, *all->second.at(dissenter).payload);
+  EXPECT_EQ(1, all->second.at(dissenter).meta);
+}
+
+TEST(VoteAccumulatorTest, BEH_RepeatVoteIgnored) {
+  Votes votes(std::chrono::minutes(1), 2U);
+  const auto payload(RandomPayload(100));
+  const Address sender(RandomAddress());
+  EXPECT_FALSE(!!votes.Add(1, payload, 0, sender));
+  EXPECT_FALSE(!!votes.Add(1, payload, 0, sender));
+  EXPECT_EQ(1U, votes.GetAll(1)->second.size());
+  EXPECT_TRUE(!!votes.Add(1, payload, 0, RandomAddress()));
+}
+
+TEST(VoteAccumulatorTest, BEH_GroupResponseHeldOnce) {
+  // A group responding to a Get with a 1 MiB chunk, where a few members return corrupt copies.
+  const size_t kChunkSize(1024 * 1024);
+  const size_t kCorrupt(2);
+  const auto chunk(RandomString(kChunkSize));
+  const Identity name(RandomString(Address::kSize));
+  const auto response(Serialise(
+      GetDataResponse(Identity(name), SerialisedData(std::begin(chunk), std::end(chunk)))));
+  auto corrupt_chunk(chunk);
+  corrupt_chunk[0] ^= 1;
+  const auto corrupt_response(Serialise(GetDataResponse(
+      Identity(name), SerialisedData(std::begin(corrupt_chunk), std::end(corrupt_chunk)))));
+
+  Votes votes(std::chrono::minutes(1), QuorumSize);
+  Votes::Payload agreed;
+  size_t sent_bytes(0);
+  for (size_t i(0); i < QuorumSize + kCorrupt; ++i) {
+    const auto& payload(i < kCorrupt ? corrupt_response : response);
+    sent_bytes += payload.size();
+    const auto agreement(votes.Add(1, payload, static_cast<int>(i), RandomAddress()));
+    if (agreement) {
+      EXPECT_FALSE(static_cast<bool>(agreed));
+      EXPECT_EQ(QuorumSize + kCorrupt - 1, i);
+      agreed = agreement->payload;
+    }
+  }
+  ASSERT_TRUE(static_cast<bool>(agreed));
+  EXPECT_EQ(response, *agreed);
+
+  std::set<const SerialisedMessage*> held;
+  for (const auto& vote : votes.GetAll(1)->second)
+    held.insert(vote.second.payload.get());
+  size_t held_bytes(0);
+  for (const auto payload : held)
+    held_bytes += payload->size();
+  EXPECT_EQ(2U, held.size());
+  EXPECT_EQ(response.size() + corrupt_response.size(), held_bytes);
+  std::cout << QuorumSize + kCorrupt << " votes: " << sent_bytes << " payload bytes received, "
+            << held_bytes << " held\n";
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
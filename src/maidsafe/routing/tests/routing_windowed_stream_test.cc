@@ -0,0 +1,317 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/windowed_stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "asio/error.hpp"
+#include "boost/asio/io_service.hpp"
+#include "boost/asio/steady_timer.hpp"
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/reassembly_buffer.h"
+#include "maidsafe/routing/timing_wheel.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Timer = boost::asio::steady_timer;
+
+// The largest fragment RoutingNode sends, leaving room within PeerNode::MaxMessageSize.
+const uint64_t kFragmentSize(1024 * 1024 - 64 * 1024);
+
+ReassemblyBuffer::Key RandomKey() {
+  return ReassemblyBuffer::Key(Address(RandomString(Address::kSize)),
+                               Identity(RandomString(Address::kSize)));
+}
+
+SerialisedData MakePayload(uint64_t size) {
+  SerialisedData payload(size);
+  for (uint64_t i(0); i < size; ++i)
+    payload[i] = static_cast<byte>((i * 31) ^ (i >> 11));
+  return payload;
+}
+
+// A link carrying one fragment at a time at |bytes_per_second|, with |latency| each way.
+class SimulatedLink {
+ public:
+  SimulatedLink(boost::asio::io_service& io_service, double bytes_per_second,
+                Clock::duration latency)
+      : io_service_(io_service),
+        bytes_per_second_(bytes_per_second),
+        latency_(latency),
+        free_at_(Clock::now()) {}
+
+  // Calls |delivered| once |size| bytes have crossed the link, and |acknowledged| once the
+  // acknowledgement has crossed back.
+  template <typename Delivered, typename Acknowledged>
+  void Send(uint64_t size, Delivered delivered, Acknowledged acknowledged) {
+    free_at_ = std::max(free_at_, Clock::now()) +
+               std::chrono::duration_cast<Clock::duration>(
+                   std::chrono::duration<double>(size / bytes_per_second_));
+    const auto arrival(free_at_ + latency_);
+    const auto latency(latency_);
+    auto timer(std::make_shared<Timer>(io_service_));
+    timer->expires_at(arrival);
+    timer->async_wait([=](const boost::system::error_code&) {
+      delivered();
+      timer->expires_at(arrival + latency);
+      timer->async_wait([timer, acknowledged](const boost::system::error_code&) {
+        acknowledged();
+      });
+    });
+  }
+
+ private:
+  boost::asio::io_service& io_service_;
+  const double bytes_per_second_;
+  const Clock::duration latency_;
+  Clock::time_point free_at_;
+};
+
+// Streams |payload| across a simulated link into a reassembly buffer, returning how long it took.
+Clock::duration StreamAcrossLink(const SerialisedData& payload, uint32_t window,
+                                 double bytes_per_second, Clock::duration latency) {
+  boost::asio::io_service io_service;
+  SimulatedLink link(io_service, bytes_per_second, latency);
+  TimingWheel wheel;
+  ReassemblyBuffer buffer(wheel, payload.size());
+  const auto key(RandomKey());
+  const auto count(FragmentCount(payload.size(), kFragmentSize));
+  boost::optional<SerialisedData> received;
+  bool done(false);
+  Clock::time_point finished;
+  const auto start(Clock::now());
+  io_service.post([&] {
+    WindowedStream::Start(
+        count, window, 0,
+        [&](uint32_t index, WindowedStream::Acknowledge acknowledge) {
+          auto fragment(std::make_shared<SerialisedData>(CopyFragment(payload, count, index)));
+          link.Send(fragment->size(),
+                    [&, fragment, index] {
+                      auto whole(buffer.Add(key, index, count, payload.size(), *fragment));
+                      if (whole)
+                        received = std::move(whole);
+                    },
+                    [acknowledge] { acknowledge(asio::error_code()); });
+        },
+        [&](asio::error_code error) {
+          EXPECT_FALSE(error);
+          done = true;
+          finished = Clock::now();
+        });
+  });
+  io_service.run();
+  EXPECT_TRUE(done);
+  EXPECT_TRUE(received && *received == payload);
+  EXPECT_EQ(0U, buffer.Reserved());
+  return finished - start;
+}
+
+}  // anonymous namespace
+
+TEST(WindowedStreamTest, BEH_KeepsWindowFullAndRetries) {
+  const uint32_t count(10), window(3);
+  std::vector<std::pair<uint32_t, WindowedStream::Acknowledge>> outstanding;
+  std::vector<uint32_t> sent;
+  size_t most_outstanding(0);
+  int done_calls(0);
+  asio::error_code result(make_error_code(CommonErrors::unknown));
+  auto stream(WindowedStream::Start(
+      count, window, 1,
+      [&](uint32_t index, WindowedStream::Acknowledge acknowledge) {
+        sent.push_back(index);
+        outstanding.emplace_back(index, std::move(acknowledge));
+        most_outstanding = std::max(most_outstanding, outstanding.size());
+      },
+      [&](asio::error_code error) {
+        ++done_calls;
+        result = error;
+      }));
+  ASSERT_EQ(window, outstanding.size());
+
+  // Failing fragment 1 sends it again in place of the next new fragment.
+  auto failed(outstanding[1]);
+  outstanding.erase(std::begin(outstanding) + 1);
+  failed.second(make_error_code(CommonErrors::unknown));
+  ASSERT_EQ(window, outstanding.size());
+  EXPECT_EQ(1U, outstanding.back().first);
+
+  while (!outstanding.empty()) {
+    auto next(outstanding.front());
+    outstanding.erase(std::begin(outstanding));
+    next.second(asio::error_code());
+  }
+  EXPECT_EQ(window, most_outstanding);
+  EXPECT_EQ(count + 1, sent.size());
+  EXPECT_EQ(count, stream->Acknowledged());
+  EXPECT_EQ(1, done_calls);
+  EXPECT_FALSE(result);
+  for (uint32_t index(0); index != count; ++index)
+    EXPECT_NE(std::end(sent), std::find(std::begin(sent), std::end(sent), index));
+}
+
+TEST(WindowedStreamTest, BEH_FailsAfterMaxRetries) {
+  // Acknowledged synchronously, from within the send.
+  std::vector<uint32_t> sent;
+  int done_calls(0);
+  asio::error_code result;
+  WindowedStream::Start(
+      8, 2, 2,
+      [&](uint32_t index, WindowedStream::Acknowledge acknowledge) {
+        sent.push_back(index);
+        acknowledge(index == 4 ? make_error_code(CommonErrors::unknown) : asio::error_code());
+      },
+      [&](asio::error_code error) {
+        ++done_calls;
+        result = error;
+      });
+  EXPECT_EQ(1, done_calls);
+  EXPECT_EQ(make_error_code(CommonErrors::unknown), result);
+  EXPECT_EQ(3, std::count(std::begin(sent), std::end(sent), 4U));
+  EXPECT_EQ(4U, sent.back());
+
+  done_calls = 0;
+  WindowedStream::Start(0, 2, 0, [](uint32_t, WindowedStream::Acknowledge) { FAIL(); },
+                        [&](asio::error_code error) {
+                          ++done_calls;
+                          EXPECT_FALSE(error);
+                        });
+  EXPECT_EQ(1, done_calls);
+  EXPECT_THROW(WindowedStream::Start(1, 0, 0, [](uint32_t, WindowedStream::Acknowledge) {},
+                                     [](asio::error_code) {}),
+               maidsafe_error);
+}
+
+TEST(WindowedStreamTest, BEH_FailsAtOnceWhenRetryIsPointless) {
+  const asio::error_code kErrors[] = {asio::error::shut_down, asio::error::operation_aborted,
+                                      asio::error::network_unreachable};
+  for (const auto& failure : kErrors) {
+    std::vector<uint32_t> sent;
+    int done_calls(0);
+    asio::error_code result;
+    WindowedStream::Start(
+        8, 2, 2,
+        [&](uint32_t index, WindowedStream::Acknowledge acknowledge) {
+          sent.push_back(index);
+          acknowledge(index == 4 ? failure : asio::error_code());
+        },
+        [&](asio::error_code error) {
+          ++done_calls;
+          result = error;
+        });
+    EXPECT_EQ(1, done_calls);
+    EXPECT_EQ(failure, result);
+    EXPECT_EQ(1, std::count(std::begin(sent), std::end(sent), 4U));
+    EXPECT_EQ(4U, sent.back());
+  }
+}
+
+TEST(WindowedStreamTest, BEH_ReassemblesOutOfOrder) {
+  TimingWheel wheel;
+  ReassemblyBuffer buffer(wheel, 1000);
+  const auto key(RandomKey());
+  const auto payload(MakePayload(1000));
+  const auto count(FragmentCount(payload.size(), 300));
+  ASSERT_EQ(4U, count);
+
+  for (const uint32_t index : {3U, 1U, 1U, 0U}) {
+    EXPECT_FALSE(
+        buffer.Add(key, index, count, payload.size(), CopyFragment(payload, count, index)));
+  }
+  EXPECT_EQ(1U, buffer.size());
+  EXPECT_EQ(1000U, buffer.Reserved());
+  const auto whole(buffer.Add(key, 2, count, payload.size(), CopyFragment(payload, count, 2)));
+  ASSERT_TRUE(whole);
+  EXPECT_TRUE(*whole == payload);
+  EXPECT_EQ(0U, buffer.size());
+  EXPECT_EQ(0U, buffer.Reserved());
+
+  // An empty payload is a single empty fragment.
+  ASSERT_EQ(1U, FragmentCount(0, 300));
+  const auto empty(buffer.Add(RandomKey(), 0, 1, 0, SerialisedData()));
+  ASSERT_TRUE(empty);
+  EXPECT_TRUE(empty->empty());
+}
+
+TEST(WindowedStreamTest, BEH_ReassemblyIsBounded) {
+  TimingWheel wheel;
+  ReassemblyBuffer buffer(wheel, 1500, std::chrono::seconds(1));
+  const auto payload(MakePayload(1000));
+  const auto count(FragmentCount(payload.size(), 300));
+  const auto first(RandomKey()), second(RandomKey());
+
+  // Fragments which don't fit the layout are rejected.
+  EXPECT_THROW(buffer.Add(first, 0, count, payload.size(), SerialisedData(299)), maidsafe_error);
+  EXPECT_THROW(buffer.Add(first, count, count, payload.size(), SerialisedData(100)),
+               maidsafe_error);
+  EXPECT_FALSE(buffer.Add(first, 0, count, payload.size(), CopyFragment(payload, count, 0)));
+  EXPECT_THROW(buffer.Add(first, 1, count, payload.size() + 1, CopyFragment(payload, count, 1)),
+               maidsafe_error);
+
+  // A second payload would take the buffer over capacity until the first is dropped.
+  EXPECT_THROW(buffer.Add(second, 0, count, payload.size(), CopyFragment(payload, count, 0)),
+               maidsafe_error);
+  buffer.Remove(first);
+  EXPECT_EQ(0U, buffer.Reserved());
+  EXPECT_FALSE(buffer.Add(second, 0, count, payload.size(), CopyFragment(payload, count, 0)));
+
+  // Partial payloads expire.
+  wheel.Advance(Clock::now() + std::chrono::seconds(2));
+  EXPECT_EQ(0U, buffer.size());
+  EXPECT_EQ(0U, buffer.Reserved());
+  EXPECT_EQ(1U, buffer.Expired());
+}
+
+TEST(WindowedStreamTest, FUNC_WindowReachesLinkCapacity) {
+  const auto payload(MakePayload(100 * 1024 * 1024));
+  const double bytes_per_second(200.0 * 1024 * 1024);
+  const auto latency(std::chrono::milliseconds(5));
+  const std::chrono::duration<double> ideal(payload.size() / bytes_per_second);
+
+  const auto windowed(StreamAcrossLink(payload, WindowedStream::kDefaultWindow, bytes_per_second,
+                                       latency));
+  const auto serial(StreamAcrossLink(payload, 1, bytes_per_second, latency));
+  const auto utilisation(ideal / windowed), serial_utilisation(ideal / serial);
+  GTEST_LOG_(INFO) << "100 MiB used " << utilisation * 100 << "% of link capacity with the "
+                   << "default window and " << serial_utilisation * 100 << "% one fragment at a "
+                   << "time.";
+  EXPECT_GE(utilisation, 0.8);
+  // One fragment at a time leaves the link idle for a round trip per fragment.
+  EXPECT_LT(serial_utilisation, 0.5);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,141 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/timing_wheel.h"
+
+#include <algorithm>
+
+namespace maidsafe {
+
+namespace routing {
+
+const size_t TimingWheel::kSlots;
+const size_t TimingWheel::kLevels;
+const TimingWheel::Clock::duration TimingWheel::kDefaultTick = std::chrono::seconds(1);
+
+namespace {
+
+const unsigned kSlotBits = 6;
+static_assert((1U << kSlotBits) == TimingWheel::kSlots, "kSlots must be 2^kSlotBits");
+const uint64_t kSlotMask = TimingWheel::kSlots - 1;
+
+// Number of ticks covered by wheels 0 to |level| inclusive.
+uint64_t Span(size_t level) { return uint64_t(1) << (kSlotBits * (level + 1)); }
+
+size_t SlotIndex(uint64_t tick, size_t level) {
+  return static_cast<size_t>((tick >> (kSlotBits * level)) & kSlotMask);
+}
+
+}  // unnamed namespace
+
+TimingWheel::TimingWheel(Clock::duration tick, Clock::time_point start)
+    : tick_(std::max(tick, Clock::duration(1))),
+      start_(start),
+      mutex_(),
+      current_(0),
+      next_timer_(0),
+      timers_(),
+      wheels_() {}
+
+TimingWheel::TimerId TimingWheel::Schedule(Clock::time_point expiry, Callback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto id(++next_timer_);
+  const auto due(std::max(ToTick(expiry), current_ + 1));
+  timers_.insert(std::make_pair(id, Timer{due, std::move(callback)}));
+  Place(id, due);
+  return id;
+}
+
+bool TimingWheel::Cancel(TimerId timer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return timers_.erase(timer) == 1;
+}
+
+size_t TimingWheel::Advance(Clock::time_point now) {
+  std::vector<Callback> due;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto target(now < start_ ? 0 : static_cast<uint64_t>((now - start_) / tick_));
+    if (timers_.empty()) {
+      // Nothing to fire, but the slots may still hold ids of cancelled timers.
+      if (target > current_) {
+        for (auto& wheel : wheels_) {
+          for (auto& slot : wheel)
+            Slot().swap(slot);
+        }
+        current_ = target;
+      }
+      return 0;
+    }
+    while (current_ < target) {
+      ++current_;
+      for (size_t level(1); level < kLevels && (current_ & (Span(level - 1) - 1)) == 0; ++level)
+        Cascade(level);
+      Slot slot;
+      slot.swap(wheels_[0][SlotIndex(current_, 0)]);
+      for (const auto id : slot) {
+        const auto timer(timers_.find(id));
+        if (timer == std::end(timers_))
+          continue;  // cancelled
+        due.push_back(std::move(timer->second.callback));
+        timers_.erase(timer);
+      }
+    }
+  }
+  for (auto& callback : due)
+    callback();
+  return due.size();
+}
+
+size_t TimingWheel::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return timers_.size();
+}
+
+uint64_t TimingWheel::ToTick(Clock::time_point time) const {
+  if (time <= start_)
+    return 0;
+  // Round up, so a timer never fires early.
+  return static_cast<uint64_t>((time - start_ + tick_ - Clock::duration(1)) / tick_);
+}
+
+void TimingWheel::Place(TimerId timer, uint64_t due) {
+  const auto delta(due - current_);
+  for (size_t level(0); level < kLevels; ++level) {
+    if (delta < Span(level)) {
+      wheels_[level][SlotIndex(due, level)].push_back(timer);
+      return;
+    }
+  }
+  // Beyond the outermost wheel: park in the slot cascaded last, and re-place from there.
+  wheels_[kLevels - 1][SlotIndex(current_ - 1, kLevels - 1)].push_back(timer);
+}
+
+void TimingWheel::Cascade(size_t level) {
+  Slot slot;
+  slot.swap(wheels_[level][SlotIndex(current_, level)]);
+  for (const auto id : slot) {
+    const auto timer(timers_.find(id));
+    if (timer != std::end(timers_))
+      Place(id, timer->second.due);
+  }
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
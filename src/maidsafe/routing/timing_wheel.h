@@ -0,0 +1,166 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_TIMING_WHEEL_H_
+#define MAIDSAFE_ROUTING_TIMING_WHEEL_H_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace maidsafe {
+
+namespace routing {
+
+// Hierarchical timing wheel for expiring cache and accumulator entries.  Time is quantised into
+// ticks; kLevels wheels of kSlots slots each cover kSlots^kLevels ticks, and a timer due further
+// out than that waits in the outermost wheel until it comes into range.  Scheduling and
+// cancelling are O(1), and each timer is moved between wheels at most kLevels times before it
+// fires, so expiry is O(1) amortised per timer.
+//
+// The wheel doesn't keep time itself: Advance must be called periodically (see
+// TimingWheelDriver).  Callbacks are invoked by Advance, on the calling thread and without the
+// wheel's lock held, so they may schedule or cancel timers.  Owners of expiring entries should
+// drive the wheel from the thread (or strand) which otherwise accesses those entries.
+class TimingWheel {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TimerId = uint64_t;
+  using Callback = std::function<void()>;
+
+  static const size_t kSlots = 64;
+  static const size_t kLevels = 4;
+  static const Clock::duration kDefaultTick;
+
+  explicit TimingWheel(Clock::duration tick = kDefaultTick, Clock::time_point start = Clock::now());
+  TimingWheel(const TimingWheel&) = delete;
+  TimingWheel(TimingWheel&&) = delete;
+  ~TimingWheel() = default;
+  TimingWheel& operator=(const TimingWheel&) = delete;
+  TimingWheel& operator=(TimingWheel&&) = delete;
+
+  // The callback is invoked by the first call to Advance at or after |expiry|, rounded up to a
+  // whole tick.
+  TimerId Schedule(Clock::time_point expiry, Callback callback);
+  TimerId Schedule(Clock::duration delay, Callback callback) {
+    return Schedule(Clock::now() + delay, std::move(callback));
+  }
+  // Returns false if the timer has already fired or been cancelled.
+  bool Cancel(TimerId timer);
+  // Fires every timer due by |now|.  Returns the number fired.
+  size_t Advance(Clock::time_point now = Clock::now());
+
+  Clock::duration Tick() const { return tick_; }
+  size_t size() const;
+
+ private:
+  struct Timer {
+    uint64_t due;  // in ticks since start_
+    Callback callback;
+  };
+  using Slot = std::vector<TimerId>;
+
+  uint64_t ToTick(Clock::time_point time) const;
+  void Place(TimerId timer, uint64_t due);
+  void Cascade(size_t level);
+
+  const Clock::duration tick_;
+  const Clock::time_point start_;
+  mutable std::mutex mutex_;
+  uint64_t current_;  // last tick processed
+  TimerId next_timer_;
+  // Cancelled timers are removed from here; their ids are dropped from the slots when reached.
+  std::unordered_map<TimerId, Timer> timers_;
+  std::array<std::array<Slot, kSlots>, kLevels> wheels_;
+};
+
+// Advances a TimingWheel every tick from an asio steady_timer.  Templated on the timer type so
+// that either standalone or Boost asio services can drive it, e.g.
+// TimingWheelDriver<asio::steady_timer> driver(io_service, wheel);
+// The wheel's callbacks run on |io_service|'s threads.  Stop (or destroy) the driver before the
+// wheel.
+template <typename SteadyTimer>
+class TimingWheelDriver {
+ public:
+  template <typename IoService>
+  TimingWheelDriver(IoService& io_service, TimingWheel& wheel)
+      : state_(std::make_shared<State>(io_service, wheel)) {
+    Wait(state_);
+  }
+
+  TimingWheelDriver(const TimingWheelDriver&) = delete;
+  TimingWheelDriver(TimingWheelDriver&&) = delete;
+  ~TimingWheelDriver() { Stop(); }
+  TimingWheelDriver& operator=(const TimingWheelDriver&) = delete;
+  TimingWheelDriver& operator=(TimingWheelDriver&&) = delete;
+
+  void Stop() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stopped = true;
+    state_->timer.cancel();
+  }
+
+ private:
+  struct State {
+    template <typename IoService>
+    State(IoService& io_service, TimingWheel& wheel_in)
+        : mutex(), stopped(false), wheel(wheel_in), timer(io_service) {}
+
+    std::mutex mutex;
+    bool stopped;
+    TimingWheel& wheel;
+    SteadyTimer timer;
+  };
+
+  // The pending wait holds the state, so a handler running after the driver is gone is harmless.
+  struct OnTick {
+    template <typename ErrorCode>
+    void operator()(const ErrorCode& error) const {
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (error || state->stopped)
+          return;
+      }
+      state->wheel.Advance();
+      Wait(state);
+    }
+    std::shared_ptr<State> state;
+  };
+
+  static void Wait(const std::shared_ptr<State>& state) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->stopped)
+      return;
+    state->timer.expires_from_now(state->wheel.Tick());
+    state->timer.async_wait(OnTick{state});
+  }
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_TIMING_WHEEL_H_
@@ -0,0 +1,130 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_VOTE_ACCUMULATOR_H_
+#define MAIDSAFE_ROUTING_VOTE_ACCUMULATOR_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "boost/optional/optional.hpp"
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/node_id.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/routing/accumulator.h"
+#include "maidsafe/routing/hash.h"
+#include "maidsafe/routing/timing_wheel.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Accumulates group members' copies of a message as votes for its content.  Each distinct payload
+// (by SHA-512) is held once per name and shared by every sender who sent it, alongside the per
+// sender |MetaType| (e.g. source address and signature), so a group response of up to GroupSize
+// large identical payloads costs one payload rather than one per sender.  A quorum is reached
+// once |quorum| senders agree on one payload.  Votes for other payloads are kept too, so GetAll
+// still shows which senders dissented.  Expiry and capacity are as for Accumulator.
+template <typename NameType, typename MetaType, typename Hash = detail::Hasher<NameType>>
+class VoteAccumulator {
+ public:
+  using Payload = std::shared_ptr<const SerialisedMessage>;
+  struct Vote {
+    std::string digest;
+    Payload payload;
+    MetaType meta;
+  };
+  using Map = typename Accumulator<NameType, Vote, Hash>::Map;
+  using View = typename Accumulator<NameType, Vote, Hash>::View;
+  // |votes| are all the votes for the name; those agreeing have |payload| (the same pointer, as
+  // equal payloads are shared).  The view is invalidated by the next Add.
+  struct Agreement {
+    Payload payload;
+    View votes;
+  };
+
+  VoteAccumulator(std::chrono::steady_clock::duration time_to_live, uint32_t quorum)
+      : quorum_(quorum), accumulator_(time_to_live, 1U) {}
+  VoteAccumulator(std::chrono::steady_clock::duration time_to_live, uint32_t quorum,
+                  size_t capacity, TimingWheel* expiry_wheel)
+      : quorum_(quorum), accumulator_(time_to_live, 1U, capacity, expiry_wheel) {}
+
+  VoteAccumulator(const VoteAccumulator&) = delete;
+  VoteAccumulator(VoteAccumulator&&) = delete;
+  ~VoteAccumulator() = default;
+  VoteAccumulator& operator=(const VoteAccumulator&) = delete;
+  VoteAccumulator& operator=(VoteAccumulator&&) = delete;
+
+  // Hashed in place, as payloads may be large.
+  static std::string Digest(const SerialisedMessage& payload) {
+    std::string digest(crypto::SHA512::DIGESTSIZE, 0);
+    crypto::SHA512().CalculateDigest(reinterpret_cast<byte*>(&digest[0]), payload.data(),
+                                     payload.size());
+    return digest;
+  }
+
+  bool HaveName(const NameType& name) const { return accumulator_.HaveName(name); }
+
+  // Returns the agreement to the call whose vote makes |quorum| senders agree on one payload, and
+  // nothing otherwise (including for later agreeing votes).  A repeat vote from a sender is
+  // ignored.
+  boost::optional<Agreement> Add(const NameType& name, SerialisedMessage payload, MetaType meta,
+                                 NodeId sender) {
+    auto digest(Digest(payload));
+    Payload shared;
+    uint32_t agreeing(1);
+    const auto existing(accumulator_.GetAll(name));
+    if (existing) {
+      if (existing->second.count(sender) != 0)
+        return boost::none;
+      for (const auto& vote : existing->second) {
+        if (vote.second.digest == digest) {
+          shared = vote.second.payload;
+          ++agreeing;
+        }
+      }
+    }
+    if (!shared)
+      shared = std::make_shared<const SerialisedMessage>(std::move(payload));
+    auto votes(accumulator_.Add(name, Vote{std::move(digest), shared, std::move(meta)},
+                                std::move(sender)));
+    if (!votes || agreeing != quorum_)
+      return boost::none;
+    return Agreement{std::move(shared), *votes};
+  }
+
+  // All votes for |name|, agreeing or not, to find senders of bad data.
+  boost::optional<View> GetAll(const NameType& name) const { return accumulator_.GetAll(name); }
+
+  size_t size() const { return accumulator_.size(); }
+
+ private:
+  const uint32_t quorum_;
+  Accumulator<NameType, Vote, Hash> accumulator_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_VOTE_ACCUMULATOR_H_
@@ -0,0 +1,139 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/windowed_stream.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "asio/error.hpp"
+
+#include "maidsafe/common/error.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+// We're shutting down, or have no peer to send through, so sending again would fail the same way.
+bool RetryPointless(const asio::error_code& error) {
+  return error == asio::error::shut_down || error == asio::error::operation_aborted ||
+         error == asio::error::network_unreachable;
+}
+
+}  // unnamed namespace
+
+const uint32_t WindowedStream::kDefaultWindow;
+const uint32_t WindowedStream::kDefaultMaxRetries;
+
+std::shared_ptr<WindowedStream> WindowedStream::Start(uint32_t count, uint32_t window,
+                                                      uint32_t max_retries, Send send,
+                                                      Done done) {
+  if (window == 0 || !send || !done)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  std::shared_ptr<WindowedStream> stream(
+      new WindowedStream(count, window, max_retries, std::move(send), std::move(done)));
+  if (count == 0) {
+    stream->finished_ = true;
+    Done on_done(std::move(stream->done_));
+    on_done(asio::error_code());
+    return stream;
+  }
+  stream->Pump();
+  return stream;
+}
+
+WindowedStream::WindowedStream(uint32_t count, uint32_t window, uint32_t max_retries, Send send,
+                               Done done)
+    : count_(count),
+      window_(window),
+      max_retries_(max_retries),
+      send_(std::move(send)),
+      done_(std::move(done)),
+      mutex_(),
+      next_(0),
+      in_flight_(0),
+      acknowledged_(0),
+      retries_(count, 0),
+      to_resend_(),
+      finished_(false),
+      pumping_(false),
+      pump_again_(false) {}
+
+uint32_t WindowedStream::Acknowledged() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return acknowledged_;
+}
+
+void WindowedStream::Pump() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // A synchronous acknowledgement re-enters here from within send_; rather than recursing once
+  // per fragment, it leaves the outer call to fill the window again.
+  if (pumping_) {
+    pump_again_ = true;
+    return;
+  }
+  pumping_ = true;
+  do {
+    pump_again_ = false;
+    while (!finished_ && in_flight_ < window_ && (!to_resend_.empty() || next_ < count_)) {
+      uint32_t index(next_);
+      if (to_resend_.empty()) {
+        ++next_;
+      } else {
+        index = to_resend_.front();
+        to_resend_.pop_front();
+      }
+      ++in_flight_;
+      lock.unlock();
+      auto self(shared_from_this());
+      send_(index, [self, index](asio::error_code error) { self->OnAcknowledge(index, error); });
+      lock.lock();
+    }
+  } while (pump_again_);
+  pumping_ = false;
+}
+
+void WindowedStream::OnAcknowledge(uint32_t index, asio::error_code error) {
+  Done done;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (finished_)
+      return;
+    --in_flight_;
+    if (!error) {
+      if (++acknowledged_ == count_) {
+        finished_ = true;
+        done = std::move(done_);
+      }
+    } else if (!RetryPointless(error) && retries_[index]++ < max_retries_) {
+      to_resend_.push_back(index);
+    } else {
+      finished_ = true;
+      done = std::move(done_);
+    }
+  }
+  if (done)
+    return done(error);
+  Pump();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
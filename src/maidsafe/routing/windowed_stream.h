@@ -0,0 +1,82 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_WINDOWED_STREAM_H_
+#define MAIDSAFE_ROUTING_WINDOWED_STREAM_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "asio/error_code.hpp"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Sends the |count| fragments of a stream with up to |window| of them awaiting acknowledgement at
+// once, so the link is kept busy rather than idling for a round trip per fragment.  A fragment
+// whose acknowledgement carries an error is sent again, up to |max_retries| times, before the
+// whole stream is failed; shut_down, operation_aborted and network_unreachable fail it at once, as
+// resending can't succeed.  |send| is never called with the stream's lock held, so it may
+// acknowledge synchronously; each call's acknowledgement must be invoked exactly once.  |done| is
+// called once, when every fragment has been acknowledged or the stream has failed.
+class WindowedStream : public std::enable_shared_from_this<WindowedStream> {
+ public:
+  using Acknowledge = std::function<void(asio::error_code)>;
+  using Send = std::function<void(uint32_t index, Acknowledge acknowledge)>;
+  using Done = std::function<void(asio::error_code)>;
+
+  static const uint32_t kDefaultWindow = 16;
+  static const uint32_t kDefaultMaxRetries = 2;
+
+  static std::shared_ptr<WindowedStream> Start(uint32_t count, uint32_t window,
+                                               uint32_t max_retries, Send send, Done done);
+
+  WindowedStream(const WindowedStream&) = delete;
+  WindowedStream(WindowedStream&&) = delete;
+  ~WindowedStream() = default;
+  WindowedStream& operator=(const WindowedStream&) = delete;
+  WindowedStream& operator=(WindowedStream&&) = delete;
+
+  uint32_t Acknowledged() const;
+
+ private:
+  WindowedStream(uint32_t count, uint32_t window, uint32_t max_retries, Send send, Done done);
+
+  void Pump();
+  void OnAcknowledge(uint32_t index, asio::error_code error);
+
+  const uint32_t count_, window_, max_retries_;
+  const Send send_;
+  Done done_;
+  mutable std::mutex mutex_;
+  uint32_t next_, in_flight_, acknowledged_;
+  std::vector<uint32_t> retries_;
+  std::deque<uint32_t> to_resend_;
+  bool finished_, pumping_, pump_again_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_WINDOWED_STREAM_H_